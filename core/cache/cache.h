@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/conversion/conversion.h"
+#include "torch/csrc/jit/ir/ir.h"
+
+namespace trtorch {
+namespace core {
+namespace cache {
+
+struct CacheInfo {
+  // Reuse serialized engines from disk instead of rebuilding them
+  bool enabled = false;
+  // Directory holding the cached engines, created if it does not exist
+  std::string cache_dir;
+  // Maximum total size of the cached engines, least recently used entries are
+  // evicted once it is exceeded (0 means unbounded)
+  uint64_t max_size_bytes = 0;
+  // Version of the library requesting the build, provided by the API layer
+  // so that engines built by different TRTorch releases never collide
+  std::string trtorch_version;
+};
+
+std::ostream& operator<<(std::ostream& os, const CacheInfo& s);
+
+struct EngineCacheKey {
+  // Structural hash of the lowered graph and its static parameters
+  uint64_t graph_hash = 0;
+  // Hash of the builder settings and input ranges
+  uint64_t settings_hash = 0;
+  // Hash of the TensorRT, CUDA, LibTorch and TRTorch versions and the target
+  // GPU architecture
+  uint64_t version_hash = 0;
+
+  std::string str() const;
+  bool operator==(const EngineCacheKey& other) const {
+    return graph_hash == other.graph_hash && settings_hash == other.settings_hash &&
+        version_hash == other.version_hash;
+  }
+};
+
+// Hashes the structure of a block independently of value names: node kinds,
+// attributes (including the contents of tensor constants), types and how
+// values are wired together, along with the contents of the static parameters
+uint64_t HashGraph(const torch::jit::Block* b, const conversion::GraphParams& static_params);
+uint64_t HashSettings(const conversion::ConversionInfo& info);
+uint64_t HashVersions(const std::string& trtorch_version, int64_t gpu_id);
+
+EngineCacheKey MakeEngineCacheKey(
+    const torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const conversion::ConversionInfo& info,
+    const std::string& trtorch_version);
+
+class EngineCache {
+ public:
+  EngineCache(std::string cache_dir, uint64_t max_size_bytes = 0);
+
+  // Returns true and fills serialized_engine if there is a valid entry for
+  // the key. Entries are validated against the key stored in their header
+  // before their payload is read
+  bool Load(const EngineCacheKey& key, std::string& serialized_engine);
+
+  // Writes the entry to a temporary file and renames it into place so
+  // concurrent readers (or other processes) never observe a partial entry,
+  // then evicts entries until the cache fits its size limit
+  void Store(const EngineCacheKey& key, const std::string& serialized_engine);
+
+  // Removes least recently used entries until the total size is under
+  // max_size_bytes
+  void Evict();
+
+  // Total size in bytes of all entries currently in the cache
+  uint64_t Size();
+
+ private:
+  std::string PathFor(const EngineCacheKey& key);
+  // Evicts like Evict but never removes the entry at keep_path
+  void Evict(const std::string& keep_path);
+  std::string cache_dir_;
+  uint64_t max_size_bytes_;
+};
+
+} // namespace cache
+} // namespace core
+} // namespace trtorch
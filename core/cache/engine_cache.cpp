@@ -0,0 +1,246 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "core/cache/cache.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace cache {
+namespace {
+
+const char kEntryExtension[] = ".engine";
+const uint64_t kEntryMagic = 0x5452544f52434845ULL; // "TRTORCHE"
+const uint64_t kEntryFormatVersion = 1;
+
+// Fixed size header written in front of every serialized engine. The key is
+// repeated in the header so that a truncated or renamed file is never
+// mistaken for a valid entry
+struct EntryHeader {
+  uint64_t magic;
+  uint64_t format_version;
+  uint64_t graph_hash;
+  uint64_t settings_hash;
+  uint64_t version_hash;
+  uint64_t payload_size;
+};
+
+struct EntryStat {
+  std::string path;
+  uint64_t size;
+  // Nanoseconds since the epoch, entries are often stored or loaded within
+  // the same second
+  int64_t last_use;
+};
+
+bool EndsWith(const std::string& s, const std::string& suffix) {
+  return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void MakeDirs(const std::string& path) {
+  std::string partial;
+  std::stringstream ss(path);
+  std::string dir;
+  if (!path.empty() && path[0] == '/') {
+    partial = "/";
+  }
+  while (std::getline(ss, dir, '/')) {
+    if (dir.empty()) {
+      continue;
+    }
+    partial += dir + "/";
+    if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST) {
+      TRTORCH_THROW_ERROR("Unable to create engine cache directory " << partial << ": " << strerror(errno));
+    }
+  }
+}
+
+std::vector<EntryStat> ListEntries(const std::string& cache_dir) {
+  std::vector<EntryStat> entries;
+  auto dir = opendir(cache_dir.c_str());
+  if (dir == nullptr) {
+    return entries;
+  }
+  while (auto ent = readdir(dir)) {
+    std::string name(ent->d_name);
+    if (!EndsWith(name, kEntryExtension)) {
+      continue;
+    }
+    auto path = cache_dir + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      auto last_use = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+      entries.push_back({path, static_cast<uint64_t>(st.st_size), last_use});
+    }
+  }
+  closedir(dir);
+  return entries;
+}
+
+} // namespace
+
+std::ostream& operator<<(std::ostream& os, const CacheInfo& s) {
+  os << "Engine Cache:"
+     << "\n    Enabled: " << s.enabled;
+  if (s.enabled) {
+    os << "\n    Cache Directory: " << s.cache_dir;
+    if (s.max_size_bytes != 0) {
+      os << "\n    Max Size (bytes): " << s.max_size_bytes;
+    } else {
+      os << "\n    Max Size (bytes): Unbounded";
+    }
+  }
+  return os;
+}
+
+std::string EngineCacheKey::str() const {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << graph_hash << '_' << std::setw(16) << settings_hash << '_'
+     << std::setw(16) << version_hash;
+  return ss.str();
+}
+
+EngineCache::EngineCache(std::string cache_dir, uint64_t max_size_bytes)
+    : cache_dir_(std::move(cache_dir)), max_size_bytes_(max_size_bytes) {
+  TRTORCH_CHECK(!cache_dir_.empty(), "A cache directory must be provided to use the engine cache");
+  MakeDirs(cache_dir_);
+}
+
+std::string EngineCache::PathFor(const EngineCacheKey& key) {
+  return cache_dir_ + "/" + key.str() + kEntryExtension;
+}
+
+bool EngineCache::Load(const EngineCacheKey& key, std::string& serialized_engine) {
+  auto path = PathFor(key);
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    LOG_DEBUG("Engine cache miss for " << key.str());
+    return false;
+  }
+
+  auto size = static_cast<uint64_t>(in.tellg());
+  EntryHeader header;
+  in.seekg(0);
+  if (size < sizeof(EntryHeader) || !in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    LOG_WARNING("Ignoring malformed engine cache entry " << path);
+    return false;
+  }
+  if (header.magic != kEntryMagic || header.format_version != kEntryFormatVersion ||
+      header.graph_hash != key.graph_hash || header.settings_hash != key.settings_hash ||
+      header.version_hash != key.version_hash || header.payload_size != size - sizeof(EntryHeader)) {
+    LOG_WARNING("Ignoring engine cache entry " << path << " whose header does not match its key");
+    return false;
+  }
+
+  // The engine ends up held as a string by the TRTEngine (which serializes
+  // it with the module), so the payload is read straight into one
+  serialized_engine.resize(header.payload_size);
+  if (!in.read(&serialized_engine[0], header.payload_size)) {
+    LOG_WARNING("Failed reading engine cache entry " << path);
+    serialized_engine.clear();
+    return false;
+  }
+
+  // mtime tracks last use for LRU eviction
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  LOG_DEBUG("Engine cache hit for " << key.str());
+  return true;
+}
+
+void EngineCache::Store(const EngineCacheKey& key, const std::string& serialized_engine) {
+  auto path = PathFor(key);
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << '.' << std::this_thread::get_id();
+
+  EntryHeader header;
+  header.magic = kEntryMagic;
+  header.format_version = kEntryFormatVersion;
+  header.graph_hash = key.graph_hash;
+  header.settings_hash = key.settings_hash;
+  header.version_hash = key.version_hash;
+  header.payload_size = serialized_engine.size();
+
+  {
+    std::ofstream out(tmp_path.str(), std::ios::binary | std::ios::trunc);
+    if (!out) {
+      LOG_WARNING("Unable to write engine cache entry " << tmp_path.str());
+      return;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(serialized_engine.data(), serialized_engine.size());
+    out.close();
+    if (!out) {
+      LOG_WARNING("Failed writing engine cache entry " << tmp_path.str());
+      unlink(tmp_path.str().c_str());
+      return;
+    }
+  }
+
+  if (rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG_WARNING("Unable to move engine cache entry into place at " << path << ": " << strerror(errno));
+    unlink(tmp_path.str().c_str());
+    return;
+  }
+  LOG_DEBUG("Stored engine cache entry " << path << " (" << serialized_engine.size() << " bytes)");
+
+  // The entry was just used, whatever else is in the cache goes first
+  Evict(path);
+}
+
+void EngineCache::Evict() {
+  Evict("");
+}
+
+void EngineCache::Evict(const std::string& keep_path) {
+  if (max_size_bytes_ == 0) {
+    return;
+  }
+
+  auto entries = ListEntries(cache_dir_);
+  uint64_t total = 0;
+  for (auto& e : entries) {
+    total += e.size;
+  }
+
+  // Oldest first, path breaks ties so the order is deterministic
+  std::sort(entries.begin(), entries.end(), [](const EntryStat& a, const EntryStat& b) {
+    return a.last_use != b.last_use ? a.last_use < b.last_use : a.path < b.path;
+  });
+
+  for (auto& e : entries) {
+    if (total <= max_size_bytes_) {
+      break;
+    }
+    if (e.path == keep_path) {
+      continue;
+    }
+    if (unlink(e.path.c_str()) == 0) {
+      LOG_DEBUG("Evicted engine cache entry " << e.path);
+      total -= e.size;
+    }
+  }
+}
+
+uint64_t EngineCache::Size() {
+  uint64_t total = 0;
+  for (auto& e : ListEntries(cache_dir_)) {
+    total += e.size;
+  }
+  return total;
+}
+
+} // namespace cache
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+#include <cuda_runtime.h>
+
+#include "core/cache/cache.h"
+#include "core/util/build_info.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace cache {
+namespace {
+
+using namespace torch::jit;
+
+// 64 bit FNV-1a, stable across processes and platforms unlike std::hash
+struct Hasher {
+  static constexpr uint64_t kOffsetBasis = 14695981039346656037ULL;
+  static constexpr uint64_t kPrime = 1099511628211ULL;
+  // Size of the host buffer tensors that are not contiguous on the CPU are
+  // copied through
+  static constexpr int64_t kChunkBytes = 16 << 20;
+
+  void Update(const void* data, size_t len) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++) {
+      h ^= bytes[i];
+      h *= kPrime;
+    }
+  }
+
+  void Update(uint64_t v) {
+    Update(&v, sizeof(v));
+  }
+
+  void Update(const std::string& s) {
+    // Length prefix so that concatenations of strings cannot collide
+    Update(static_cast<uint64_t>(s.size()));
+    Update(s.data(), s.size());
+  }
+
+  void Update(const at::Tensor& t) {
+    Update(std::string(c10::toString(t.scalar_type())));
+    Update(static_cast<uint64_t>(t.dim()));
+    for (auto s : t.sizes()) {
+      Update(static_cast<uint64_t>(s));
+    }
+    if (t.is_cpu() && t.is_contiguous()) {
+      Update(t.data_ptr(), t.numel() * t.element_size());
+      return;
+    }
+
+    // Everything else is streamed through a bounded host buffer rather than
+    // copied to the host as a whole, the bytes hashed are the same either way
+    auto flat = t.contiguous().reshape({-1});
+    auto chunk_numel = std::max<int64_t>(kChunkBytes / t.element_size(), 1);
+    auto host = at::empty({std::min(chunk_numel, flat.numel())}, flat.options().device(at::kCPU));
+    for (int64_t start = 0; start < flat.numel(); start += chunk_numel) {
+      auto n = std::min(chunk_numel, flat.numel() - start);
+      auto dst = host.narrow(0, 0, n);
+      dst.copy_(flat.narrow(0, start, n));
+      Update(dst.data_ptr(), n * dst.element_size());
+    }
+  }
+
+  void Update(const c10::IValue& v) {
+    if (v.isTensor()) {
+      Update(std::string("Tensor"));
+      Update(v.toTensor());
+    } else if (v.isTensorList()) {
+      Update(std::string("TensorList"));
+      auto list = v.toTensorVector();
+      Update(static_cast<uint64_t>(list.size()));
+      for (auto& t : list) {
+        Update(t);
+      }
+    } else {
+      std::stringstream ss;
+      ss << v.tagKind() << ':' << v;
+      Update(ss.str());
+    }
+  }
+
+  void Update(const nvinfer1::Dims& d) {
+    Update(static_cast<uint64_t>(d.nbDims));
+    for (int i = 0; i < d.nbDims; i++) {
+      Update(static_cast<uint64_t>(d.d[i]));
+    }
+  }
+
+  uint64_t h = kOffsetBasis;
+};
+
+struct GraphHasher {
+  GraphHasher(const GraphParams& static_params) : static_params_(static_params) {}
+
+  uint64_t run(const Block* b) {
+    HashBlock(b);
+    return hasher_.h;
+  }
+
+ private:
+  // Values are identified by the order in which they are defined so that the
+  // hash does not depend on debug names
+  uint64_t Id(const Value* v) {
+    auto it = ids_.find(v);
+    TRTORCH_CHECK(it != ids_.end(), "Value " << v->debugName() << " is used before it is defined (HashGraph)");
+    return it->second;
+  }
+
+  void Define(const Value* v) {
+    auto id = static_cast<uint64_t>(ids_.size());
+    ids_[v] = id;
+    hasher_.Update(v->type()->str());
+  }
+
+  void HashBlock(const Block* b) {
+    hasher_.Update(std::string("block"));
+    for (auto in : b->inputs()) {
+      Define(in);
+      auto param_it = static_params_.find(const_cast<Value*>(in));
+      if (param_it != static_params_.end()) {
+        hasher_.Update(std::string("param"));
+        hasher_.Update(param_it->second);
+      }
+    }
+    for (auto n : b->nodes()) {
+      HashNode(n);
+    }
+    hasher_.Update(std::string("return"));
+    for (auto out : b->outputs()) {
+      hasher_.Update(Id(out));
+    }
+  }
+
+  void HashNode(const Node* n) {
+    hasher_.Update(std::string(n->kind().toQualString()));
+    hasher_.Update(static_cast<uint64_t>(n->inputs().size()));
+    for (auto in : n->inputs()) {
+      hasher_.Update(Id(in));
+    }
+
+    // Printed attributes cover scalars, strings and lists, tensor attributes
+    // are hashed by content since they are elided when printed
+    std::stringstream attrs;
+    n->printAttributes(attrs, /*ignore_subgraph=*/true);
+    hasher_.Update(attrs.str());
+    for (auto name : n->attributeNames()) {
+      if (n->kindOf(name) == AttributeKind::t) {
+        hasher_.Update(n->t(name));
+      } else if (n->kindOf(name) == AttributeKind::ts) {
+        for (auto& t : n->ts(name)) {
+          hasher_.Update(t);
+        }
+      }
+    }
+
+    for (auto out : n->outputs()) {
+      Define(out);
+    }
+
+    hasher_.Update(static_cast<uint64_t>(n->blocks().size()));
+    for (auto sub : n->blocks()) {
+      HashBlock(sub);
+    }
+  }
+
+  const GraphParams& static_params_;
+  std::unordered_map<const Value*, uint64_t> ids_;
+  Hasher hasher_;
+};
+
+} // namespace
+
+uint64_t HashGraph(const torch::jit::Block* b, const conversion::GraphParams& static_params) {
+  return GraphHasher(static_params).run(b);
+}
+
+uint64_t HashSettings(const conversion::ConversionInfo& info) {
+  Hasher hasher;
+  auto& s = info.engine_settings;
+  hasher.Update(static_cast<uint64_t>(s.op_precision));
+  hasher.Update(static_cast<uint64_t>(s.disable_tf32));
+  hasher.Update(static_cast<uint64_t>(s.refit));
+  hasher.Update(static_cast<uint64_t>(s.debug));
+  hasher.Update(static_cast<uint64_t>(s.strict_types));
+  hasher.Update(static_cast<uint64_t>(s.device.device_type));
+  hasher.Update(static_cast<uint64_t>(s.device.gpu_id));
+  hasher.Update(static_cast<uint64_t>(s.device.dla_core));
+  hasher.Update(static_cast<uint64_t>(s.device.allow_gpu_fallback));
+  hasher.Update(static_cast<uint64_t>(s.capability));
+  hasher.Update(static_cast<uint64_t>(s.num_min_timing_iters));
+  hasher.Update(static_cast<uint64_t>(s.num_avg_timing_iters));
+  hasher.Update(static_cast<uint64_t>(s.workspace_size));
+  hasher.Update(static_cast<uint64_t>(s.max_batch_size));
+
+  auto profiles = conversion::GetOptimizationProfiles(info);
+  hasher.Update(static_cast<uint64_t>(profiles.size()));
+  for (auto& ranges : profiles) {
+    hasher.Update(static_cast<uint64_t>(ranges.size()));
+    for (auto& r : ranges) {
+      hasher.Update(r.min);
+      hasher.Update(r.opt);
+      hasher.Update(r.max);
+      hasher.Update(r.input_shape);
+      hasher.Update(static_cast<uint64_t>(r.input_is_dynamic));
+    }
+  }
+  return hasher.h;
+}
+
+uint64_t HashVersions(const std::string& trtorch_version, int64_t gpu_id) {
+  Hasher hasher;
+  hasher.Update(trtorch_version);
+  // TensorRT version along with the LibTorch, CUDA and cuDNN configuration
+  hasher.Update(util::get_build_info());
+  hasher.Update(static_cast<uint64_t>(CUDART_VERSION));
+
+  // Engines are only valid on the architecture they were tuned on
+  cudaDeviceProp prop;
+  if (cudaGetDeviceProperties(&prop, static_cast<int>(gpu_id)) == cudaSuccess) {
+    hasher.Update(std::string(prop.name));
+    hasher.Update(static_cast<uint64_t>(prop.major));
+    hasher.Update(static_cast<uint64_t>(prop.minor));
+  } else {
+    hasher.Update(std::string("unknown device"));
+  }
+  return hasher.h;
+}
+
+EngineCacheKey MakeEngineCacheKey(
+    const torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const conversion::ConversionInfo& info,
+    const std::string& trtorch_version) {
+  EngineCacheKey key;
+  key.graph_hash = HashGraph(b, static_params);
+  key.settings_hash = HashSettings(info);
+  key.version_hash = HashVersions(trtorch_version, info.engine_settings.device.gpu_id);
+  return key;
+}
+
+} // namespace cache
+} // namespace core
+} // namespace trtorch
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <cuda_runtime.h>
@@ -17,15 +23,37 @@
 #include "torch/custom_class.h"
 
 #include "core/compiler.h"
+#include "core/util/Profiler.h"
 #include "core/util/prelude.h"
 
+#include "core/cache/cache.h"
 #include "core/conversion/conversion.h"
 #include "core/lowering/lowering.h"
+#include "core/partitioning/partitioning.h"
 #include "core/runtime/runtime.h"
 
 namespace trtorch {
 namespace core {
 
+// Everything needed to stitch the graph of a method compiled with fallback
+// together once the engines for its TensorRT segments are built
+struct FallbackSegments {
+  std::shared_ptr<torch::jit::Graph> g;
+  conversion::GraphParams named_params;
+  partitioning::PartitionedGraph segmented_blocks;
+  // Serialized engine for each TensorRT segment, empty for TorchScript segments
+  std::vector<std::string> engines;
+  // Provenance of the layers of each engine
+  std::vector<util::LayerProvenance> provenances;
+};
+
+struct CompiledMethod {
+  std::string name;
+  std::string engine;
+  util::LayerProvenance provenance;
+  FallbackSegments fallback;
+};
+
 c10::FunctionSchema GenerateGraphSchema(
     torch::jit::script::Module mod,
     std::string method_name,
@@ -43,14 +71,19 @@ c10::FunctionSchema GenerateGraphSchema(
   return c10::FunctionSchema(method_name, method_name, args, returns);
 }
 
-void AddEngineToGraph(
+std::vector<torch::jit::Value*> AddEngineCallToGraph(
     torch::jit::script::Module mod,
     std::shared_ptr<torch::jit::Graph>& g,
-    std::string& serialized_engine) {
-  auto engine_ptr = c10::make_intrusive<runtime::TRTEngine>(mod._ivalue()->name(), serialized_engine);
+    torch::jit::Value* self,
+    c10::intrusive_ptr<runtime::TRTEngine> engine_ptr,
+    std::vector<torch::jit::Value*> engine_inputs) {
   // Get required metadata about the engine out
   auto num_io = engine_ptr->num_io;
   auto name = engine_ptr->name;
+  TRTORCH_CHECK(
+      num_io.first == engine_inputs.size(),
+      "Engine expects " << num_io.first << " inputs but " << engine_inputs.size()
+                        << " were provided (AddEngineCallToGraph)");
 
   // Add the engine as an attribute of the module, this will let the engine be
   // serialized and deserialized
@@ -60,24 +93,10 @@ void AddEngineToGraph(
       c10::IValue(std::move(engine_ptr)),
       false);
 
-  // Add the module as an input into the graph
-  auto self = g->addInput("self_1");
-  self->setType(mod.type());
-
   // Start by retriveing the engine from the module attribute list
   auto engine_node = g->createGetAttr(self, name);
   g->block()->appendNode(engine_node);
 
-  // Add inputs to the graph corresponding to the number of input tensors
-  // expected by the engine Also store those inputs in a vector so that they can
-  // be coalesced into a single list at runtime
-  std::vector<torch::jit::Value*> engine_inputs;
-  for (uint64_t i = 0; i < num_io.first; i++) {
-    auto in_val = g->addInput(std::string("input_") + std::to_string(i));
-    in_val->setType(c10::TensorType::get());
-    engine_inputs.push_back(in_val);
-  }
-
   // Create a node that will merge all of the input tensors into a single list
   // argument to the trt::execute_engine op Creates: prim::ListConstruct(<input
   // tensors>)
@@ -100,25 +119,53 @@ void AddEngineToGraph(
   g->block()->appendNode(execute_node);
   execute_node->outputs()[0]->setType(c10::ListType::ofTensors());
 
-  // Create a node to unpack the list into seperate tensors, in the case of
-  // there being only one tensor, the tensor will be returned, otherwise they
-  // are returned as a tuple of tensors. Creates: prim::ListUnpack(<engine
-  // output>)
+  // Create a node to unpack the list into seperate tensors. Creates:
+  // prim::ListUnpack(<engine output>)
   auto unpack_node = g->createListUnpack(execute_node->outputs()[0], num_io.second);
   g->block()->appendNode(unpack_node);
 
+  return unpack_node->outputs().vec();
+}
+
+void AddEngineToGraph(
+    torch::jit::script::Module mod,
+    std::shared_ptr<torch::jit::Graph>& g,
+    std::string& serialized_engine,
+    util::LayerProvenance provenance,
+    const CompileSpec& cfg) {
+  auto engine_ptr =
+      c10::make_intrusive<runtime::TRTEngine>(mod._ivalue()->name(), serialized_engine, std::move(provenance));
+  engine_ptr->set_cuda_graph_enabled(cfg.use_cuda_graph);
+  auto num_inputs = engine_ptr->num_io.first;
+
+  // Add the module as an input into the graph
+  auto self = g->addInput("self_1");
+  self->setType(mod.type());
+
+  // Add inputs to the graph corresponding to the number of input tensors
+  // expected by the engine Also store those inputs in a vector so that they can
+  // be coalesced into a single list at runtime
+  std::vector<torch::jit::Value*> engine_inputs;
+  for (uint64_t i = 0; i < num_inputs; i++) {
+    auto in_val = g->addInput(std::string("input_") + std::to_string(i));
+    in_val->setType(c10::TensorType::get());
+    engine_inputs.push_back(in_val);
+  }
+
+  auto engine_outputs = AddEngineCallToGraph(mod, g, self, std::move(engine_ptr), engine_inputs);
+
   // If there are multiple output tensors from TensorRT we wrap them in a tuple
   // to return
-  if (unpack_node->outputs().size() > 1) {
+  if (engine_outputs.size() > 1) {
     // Creates prim::TupleConstruct(<output tensors>) using outputs of the
     // unpack node
-    auto return_tuple_node = g->createTuple(unpack_node->outputs());
+    auto return_tuple_node = g->createTuple(engine_outputs);
     g->block()->appendNode(return_tuple_node);
     // Set the output as the produced tuple
     g->registerOutput(return_tuple_node->outputs()[0]);
   } else {
     // Set the output as the sole output tensor
-    g->registerOutput(unpack_node->outputs()[0]);
+    g->registerOutput(engine_outputs[0]);
   }
 
   LOG_DEBUG(*g << "(AddEngineToGraph)\n");
@@ -126,6 +173,43 @@ void AddEngineToGraph(
   return;
 }
 
+// Input shapes lowering can rely on, a dim is only static if it is the same
+// in every range of every optimization profile. Inputs are half in FP16
+// engines and float otherwise (see ConversionCtx)
+lowering::LowerInfo MakeLowerInfo(const CompileSpec& cfg) {
+  auto& convert_info = cfg.convert_info;
+  auto& settings = convert_info.engine_settings;
+  auto lower_info = cfg.lower_info;
+  lower_info.input_dtype = settings.op_precision == nvinfer1::DataType::kHALF ? at::kHalf : at::kFloat;
+  lower_info.input_device = at::Device(at::kCUDA, settings.device.gpu_id);
+  lower_info.input_shapes.clear();
+  for (size_t i = 0; i < convert_info.input_ranges.size(); i++) {
+    std::vector<conversion::InputRange> ranges = {convert_info.input_ranges[i]};
+    if (i < convert_info.additional_input_ranges.size()) {
+      auto& additional = convert_info.additional_input_ranges[i];
+      ranges.insert(ranges.end(), additional.begin(), additional.end());
+    }
+
+    auto shape = util::toVec(ranges[0].min);
+    for (auto& r : ranges) {
+      auto min = util::toVec(r.min);
+      auto max = util::toVec(r.max);
+      if (min.size() != shape.size() || max.size() != shape.size()) {
+        // Ranks disagree, nothing can be assumed about the inputs
+        lower_info.input_shapes.clear();
+        return lower_info;
+      }
+      for (size_t d = 0; d < shape.size(); d++) {
+        if (min[d] != shape[d] || max[d] != shape[d]) {
+          shape[d] = -1;
+        }
+      }
+    }
+    lower_info.input_shapes.push_back(shape);
+  }
+  return lower_info;
+}
+
 bool CheckMethodOperatorSupport(const torch::jit::script::Module& mod, std::string method_name) {
   // Go through Lowering to simplify graph and extract weight parameters
   auto graph_and_parameters = lowering::Lower(mod, method_name);
@@ -136,9 +220,66 @@ bool CheckMethodOperatorSupport(const torch::jit::script::Module& mod, std::stri
   return conversion::VerifyConverterSupportForBlock(g->block());
 }
 
-std::string ConvertGraphToTRTEngine(const torch::jit::script::Module& mod, std::string method_name, CompileSpec cfg) {
+std::string ConvertBlockToEngineWithCache(
+    const torch::jit::Block* b,
+    conversion::ConversionInfo convert_info,
+    conversion::GraphParams& static_params,
+    const cache::CacheInfo& cache_info,
+    util::LayerProvenance* provenance = nullptr) {
+  if (!cache_info.enabled) {
+    return conversion::ConvertBlockToEngine(b, convert_info, static_params, provenance);
+  }
+
+  // Calibration results depend on the calibrator's data which cannot be
+  // captured in the key
+  if (convert_info.engine_settings.op_precision == nvinfer1::DataType::kINT8 &&
+      convert_info.engine_settings.calibrator != nullptr) {
+    LOG_DEBUG("Skipping engine cache for INT8 engine built with a calibrator");
+    return conversion::ConvertBlockToEngine(b, convert_info, static_params, provenance);
+  }
+
+  auto key = cache::MakeEngineCacheKey(b, static_params, convert_info, cache_info.trtorch_version);
+  cache::EngineCache engine_cache(cache_info.cache_dir, cache_info.max_size_bytes);
+  std::string engine;
+  if (engine_cache.Load(key, engine)) {
+    // The layers of a cached engine keep their names but the nodes behind
+    // them are not stored in the cache
+    LOG_INFO("Using cached TensorRT engine " << key.str() << ", layer provenance is not available for cached engines");
+    return engine;
+  }
+
+  engine = conversion::ConvertBlockToEngine(b, convert_info, static_params, provenance);
+  engine_cache.Store(key, engine);
+  return engine;
+}
+
+// Shares a profiler between lowering and conversion if the spec asks for one
+std::shared_ptr<util::Profiler> StartProfiling(CompileSpec& cfg) {
+  if (cfg.conversion_profile_path.empty()) {
+    return nullptr;
+  }
+  auto profiler = std::make_shared<util::Profiler>();
+  cfg.lower_info.profiler = profiler;
+  cfg.convert_info.profiler = profiler;
+  return profiler;
+}
+
+void ReportProfile(const std::shared_ptr<util::Profiler>& profiler, const std::string& path) {
+  if (!profiler) {
+    return;
+  }
+  profiler->WriteChromeTrace(path);
+  LOG_INFO("Wrote the compilation profile to " << path << ", time spent per phase and op:\n" << profiler->Summary());
+}
+
+std::string ConvertMethodToTRTEngine(
+    const torch::jit::script::Module& mod,
+    std::string method_name,
+    CompileSpec cfg,
+    util::LayerProvenance* provenance = nullptr) {
+  util::Profiler::Scope scope(cfg.convert_info.profiler.get(), "Compile " + method_name, "compile");
   // Go through Lowering to simplify graph and extract weight parameters
-  auto graph_and_parameters = lowering::Lower(mod, method_name);
+  auto graph_and_parameters = lowering::Lower(mod, method_name, MakeLowerInfo(cfg));
 
   auto convert_cfg = std::move(cfg.convert_info);
   auto g = graph_and_parameters.first;
@@ -147,27 +288,281 @@ std::string ConvertGraphToTRTEngine(const torch::jit::script::Module& mod, std::
 
   LOG_INFO(*g << "(CompileGraph)\n");
 
-  auto engine = conversion::ConvertBlockToEngine(g->block(), convert_cfg, named_params);
+  auto engine = ConvertBlockToEngineWithCache(g->block(), convert_cfg, named_params, cfg.cache_info, provenance);
   return std::move(engine);
 }
 
+std::string ConvertGraphToTRTEngine(const torch::jit::script::Module& mod, std::string method_name, CompileSpec cfg) {
+  auto profiler = StartProfiling(cfg);
+  auto engine = ConvertMethodToTRTEngine(mod, method_name, cfg);
+  ReportProfile(profiler, cfg.conversion_profile_path);
+  return engine;
+}
+
+FallbackSegments BuildFallbackSegments(
+    const torch::jit::script::Module& mod,
+    std::string method_name,
+    CompileSpec cfg) {
+  util::Profiler::Scope scope(cfg.convert_info.profiler.get(), "Compile " + method_name, "compile");
+  FallbackSegments segs;
+  // Go through Lowering to simplify graph and extract weight parameters
+  auto lower_info = MakeLowerInfo(cfg);
+  auto graph_and_parameters = lowering::Lower(mod, method_name, lower_info);
+
+  auto convert_cfg = std::move(cfg.convert_info);
+  segs.g = graph_and_parameters.first;
+  auto params = graph_and_parameters.second;
+  segs.named_params = conversion::get_named_params(segs.g->inputs(), params);
+
+  LOG_INFO(*segs.g << "(CompileGraphWithFallback)\n");
+  if (!convert_cfg.additional_input_ranges.empty()) {
+    LOG_WARNING("Additional input ranges are ignored for graphs partitioned for Torch fallback");
+  }
+
+  {
+    util::Profiler::Scope partition_scope(convert_cfg.profiler.get(), "Partition", "partitioning");
+    segs.segmented_blocks =
+        partitioning::Partition(
+            segs.g->block(), segs.named_params, convert_cfg.input_ranges, cfg.partition_info, lower_info.input_dtype);
+  }
+
+  for (size_t i = 0; i < segs.segmented_blocks.size(); i++) {
+    auto& seg = segs.segmented_blocks[i];
+    if (seg.target() != partitioning::SegmentedBlock::kTensorRT) {
+      segs.engines.emplace_back();
+      segs.provenances.emplace_back();
+      continue;
+    }
+
+    // Static parameters get folded into the engine, everything else becomes
+    // an engine input
+    conversion::GraphParams seg_params;
+    for (size_t j = 0; j < seg.inputs().size(); j++) {
+      auto param_it = segs.named_params.find(seg.inputs()[j]);
+      if (param_it != segs.named_params.end()) {
+        seg_params[seg.g()->inputs()[j]] = param_it->second;
+      }
+    }
+
+    // Segment inputs come from shape analysis on the first profile, further
+    // optimization profiles only apply to graphs converted as a whole
+    auto seg_cfg = convert_cfg;
+    seg_cfg.input_ranges = seg.in_shapes();
+    seg_cfg.additional_input_ranges.clear();
+    LOG_INFO(*seg.g() << "(Segment " << i << ")\n");
+    util::LayerProvenance provenance;
+    segs.engines.push_back(
+        ConvertBlockToEngineWithCache(seg.g()->block(), seg_cfg, seg_params, cfg.cache_info, &provenance));
+    segs.provenances.push_back(std::move(provenance));
+  }
+  return segs;
+}
+
+std::shared_ptr<torch::jit::Graph> ConstructFallbackGraph(
+    torch::jit::script::Module& new_mod,
+    const torch::jit::script::Module& mod,
+    std::string method_name,
+    FallbackSegments& segs,
+    const CompileSpec& cfg) {
+  auto& g = segs.g;
+  auto& named_params = segs.named_params;
+  auto& segmented_blocks = segs.segmented_blocks;
+
+  auto new_g = std::make_shared<torch::jit::Graph>();
+  auto self = new_g->addInput("self_1");
+  self->setType(new_mod.type());
+
+  // Parameters only used by TensorRT segments are already folded into their
+  // engines, the rest need to be kept in the new module
+  std::unordered_set<torch::jit::Value*> torch_used_values(g->outputs().begin(), g->outputs().end());
+  for (auto& seg : segmented_blocks) {
+    if (seg.target() != partitioning::SegmentedBlock::kTensorRT) {
+      torch_used_values.insert(seg.inputs().begin(), seg.inputs().end());
+    }
+  }
+
+  // Maps values in the lowered graph to their equivalent in the new graph
+  std::unordered_map<torch::jit::Value*, torch::jit::Value*> old_to_new_g;
+  uint64_t num_params = 0;
+  for (auto in : g->inputs()) {
+    auto param_it = named_params.find(in);
+    if (param_it != named_params.end()) {
+      if (torch_used_values.find(in) == torch_used_values.end()) {
+        continue;
+      }
+      // Parameters needed by TorchScript segments are kept as attributes of
+      // the new module
+      auto param_name = method_name + "_param_" + std::to_string(num_params++);
+      auto param_type = param_it->second.isTensor() ? c10::TensorType::get() : in->type();
+      new_mod.register_attribute(param_name, param_type, param_it->second, false);
+      auto get_param_node = new_g->createGetAttr(self, param_name);
+      new_g->appendNode(get_param_node);
+      old_to_new_g[in] = get_param_node->output();
+    } else {
+      auto new_in = new_g->addInput();
+      new_in->copyMetadata(in);
+      old_to_new_g[in] = new_in;
+    }
+  }
+
+  // Constants are not part of any segment boundary so copy them over when
+  // first needed
+  auto get_new_value = [&](torch::jit::Value* v) -> torch::jit::Value* {
+    auto it = old_to_new_g.find(v);
+    if (it != old_to_new_g.end()) {
+      return it->second;
+    }
+    TRTORCH_CHECK(
+        v->node()->kind() == torch::jit::prim::Constant,
+        "Unable to find value " << v->debugName() << " in the fallback graph (ConstructFallbackGraph)");
+    auto const_node = new_g->createClone(v->node(), [](torch::jit::Value* v) { return v; });
+    new_g->appendNode(const_node);
+    old_to_new_g[v] = const_node->output();
+    return const_node->output();
+  };
+
+  for (size_t i = 0; i < segmented_blocks.size(); i++) {
+    auto& seg = segmented_blocks[i];
+    std::vector<torch::jit::Value*> seg_outputs;
+    if (seg.target() == partitioning::SegmentedBlock::kTensorRT) {
+      std::vector<torch::jit::Value*> engine_inputs;
+      for (auto in : seg.inputs()) {
+        if (named_params.find(in) == named_params.end()) {
+          engine_inputs.push_back(get_new_value(in));
+        }
+      }
+
+      auto engine_name = mod._ivalue()->name() + "_" + method_name + "_segment_" + std::to_string(i);
+      auto engine_ptr = c10::make_intrusive<runtime::TRTEngine>(engine_name, segs.engines[i], segs.provenances[i]);
+      engine_ptr->set_cuda_graph_enabled(cfg.use_cuda_graph);
+      seg_outputs = AddEngineCallToGraph(new_mod, new_g, self, std::move(engine_ptr), engine_inputs);
+    } else {
+      std::vector<torch::jit::Value*> seg_inputs;
+      for (auto in : seg.inputs()) {
+        seg_inputs.push_back(get_new_value(in));
+      }
+      seg_outputs = torch::jit::insertGraph(*new_g, *seg.g(), seg_inputs);
+    }
+
+    TRTORCH_CHECK(
+        seg_outputs.size() == seg.outputs().size(),
+        "Segment " << i << " produced " << seg_outputs.size() << " outputs but " << seg.outputs().size()
+                   << " were expected (ConstructFallbackGraph)");
+    for (size_t o = 0; o < seg_outputs.size(); o++) {
+      old_to_new_g[seg.outputs()[o]] = seg_outputs[o];
+    }
+  }
+
+  for (auto out : g->outputs()) {
+    new_g->registerOutput(get_new_value(out));
+  }
+
+  LOG_DEBUG(*new_g << "(ConstructFallbackGraph)\n");
+  return new_g;
+}
+
+// Lowers and converts a method, nothing here touches the new module so
+// methods can be compiled concurrently
+CompiledMethod CompileMethod(const torch::jit::script::Module& mod, std::string method_name, CompileSpec cfg) {
+  CompiledMethod compiled;
+  compiled.name = method_name;
+  if (cfg.partition_info.enabled) {
+    compiled.fallback = BuildFallbackSegments(mod, method_name, cfg);
+  } else {
+    compiled.engine = ConvertMethodToTRTEngine(mod, method_name, cfg, &compiled.provenance);
+  }
+  return compiled;
+}
+
+std::vector<CompiledMethod> CompileMethods(
+    const torch::jit::script::Module& mod,
+    const std::vector<std::string>& method_names,
+    CompileSpec cfg) {
+  std::vector<CompiledMethod> compiled(method_names.size());
+
+  uint64_t num_threads = cfg.num_compile_threads;
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  num_threads = std::min(num_threads, static_cast<uint64_t>(method_names.size()));
+  if (num_threads > 1 && cfg.convert_info.engine_settings.calibrator != nullptr) {
+    LOG_WARNING("INT8 calibrators cannot be shared between concurrent builds, compiling methods serially");
+    num_threads = 1;
+  }
+
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < method_names.size(); i++) {
+      compiled[i] = CompileMethod(mod, method_names[i], cfg);
+    }
+    return compiled;
+  }
+
+  LOG_INFO("Compiling " << method_names.size() << " methods using " << num_threads << " threads");
+
+  // The current CUDA device is per thread, workers build on the device of
+  // the calling thread
+  int device = 0;
+  TRTORCH_CHECK(cudaGetDevice(&device) == cudaSuccess, "Unable to get the current CUDA device");
+
+  std::vector<std::exception_ptr> errors(method_names.size());
+  std::atomic<size_t> next_method(0);
+  std::vector<std::thread> workers;
+  for (uint64_t t = 0; t < num_threads; t++) {
+    workers.emplace_back([&]() {
+      cudaSetDevice(device);
+      for (size_t i = next_method++; i < method_names.size(); i = next_method++) {
+        try {
+          compiled[i] = CompileMethod(mod, method_names[i], cfg);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  // Report the failure of the first method in module order
+  for (auto& e : errors) {
+    if (e) {
+      std::rethrow_exception(e);
+    }
+  }
+  return compiled;
+}
+
 torch::jit::script::Module CompileGraph(const torch::jit::script::Module& mod, CompileSpec cfg) {
   // TODO: Should be doing a functional transform but need PR #31978
   // [jit] More robust mangling
   // torch::jit::script::Module new_mod = mod.clone();
   torch::jit::script::Module new_mod(mod._ivalue()->name() + "_trt");
-  std::vector<std::shared_ptr<torch::jit::Graph>> graphs;
+  std::vector<std::string> method_names;
   for (const torch::jit::script::Method& method : mod.get_methods()) {
     // Don't convert hidden methods
     if (method.name().rfind("_", 0)) {
-      auto engine = ConvertGraphToTRTEngine(mod, method.name(), cfg);
-      auto new_g = std::make_shared<torch::jit::Graph>();
-      AddEngineToGraph(new_mod, new_g, engine);
-      auto new_method = new_mod._ivalue()->compilation_unit()->create_function(method.name(), new_g);
-      auto schema = GenerateGraphSchema(new_mod, new_method->name(), new_g);
-      new_mod.type()->addMethod(new_method);
-      new_method->setSchema(schema);
+      method_names.push_back(method.name());
+    }
+  }
+
+  auto profiler = StartProfiling(cfg);
+  auto compiled_methods = CompileMethods(mod, method_names, cfg);
+  ReportProfile(profiler, cfg.conversion_profile_path);
+
+  // Engines are attached in module order so the resulting module does not
+  // depend on which method finished compiling first
+  for (auto& compiled : compiled_methods) {
+    std::shared_ptr<torch::jit::Graph> new_g;
+    if (cfg.partition_info.enabled) {
+      new_g = ConstructFallbackGraph(new_mod, mod, compiled.name, compiled.fallback, cfg);
+    } else {
+      new_g = std::make_shared<torch::jit::Graph>();
+      AddEngineToGraph(new_mod, new_g, compiled.engine, std::move(compiled.provenance), cfg);
     }
+    auto new_method = new_mod._ivalue()->compilation_unit()->create_function(compiled.name, new_g);
+    auto schema = GenerateGraphSchema(new_mod, new_method->name(), new_g);
+    new_mod.type()->addMethod(new_method);
+    new_method->setSchema(schema);
   }
 
   return new_mod;
@@ -2,7 +2,10 @@
 
 #include <cuda_runtime.h>
 #include <vector>
+#include "core/cache/cache.h"
 #include "core/conversion/conversion.h"
+#include "core/lowering/lowering.h"
+#include "core/partitioning/partitioning.h"
 #include "torch/csrc/jit/api/module.h"
 
 namespace trtorch {
@@ -11,6 +14,19 @@ namespace core {
 struct CompileSpec {
   CompileSpec(std::vector<conversion::InputRange> input_ranges) : convert_info(std::move(input_ranges)) {}
   conversion::ConversionInfo convert_info;
+  partitioning::PartitionInfo partition_info;
+  cache::CacheInfo cache_info;
+  // Lowering passes to turn on or off, input shapes are filled in from the
+  // input ranges at compile time
+  lowering::LowerInfo lower_info;
+  // Number of methods lowered and converted concurrently (0 uses one thread
+  // per hardware thread)
+  uint64_t num_compile_threads = 1;
+  // Replay engine executions from captured CUDA graphs at runtime
+  bool use_cuda_graph = false;
+  // Write a Chrome trace of the time spent lowering and converting here and
+  // log a summary of it, empty disables profiling
+  std::string conversion_profile_path;
 };
 
 bool CheckMethodOperatorSupport(const torch::jit::script::Module& mod, std::string method_name);
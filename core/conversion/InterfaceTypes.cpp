@@ -72,6 +72,39 @@ InputRange::InputRange(std::vector<int64_t> min_shape, std::vector<int64_t> opt_
   input_shape = util::toDims(dyn_shape);
 }
 
+std::vector<std::vector<InputRange>> GetOptimizationProfiles(const ConversionInfo& info) {
+  std::vector<std::vector<InputRange>> profiles = {info.input_ranges};
+  if (info.additional_input_ranges.empty()) {
+    return profiles;
+  }
+
+  TRTORCH_CHECK(
+      info.additional_input_ranges.size() == info.input_ranges.size(),
+      "Expected additional input ranges for all " << info.input_ranges.size() << " inputs, but found them for "
+                                                  << info.additional_input_ranges.size());
+  auto num_additional = info.additional_input_ranges[0].size();
+  for (size_t i = 0; i < info.additional_input_ranges.size(); i++) {
+    TRTORCH_CHECK(
+        info.additional_input_ranges[i].size() == num_additional,
+        "Expected every input to have the same number of additional input ranges, but input "
+            << i << " has " << info.additional_input_ranges[i].size() << " and input 0 has " << num_additional);
+  }
+
+  for (size_t k = 0; k < num_additional; k++) {
+    std::vector<InputRange> profile;
+    for (size_t i = 0; i < info.additional_input_ranges.size(); i++) {
+      auto& range = info.additional_input_ranges[i][k];
+      TRTORCH_CHECK(
+          range.opt.nbDims == info.input_ranges[i].opt.nbDims,
+          "Additional input range " << k << " of input " << i << " has " << range.opt.nbDims
+                                    << " dimensions, expected " << info.input_ranges[i].opt.nbDims);
+      profile.push_back(range);
+    }
+    profiles.push_back(std::move(profile));
+  }
+  return profiles;
+}
+
 } // namespace conversion
 } // namespace core
 } // namespace trtorch
@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <sstream>
+#include <tuple>
 
 #include "core/conversion/conversion.h"
 #include "core/conversion/conversionctx/ConversionCtx.h"
@@ -14,52 +18,200 @@ namespace trtorch {
 namespace core {
 namespace conversion {
 
-// Defined in core/conversion/conversion_ignorelist.cpp
-bool isNodeConversionIgnored(const torch::jit::Node* n);
-
 bool OpSupported(const torch::jit::Node* n) {
   return evaluators::shouldEvalAtConversionTime(n) || converters::node_is_convertable(n);
 }
 
-c10::optional<torch::jit::IValue> EvaluateNode(ConversionCtx* ctx, const torch::jit::Node* n, int level, int limit) {
-  // Check to see if you can just go through and eval all of these AOT (saves
-  // the recursion) Also probably a better way to deal with the two error cases;
-  TRTORCH_CHECK(
-      level < limit,
-      "Failed to evaluate node: " << *n << "Reason: Exceeded evaluation stack limit (limit=" << limit << ")");
+// Nodes outside of the plan (or without a plan) are looked up in the registry
+bool CanEvaluate(const ConversionPlan* plan, const torch::jit::Node* n) {
+  auto planned = plan ? plan->find(n) : nullptr;
+  if (planned) {
+    return static_cast<bool>(planned->evaluator);
+  }
+  return evaluators::shouldEvalAtConversionTime(n);
+}
+
+// Overload name of the schema of the node, or its kind for ops without one
+std::string ProfileName(const torch::jit::Node* n) {
+  auto schema = n->maybeSchema();
+  if (schema) {
+    return c10::toString(schema->operator_name());
+  }
+  return n->kind().toQualString();
+}
 
+bool IsResolved(ConversionCtx* ctx, const torch::jit::Value* v) {
+  return ctx->evaluated_value_map.find(v) != ctx->evaluated_value_map.end() ||
+      ctx->value_tensor_map.find(v) != ctx->value_tensor_map.end();
+}
+
+// Runs the evaluator of a node whose inputs are all resolved
+c10::optional<torch::jit::IValue> RunEvaluator(
+    ConversionCtx* ctx,
+    const ConversionPlan* plan,
+    const torch::jit::Node* n) {
   LOG_DEBUG(ctx->logger, "Evaluating " << util::node_info(n));
   evaluators::kwargs eval_args;
   for (auto eval_in : n->inputs()) {
-    if (eval_args.find(eval_in) != eval_args.end()) {
-      // No need to evaluate nodes that already have been entered in the
-      // args dict
-      continue;
+    auto evaluated = ctx->evaluated_value_map.find(eval_in);
+    if (evaluated != ctx->evaluated_value_map.end()) {
+      eval_args[eval_in] = &(evaluated->second);
+    } else {
+      eval_args[eval_in] = ctx->value_tensor_map.at(eval_in);
+    }
+  }
+
+  auto planned = plan ? plan->find(n) : nullptr;
+  auto start = std::chrono::steady_clock::now();
+  c10::optional<torch::jit::IValue> eval;
+  if (planned) {
+    TRTORCH_CHECK(
+        planned->evaluator,
+        "Requested evaluator for " << n->kind().toQualString() << ", but no such evaluator was found");
+    eval = planned->evaluator(n, eval_args);
+  } else {
+    eval = evaluators::EvalNode(n, eval_args);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  if (ctx->profiler) {
+    ctx->profiler->Record(ProfileName(n), "evaluator", start, end);
+  }
+  auto& stats = ctx->evaluator_stats[n->kind()];
+  stats.num_evaluations++;
+  stats.total_time_ms += std::chrono::duration<double, std::milli>(end - start).count();
+  return eval;
+}
+
+// Memoizes the result of an evaluated node, evaluators that return nothing
+// yield None so the node is not evaluated again
+void AssociateEvaluatedOutputs(
+    ConversionCtx* ctx,
+    const torch::jit::Node* n,
+    const c10::optional<torch::jit::IValue>& eval) {
+  if (!eval) {
+    LOG_DEBUG(ctx->logger, "Found the value(s) to be None for node: " << util::node_info(n));
+    for (auto o : n->outputs()) {
+      ctx->AssociateValueAndIValue(o, torch::jit::IValue());
     }
-    if (ctx->evaluated_value_map.find(eval_in) != ctx->evaluated_value_map.end()) {
-      eval_args[eval_in] = &(ctx->evaluated_value_map[eval_in]);
-    } else if (ctx->value_tensor_map.find(eval_in) != ctx->value_tensor_map.end()) {
-      eval_args[eval_in] = ctx->value_tensor_map[eval_in];
-    } else if (evaluators::shouldEvalAtConversionTime(eval_in->node())) {
-      auto result = EvaluateNode(ctx, eval_in->node(), level++, limit);
-      if (result) {
-        // WARN: If the converter returns None then should pass through
-        // but if repeated dep this section will get called each time
-        ctx->evaluated_value_map[eval_in] = std::move(result.value());
-        eval_args[eval_in] = &(ctx->evaluated_value_map[eval_in]);
+  } else if (n->outputs().size() > 1) { // For ListUnpack scenario
+    if (eval.value().isTuple()) {
+      auto eval_list = eval.value().toTuple();
+      TRTORCH_CHECK(
+          eval_list->elements().size() == n->outputs().size(),
+          "Size of evaluated results: " << eval_list->elements().size()
+                                        << " and node outputs size: " << n->outputs().size() << " must match.");
+      for (size_t i = 0; i < eval_list->elements().size(); i++) {
+        auto eval_output = eval_list.get()->elements()[i];
+        LOG_DEBUG(
+            ctx->logger, "Found the evaluated value(s) to be " << eval_output << " for node: " << util::node_info(n));
+        ctx->AssociateValueAndIValue(n->output(i), eval_output);
       }
     } else {
-      TRTORCH_THROW_ERROR(
-          "Failed to evaluate node: " << *n << "Reason: Node inputs cannot be evaluated at conversion time\n"
-                                      << "File a bug: https://www.github.com/NVIDIA/TRTorch/issues");
-      return {};
+      TRTORCH_THROW_ERROR("Unsupported return type for evaluated node");
     }
+  } else if (n->outputs().size() == 1) {
+    if (!eval.value().isTensor()) {
+      LOG_DEBUG(ctx->logger, "Found the value to be: " << eval.value());
+    } else {
+      LOG_DEBUG(ctx->logger, "Found the value to be a tensor (shape " << eval.value().toTensor().sizes() << ')');
+    }
+    ctx->AssociateValueAndIValue(n->output(0), eval.value());
   }
-  auto eval = evaluators::EvalNode(n, eval_args);
-  return eval;
 }
 
-void AddLayer(ConversionCtx* ctx, const torch::jit::Node* n) {
+// Evaluates the nodes producing the unresolved inputs of n in topological
+// order. An explicit stack replaces recursion so long chains of shape
+// arithmetic have no depth limit, and every result is memoized so shared
+// dependencies are evaluated once
+void EvaluateDependencies(ConversionCtx* ctx, const ConversionPlan* plan, const torch::jit::Node* n) {
+  // Node and whether its inputs have already been pushed
+  std::vector<std::pair<const torch::jit::Node*, bool>> stack;
+  auto push_unresolved_inputs = [&](const torch::jit::Node* consumer) {
+    for (auto in : consumer->inputs()) {
+      if (IsResolved(ctx, in)) {
+        continue;
+      }
+      if (!CanEvaluate(plan, in->node())) {
+        TRTORCH_THROW_ERROR(
+            "Failed to evaluate node: " << *consumer << "Reason: Node inputs cannot be evaluated at conversion time\n"
+                                        << "File a bug: https://www.github.com/NVIDIA/TRTorch/issues");
+      }
+      stack.emplace_back(in->node(), false);
+    }
+  };
+
+  push_unresolved_inputs(n);
+  while (!stack.empty()) {
+    auto dep = stack.back().first;
+    // Reached through another path already
+    if (dep->outputs().size() > 0 && IsResolved(ctx, dep->output(0))) {
+      stack.pop_back();
+      continue;
+    }
+    if (!stack.back().second) {
+      stack.back().second = true;
+      push_unresolved_inputs(dep);
+      continue;
+    }
+    stack.pop_back();
+    AssociateEvaluatedOutputs(ctx, dep, RunEvaluator(ctx, plan, dep));
+  }
+}
+
+c10::optional<torch::jit::IValue> EvaluateNode(
+    ConversionCtx* ctx,
+    const ConversionPlan* plan,
+    const torch::jit::Node* n) {
+  EvaluateDependencies(ctx, plan, n);
+  return RunEvaluator(ctx, plan, n);
+}
+
+c10::optional<torch::jit::IValue> EvaluateNode(ConversionCtx* ctx, const torch::jit::Node* n) {
+  return EvaluateNode(ctx, nullptr, n);
+}
+
+// Names the layers a converter added for a node <scope>/<kind>@<file>:<line>:<col>
+// (parts that are unknown are left out) so that the layers the engine reports
+// can be traced back to the module. Nodes that share all of these, e.g. the
+// copies of an unrolled loop, are numbered in conversion order and the layers
+// of a node that needs more than one are numbered as well
+void NameLayers(ConversionCtx* ctx, const torch::jit::Node* n, int first_layer) {
+  auto num_layers = ctx->net->getNbLayers() - first_layer;
+  if (num_layers <= 0) {
+    return;
+  }
+
+  util::NodeProvenance provenance;
+  provenance.kind = n->kind().toQualString();
+  provenance.scope = n->scopeName();
+  provenance.node = util::node_info(n);
+  std::string base_name = provenance.scope.empty() ? provenance.kind : provenance.scope + '/' + provenance.kind;
+  auto file_line_col = n->sourceRange().file_line_col();
+  if (file_line_col) {
+    std::string file;
+    size_t line = 0;
+    size_t col = 0;
+    std::tie(file, line, col) = *file_line_col;
+    auto line_col = ':' + std::to_string(line) + ':' + std::to_string(col);
+    provenance.source = file + line_col;
+    base_name += '@' + file.substr(file.find_last_of('/') + 1) + line_col;
+  }
+
+  auto count = ctx->layer_name_counts[base_name]++;
+  if (count > 0) {
+    base_name += '#' + std::to_string(count);
+  }
+  for (int i = 0; i < num_layers; i++) {
+    auto name = num_layers == 1 ? base_name : base_name + '/' + std::to_string(i);
+    ctx->net->getLayer(first_layer + i)->setName(name.c_str());
+    ctx->layer_provenance.Add(name, provenance);
+  }
+  LOG_DEBUG(ctx->logger, "Named the " << num_layers << " layers of " << util::node_info(n) << ' ' << base_name);
+}
+
+void AddLayer(ConversionCtx* ctx, const ConversionPlan& plan, const PlannedNode& planned) {
+  auto n = planned.node;
   LOG_INFO(ctx->logger, "Adding Layer " << util::node_info(n) << " (ctx.AddLayer)");
   converters::args node_args;
   for (auto input : n->inputs()) {
@@ -72,23 +224,12 @@ void AddLayer(ConversionCtx* ctx, const torch::jit::Node* n) {
       // Node input is a value that has already been evaluated
       LOG_DEBUG(ctx->logger, "Node input is a result of a previously evaluated value");
       node_args.push_back(&(ctx->evaluated_value_map[input]));
-    } else if (evaluators::shouldEvalAtConversionTime(input_node)) {
+    } else if (CanEvaluate(&plan, input_node)) {
       // Node input is a node that needs to be evaluated before
       // the node can be converted
       LOG_DEBUG(ctx->logger, "Node input is a value that needs to be evaluated");
-      auto eval = EvaluateNode(ctx, input_node);
-      if (eval) {
-        if (!eval.value().isTensor()) {
-          LOG_DEBUG(ctx->logger, "Found the value to be: " << eval.value());
-        } else {
-          LOG_DEBUG(ctx->logger, "Found the value to be a tensor (shape " << eval.value().toTensor().sizes() << ')');
-        }
-        ctx->AssociateValueAndIValue(input, eval.value());
-        node_args.push_back(&(ctx->evaluated_value_map[input]));
-      } else {
-        LOG_DEBUG(ctx->logger, "Found the value is None");
-        node_args.push_back(Var());
-      }
+      AssociateEvaluatedOutputs(ctx, input_node, EvaluateNode(ctx, &plan, input_node));
+      node_args.push_back(&(ctx->evaluated_value_map[input]));
     } else {
       // Node input has not been converted yet or is a prim op
       TRTORCH_THROW_ERROR(
@@ -101,24 +242,34 @@ void AddLayer(ConversionCtx* ctx, const torch::jit::Node* n) {
     TRTORCH_THROW_ERROR("Unable to retrieve all node inputs for node: " << *n);
   }
 
-  auto schema = n->maybeSchema();
-  TRTORCH_CHECK(schema, "Unable to get schema for Node " << util::node_info(n) << " (conversion.AddLayer)");
-
-  auto converter = converters::get_node_converter_for(schema);
-  TRTORCH_CHECK(
-      converter,
-      "Unable to convert node: "
-          << util::node_info(n) << " (conversion.AddLayer)\nSchema: " << *schema << "\nConverter for " << schema->name()
-          << " requested, but no such converter was found.\nIf you need a converter for this operator, you can try implementing one yourself\n"
-          << "or request a converter: https://www.github.com/NVIDIA/TRTorch/issues");
+  // The converter was resolved when planning, the schema is only needed to
+  // report errors
+  if (!planned.converter) {
+    auto schema = n->maybeSchema();
+    TRTORCH_CHECK(schema, "Unable to get schema for Node " << util::node_info(n) << " (conversion.AddLayer)");
+    TRTORCH_THROW_ERROR(
+        "Unable to convert node: "
+        << util::node_info(n) << " (conversion.AddLayer)\nSchema: " << *schema << "\nConverter for " << schema->name()
+        << " requested, but no such converter was found.\nIf you need a converter for this operator, you can try implementing one yourself\n"
+        << "or request a converter: https://www.github.com/NVIDIA/TRTorch/issues");
+  }
 
-  TRTORCH_CHECK(
-      converter(ctx, n, node_args),
-      "Converter for " << *schema << " failed to convert node: " << util::node_info(n)
-                       << "please report this error to https://www.github.com/NVIDIA/TRTorch/issues");
+  bool converted = false;
+  auto first_layer = ctx->net->getNbLayers();
+  {
+    util::Profiler::Scope scope(ctx->profiler, ctx->profiler ? ProfileName(n) : "", "converter");
+    converted = planned.converter(ctx, n, node_args);
+  }
+  if (!converted) {
+    auto schema = n->maybeSchema();
+    TRTORCH_THROW_ERROR(
+        "Converter for " << *schema << " failed to convert node: " << util::node_info(n)
+                         << "please report this error to https://www.github.com/NVIDIA/TRTorch/issues");
+  }
+  NameLayers(ctx, n, first_layer);
 }
 
-void AddInputs(ConversionCtx* ctx, at::ArrayRef<const torch::jit::Value*> inputs, std::vector<InputRange>& input_dims) {
+void AddInputs(ConversionCtx* ctx, at::ArrayRef<const torch::jit::Value*> inputs, const ConversionInfo& build_info) {
   std::vector<const torch::jit::Value*> input_tensors;
   for (auto in : inputs) {
     // Disregarding inputs that are not tensors
@@ -132,46 +283,74 @@ void AddInputs(ConversionCtx* ctx, at::ArrayRef<const torch::jit::Value*> inputs
     }
   }
 
+  auto profile_ranges = GetOptimizationProfiles(build_info);
+  auto& input_dims = profile_ranges[0];
+
   TRTORCH_CHECK(
       input_tensors.size() == input_dims.size(),
       "Expected dimension specifications for all input tensors"
           << ", but found " << input_tensors.size() << " input tensors and " << input_dims.size()
           << " dimension specs (conversion.AddInputs)");
 
-  auto profile = ctx->builder->createOptimizationProfile();
-
+  std::vector<nvinfer1::ITensor*> trt_inputs;
   for (size_t i = 0; i < input_tensors.size(); i++) {
     auto in = input_tensors[i];
-    auto dims = input_dims[i];
+    // A dimension is dynamic in the network if it varies within any profile
+    // or between profiles
+    auto input_shape = input_dims[i].input_shape;
+    for (auto& ranges : profile_ranges) {
+      for (int d = 0; d < input_shape.nbDims; d++) {
+        if (ranges[i].input_shape.d[d] != input_shape.d[d]) {
+          input_shape.d[d] = -1;
+        }
+      }
+    }
+
     std::string name = std::string("input_") + std::to_string(ctx->num_inputs);
     LOG_INFO(
         ctx->logger, "Adding Input " << in->debugName() << " named " << name << " in engine (conversion.AddInputs)");
-    LOG_DEBUG(ctx->logger, "Input shape set to " << dims.input_shape);
-    auto trt_in = ctx->net->addInput(name.c_str(), ctx->input_type, dims.input_shape);
+    LOG_DEBUG(ctx->logger, "Input shape set to " << input_shape);
+    auto trt_in = ctx->net->addInput(name.c_str(), ctx->input_type, input_shape);
     TRTORCH_CHECK(trt_in, "Failed to add input node: " << in->debugName() << " (conversion.AddInputs)");
 
-    profile->setDimensions(trt_in->getName(), nvinfer1::OptProfileSelector::kMIN, dims.min);
-    profile->setDimensions(trt_in->getName(), nvinfer1::OptProfileSelector::kOPT, dims.opt);
-    profile->setDimensions(trt_in->getName(), nvinfer1::OptProfileSelector::kMAX, dims.max);
-
-    if (dims.input_is_dynamic) {
-      ctx->input_is_dynamic = true;
+    for (int d = 0; d < input_shape.nbDims; d++) {
+      if (input_shape.d[d] == -1) {
+        ctx->input_is_dynamic = true;
+      }
     }
 
     ctx->value_tensor_map[in] = trt_in;
     ctx->num_inputs += 1;
+    trt_inputs.push_back(trt_in);
   }
 
-  TRTORCH_CHECK(
-      profile->isValid(),
-      "Optimization profile is invalid, please check the input range provided (conversion.AddInputs)");
+  for (size_t k = 0; k < profile_ranges.size(); k++) {
+    auto profile = ctx->builder->createOptimizationProfile();
+    for (size_t i = 0; i < trt_inputs.size(); i++) {
+      auto& dims = profile_ranges[k][i];
+      if (profile_ranges.size() > 1) {
+        LOG_DEBUG(
+            ctx->logger,
+            "Optimization profile " << k << " range for " << trt_inputs[i]->getName() << ": min " << dims.min
+                                    << ", opt " << dims.opt << ", max " << dims.max);
+      }
+      profile->setDimensions(trt_inputs[i]->getName(), nvinfer1::OptProfileSelector::kMIN, dims.min);
+      profile->setDimensions(trt_inputs[i]->getName(), nvinfer1::OptProfileSelector::kOPT, dims.opt);
+      profile->setDimensions(trt_inputs[i]->getName(), nvinfer1::OptProfileSelector::kMAX, dims.max);
+    }
 
-  ctx->cfg->addOptimizationProfile(profile);
+    TRTORCH_CHECK(
+        profile->isValid(),
+        "Optimization profile " << k << " is invalid, please check the input range provided (conversion.AddInputs)");
+
+    ctx->cfg->addOptimizationProfile(profile);
 #if NV_TENSORRT_MAJOR > 7 || (NV_TENSORRT_MAJOR == 7 && NV_TENSORRT_MINOR >= 1)
-  if (ctx->op_precision == nvinfer1::DataType::kINT8) {
-    ctx->cfg->setCalibrationProfile(profile);
-  }
+    // Calibration runs with the first profile
+    if (k == 0 && ctx->op_precision == nvinfer1::DataType::kINT8) {
+      ctx->cfg->setCalibrationProfile(profile);
+    }
 #endif
+  }
 }
 
 void MarkOutputs(ConversionCtx* ctx, at::ArrayRef<const torch::jit::Value*> outputs) {
@@ -211,7 +390,7 @@ void AddParamsToCtxValueMap(ConversionCtx* ctx, GraphParams& params) {
   }
 }
 
-void EvaluateLoopBlock(ConversionCtx* ctx, const torch::jit::Node* n);
+void EvaluateLoopBlock(ConversionCtx* ctx, const ConversionPlan& plan, const PlannedNode& planned);
 
 void MapIValues(
     ConversionCtx* ctx,
@@ -241,7 +420,12 @@ void MapIValues(
   }
 }
 
-void EvaluateConditionalBlock(ConversionCtx* ctx, const torch::jit::Node* n, bool contained_in_loop = false) {
+void EvaluateConditionalBlock(
+    ConversionCtx* ctx,
+    const ConversionPlan& plan,
+    const PlannedNode& planned,
+    bool contained_in_loop = false) {
+  auto n = planned.node;
   bool output_type_includes_tensor = false;
   for (auto o : n->outputs()) {
     if (o->type()->isSubtypeOf(c10::TensorType::get())) {
@@ -254,26 +438,21 @@ void EvaluateConditionalBlock(ConversionCtx* ctx, const torch::jit::Node* n, boo
 
   auto condition = ctx->evaluated_value_map[n->input(0)].toBool();
   LOG_DEBUG(ctx->logger, "(Conditional Evaluation) Evaluating block " << (int)condition);
-  auto b = condition ? n->blocks()[0] : n->blocks()[1];
-
-  for (const auto bn : b->nodes()) {
-    if (bn->kind() == torch::jit::prim::Loop) {
-      EvaluateLoopBlock(ctx, bn);
-    } else if (bn->kind() == torch::jit::prim::If) {
-      EvaluateConditionalBlock(ctx, bn, contained_in_loop);
-    } else if (evaluators::shouldEvalAtConversionTime(bn)) {
-      auto eval = EvaluateNode(ctx, bn);
-      if (!eval.value().isTensor()) {
-        LOG_DEBUG(ctx->logger, "(Conditional Evaluation) Found the value to be: " << eval.value());
-      } else {
-        LOG_DEBUG(
-            ctx->logger,
-            "(Conditional Evaluation) Found the value to be a tensor (shape " << eval.value().toTensor().sizes()
-                                                                              << ')');
-      }
-      ctx->AssociateValueAndIValue(bn->output(0), eval.value());
-    } else if (converters::node_is_convertable(bn)) {
-      AddLayer(ctx, bn);
+  auto branch = condition ? 0 : 1;
+  auto b = n->blocks()[branch];
+
+  for (const auto& planned_bn : plan.entries(planned.blocks[branch])) {
+    auto bn = planned_bn.node;
+    if (planned_bn.dispatch == NodeDispatch::kLoop) {
+      EvaluateLoopBlock(ctx, plan, planned_bn);
+    } else if (planned_bn.dispatch == NodeDispatch::kConditional) {
+      EvaluateConditionalBlock(ctx, plan, planned_bn, contained_in_loop);
+    } else if (planned_bn.evaluator) {
+      LOG_DEBUG(ctx->logger, "(Conditional Evaluation) Evaluating " << util::node_info(bn));
+      AssociateEvaluatedOutputs(ctx, bn, EvaluateNode(ctx, &plan, bn));
+    } else if (planned_bn.converter) {
+      // Unlike the top level block, ignored nodes are converted if possible
+      AddLayer(ctx, plan, planned_bn);
     } else {
       TRTORCH_THROW_ERROR(
           "TRTorch is unable to compile this conditional, a converter or evaluator is not available for node " << *bn);
@@ -285,7 +464,8 @@ void EvaluateConditionalBlock(ConversionCtx* ctx, const torch::jit::Node* n, boo
 
 // TODO: With functionalization pass we may be able to make this into a regular
 // evaluator later
-void EvaluateLoopBlock(ConversionCtx* ctx, const torch::jit::Node* n) {
+void EvaluateLoopBlock(ConversionCtx* ctx, const ConversionPlan& plan, const PlannedNode& planned) {
+  auto n = planned.node;
   auto max_trip_count = ctx->evaluated_value_map[n->input(0)];
   auto start_cond = ctx->evaluated_value_map[n->input(1)];
   ctx->evaluated_value_map[n->blocks()[0]->inputs()[0]] = torch::jit::IValue(0);
@@ -300,25 +480,19 @@ void EvaluateLoopBlock(ConversionCtx* ctx, const torch::jit::Node* n) {
 
   while (start_cond.toBool() && trip_count.toInt() < max_trip_count.toInt()) {
     MapIValues(ctx, n->outputs(), n->blocks()[0]->inputs(), 0, 1);
-    for (auto bn : n->blocks()[0]->nodes()) {
-      if (bn->kind() == torch::jit::prim::Loop) {
-        EvaluateLoopBlock(ctx, n);
-      } else if (bn->kind() == torch::jit::prim::If) {
-        EvaluateConditionalBlock(ctx, bn, true);
+    for (const auto& planned_bn : plan.entries(planned.blocks[0])) {
+      auto bn = planned_bn.node;
+      if (planned_bn.dispatch == NodeDispatch::kLoop) {
+        EvaluateLoopBlock(ctx, plan, planned_bn);
+      } else if (planned_bn.dispatch == NodeDispatch::kConditional) {
+        EvaluateConditionalBlock(ctx, plan, planned_bn, true);
       } else {
         TRTORCH_CHECK(
-            evaluators::shouldEvalAtConversionTime(bn),
+            planned_bn.evaluator,
             "TRTorch currently can only compile loops that are evaluatable at conversion time but node "
                 << *bn << " cannot be evaluated.");
-        auto eval = EvaluateNode(ctx, bn);
-        if (!eval.value().isTensor()) {
-          LOG_DEBUG(ctx->logger, "(Loop Evaluation) Found the value to be: " << eval.value());
-        } else {
-          LOG_DEBUG(
-              ctx->logger,
-              "(Loop Evaluation) Found the value to be a tensor (shape " << eval.value().toTensor().sizes() << ')');
-        }
-        ctx->AssociateValueAndIValue(bn->output(0), eval.value());
+        LOG_DEBUG(ctx->logger, "(Loop Evaluation) Evaluating " << util::node_info(bn));
+        AssociateEvaluatedOutputs(ctx, bn, EvaluateNode(ctx, &plan, bn));
       }
     }
 
@@ -331,6 +505,27 @@ void EvaluateLoopBlock(ConversionCtx* ctx, const torch::jit::Node* n) {
   }
 }
 
+std::string FormatEvaluatorStats(const ConversionCtx* ctx) {
+  std::vector<std::pair<std::string, EvaluatorStats>> stats;
+  size_t name_width = 9;
+  for (auto& s : ctx->evaluator_stats) {
+    stats.emplace_back(s.first.toQualString(), s.second);
+    name_width = std::max(name_width, stats.back().first.size());
+  }
+  std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+    return a.second.total_time_ms > b.second.total_time_ms;
+  });
+
+  std::stringstream table;
+  table << std::left << std::setw(name_width) << "Evaluator" << std::right << std::setw(8) << "Runs" << std::setw(14)
+        << "Time (ms)" << std::endl;
+  for (auto& s : stats) {
+    table << std::left << std::setw(name_width) << s.first << std::right << std::setw(8) << s.second.num_evaluations
+          << std::setw(14) << std::fixed << std::setprecision(3) << s.second.total_time_ms << std::endl;
+  }
+  return table.str();
+}
+
 void ConvertBlockToNetDef(
     ConversionCtx* ctx,
     const torch::jit::Block* b,
@@ -340,65 +535,55 @@ void ConvertBlockToNetDef(
 
   auto inputs = b->inputs();
   AddParamsToCtxValueMap(ctx, static_params);
-  AddInputs(ctx, inputs, build_info.input_ranges);
-
-  auto nodes = b->nodes();
-
-  for (const auto n : nodes) {
-    bool to_eval = evaluators::shouldEvalAtConversionTime(n);
-    bool ignored = isNodeConversionIgnored(n);
-    if (n->kind() == torch::jit::prim::Loop) {
-      EvaluateLoopBlock(ctx, n);
-    } else if (n->kind() == torch::jit::prim::If) {
-      EvaluateConditionalBlock(ctx, n);
-    } else if (to_eval) {
-      auto eval = EvaluateNode(ctx, n);
-      if (eval) {
-        if (n->outputs().size() > 1) { // For ListUnpack scenario
-          if (eval.value().isTuple()) {
-            auto eval_list = eval.value().toTuple();
-            TRTORCH_CHECK(
-                eval_list->elements().size() == n->outputs().size(),
-                "Size of evaluated results: " << eval_list->elements().size()
-                                              << " and node outputs size: " << n->outputs().size() << " must match.");
-            for (size_t i = 0; i < eval_list->elements().size(); i++) {
-              auto eval_output = eval_list.get()->elements()[i];
-              LOG_DEBUG(
-                  ctx->logger,
-                  "Found the evaluated value(s) to be " << eval_output << " for node: " << util::node_info(n));
-              ctx->AssociateValueAndIValue(n->output(i), eval_output);
-            }
-          } else {
-            TRTORCH_THROW_ERROR("Unsupported return type for evaluated node");
-          }
-        } else if (!eval.value().isTensor()) {
-          LOG_DEBUG(ctx->logger, "Found the value to be: " << eval.value());
-          ctx->AssociateValueAndIValue(n->output(0), eval.value());
-        } else {
-          LOG_DEBUG(ctx->logger, "Found the value to be a tensor (shape " << eval.value().toTensor().sizes() << ')');
-          ctx->AssociateValueAndIValue(n->output(0), eval.value());
-        }
-      }
-    } else if (!ignored) {
-      // Should error out if something fails
-      AddLayer(ctx, n);
-    } else {
-      std::string reason = "";
-      if (to_eval) {
-        reason += " (to be evaluated)";
-      }
-      if (ignored) {
-        reason += " (explicitly ignored)";
-      }
-      LOG_DEBUG(ctx->logger, "Skipping Node: " << util::node_info(n) << reason);
+  {
+    util::Profiler::Scope scope(ctx->profiler, "AddInputs", "conversion");
+    AddInputs(ctx, inputs, build_info);
+  }
+
+  auto plan = [&]() {
+    util::Profiler::Scope scope(ctx->profiler, "PlanConversion", "conversion");
+    return ConversionPlan(b);
+  }();
+  LOG_DEBUG(ctx->logger, "Planned the conversion of " << plan.size() << " nodes");
+  // Dumping a large plan is not free, only build it when it will be printed
+  if (ctx->logger.get_reportable_log_level() >= util::logging::LogLevel::kGRAPH) {
+    LOG_GRAPH(ctx->logger, "Conversion plan:\n" << plan.Dump());
+  }
+
+  for (const auto& planned : plan.entries(plan.root())) {
+    auto n = planned.node;
+    switch (planned.dispatch) {
+      case NodeDispatch::kLoop:
+        EvaluateLoopBlock(ctx, plan, planned);
+        break;
+      case NodeDispatch::kConditional:
+        EvaluateConditionalBlock(ctx, plan, planned);
+        break;
+      case NodeDispatch::kEvaluate:
+        AssociateEvaluatedOutputs(ctx, n, EvaluateNode(ctx, &plan, n));
+        break;
+      case NodeDispatch::kIgnore:
+        LOG_DEBUG(ctx->logger, "Skipping Node: " << util::node_info(n) << " (explicitly ignored)");
+        break;
+      case NodeDispatch::kConvert:
+      case NodeDispatch::kUnsupported:
+      default:
+        // Should error out if something fails
+        AddLayer(ctx, plan, planned);
+        break;
     }
   }
 
-  for (const auto n : nodes) {
+  for (const auto n : b->nodes()) {
     ctx->CheckLayerAddition(n);
   }
 
+  if (!ctx->evaluator_stats.empty()) {
+    LOG_DEBUG(ctx->logger, "Time spent in evaluators:\n" << FormatEvaluatorStats(ctx));
+  }
+
   auto outputs = b->outputs();
+  util::Profiler::Scope scope(ctx->profiler, "MarkOutputs", "conversion");
   MarkOutputs(ctx, outputs);
 }
 
@@ -406,10 +591,39 @@ void ConvertBlockToNetDef(
 // a serialized TensorRT engine that can be deserialized and run
 
 // Probably should consolidate these two functions
-std::string ConvertBlockToEngine(const torch::jit::Block* b, ConversionInfo build_info, GraphParams& static_params) {
+bool BlockHasQuantizationRanges(const torch::jit::Block* b) {
+  for (const auto n : b->nodes()) {
+    if (n->kind() == c10::Symbol::fromQualString("trt::quantize_range")) {
+      return true;
+    }
+    for (const auto sub_b : n->blocks()) {
+      if (BlockHasQuantizationRanges(sub_b)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::string ConvertBlockToEngine(
+    const torch::jit::Block* b,
+    ConversionInfo build_info,
+    GraphParams& static_params,
+    util::LayerProvenance* provenance) {
+  // Models trained with QAT carry their own dynamic ranges, anything else
+  // needs a calibrator to build INT8 engines
+  auto& settings = build_info.engine_settings;
+  TRTORCH_CHECK(
+      settings.op_precision != nvinfer1::DataType::kINT8 || settings.calibrator != nullptr ||
+          BlockHasQuantizationRanges(b),
+      "Requested inference in INT8 but no calibrator provided, set the ptq_calibrator field in the CompileSpec struct with your calibrator or compile a model trained with quantization aware training");
   ConversionCtx ctx(build_info.engine_settings);
+  ctx.profiler = build_info.profiler.get();
   ConvertBlockToNetDef(&ctx, b, build_info, static_params);
   std::string engine = ctx.SerializeEngine();
+  if (provenance) {
+    *provenance = std::move(ctx.layer_provenance);
+  }
   return engine;
 }
 
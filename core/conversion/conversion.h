@@ -1,9 +1,12 @@
 #pragma once
 
 #include <map>
+#include <memory>
 
 #include "NvInfer.h"
 #include "core/conversion/conversionctx/ConversionCtx.h"
+#include "core/util/LayerProvenance.h"
+#include "core/util/Profiler.h"
 #include "torch/csrc/jit/ir/ir.h"
 
 namespace trtorch {
@@ -23,11 +26,21 @@ struct InputRange {
 
 struct ConversionInfo {
   std::vector<InputRange> input_ranges;
+  // Ranges for further optimization profiles, additional_input_ranges[i]
+  // lists the extra ranges of input i. Every input lists the same number of
+  // ranges, profile k + 1 is made of range k of every input
+  std::vector<std::vector<InputRange>> additional_input_ranges;
   BuilderSettings engine_settings;
+  // Records the time spent converting when set
+  std::shared_ptr<util::Profiler> profiler;
   ConversionInfo(std::vector<InputRange> input_ranges)
       : input_ranges(std::move(input_ranges)), engine_settings(BuilderSettings()) {}
 };
 
+// Groups the input ranges by optimization profile, the first profile is made
+// of input_ranges
+std::vector<std::vector<InputRange>> GetOptimizationProfiles(const ConversionInfo& info);
+
 // TODO: REMOVE GRAPH AND PARAMS AND MOVE FULLY TO INLINED CONSTANTS
 
 using GraphParams = std::map<torch::jit::Value*, torch::jit::IValue>;
@@ -35,18 +48,22 @@ using GraphParams = std::map<torch::jit::Value*, torch::jit::IValue>;
 GraphParams get_named_params(c10::ArrayRef<torch::jit::Value*> inputs, std::vector<torch::jit::IValue> params);
 
 // Converts a already lowered block (blocks with no sub blocks) to
-// a serialized TensorRT engine that can be deserialized and run
-std::string ConvertBlockToEngine(const torch::jit::Block* b, ConversionInfo build_info, GraphParams& static_params);
+// a serialized TensorRT engine that can be deserialized and run. The layers
+// converted from each node are named after the node's scope and source
+// location, provenance is filled with the node behind each name if set
+std::string ConvertBlockToEngine(
+    const torch::jit::Block* b,
+    ConversionInfo build_info,
+    GraphParams& static_params,
+    util::LayerProvenance* provenance = nullptr);
 
 bool OpSupported(const torch::jit::Node* n);
 
 bool VerifyConverterSupportForBlock(const torch::jit::Block* b);
 
-c10::optional<torch::jit::IValue> EvaluateNode(
-    ConversionCtx* ctx,
-    const torch::jit::Node* n,
-    int level = 0,
-    int limit = 10);
+// Evaluates a node at conversion time, first evaluating (and memoizing in
+// ctx->evaluated_value_map) whatever its inputs depend on
+c10::optional<torch::jit::IValue> EvaluateNode(ConversionCtx* ctx, const torch::jit::Node* n);
 
 } // namespace conversion
 } // namespace core
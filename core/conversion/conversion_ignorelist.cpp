@@ -1,5 +1,6 @@
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "torch/csrc/jit/ir/ir.h"
 
@@ -8,9 +9,9 @@ namespace core {
 namespace conversion {
 
 // clang-format off
-const std::unordered_set<std::string>& get_non_convertable_nodes() {
+const std::unordered_set<c10::Symbol>& get_non_convertable_nodes() {
   // Set of nodes that should not invoke a converter or evaluator
-  static std::unordered_set<std::string> nonconvertable_nodes = {
+  static const std::vector<std::string> nonconvertable_node_names = {
     "aten::manual_seed",
     "aten::grad",
     "aten::backward",
@@ -25,13 +26,20 @@ const std::unordered_set<std::string>& get_non_convertable_nodes() {
     "prim::Drop",
     "aten::dropout",
     "aten::dropout_"};
+  // clang-format on
+  // Keyed by symbol so lookups do not have to build the qualified name
+  static const std::unordered_set<c10::Symbol> nonconvertable_nodes = [] {
+    std::unordered_set<c10::Symbol> kinds;
+    for (const auto& name : nonconvertable_node_names) {
+      kinds.insert(c10::Symbol::fromQualString(name));
+    }
+    return kinds;
+  }();
   return nonconvertable_nodes;
 }
-// clang-format on
 
 bool isNodeConversionIgnored(const torch::jit::Node* n) {
-  auto kind = n->kind();
-  auto convertableIt = get_non_convertable_nodes().find(kind.toQualString());
+  auto convertableIt = get_non_convertable_nodes().find(n->kind());
   if (convertableIt == get_non_convertable_nodes().end()) {
     return false;
   } else {
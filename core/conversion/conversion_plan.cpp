@@ -0,0 +1,107 @@
+#include <sstream>
+
+#include "core/conversion/conversion_plan.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+
+// Defined in core/conversion/conversion_ignorelist.cpp
+bool isNodeConversionIgnored(const torch::jit::Node* n);
+
+const char* to_string(NodeDispatch d) {
+  switch (d) {
+    case NodeDispatch::kEvaluate:
+      return "evaluate";
+    case NodeDispatch::kConvert:
+      return "convert";
+    case NodeDispatch::kIgnore:
+      return "ignore";
+    case NodeDispatch::kLoop:
+      return "loop";
+    case NodeDispatch::kConditional:
+      return "conditional";
+    case NodeDispatch::kUnsupported:
+    default:
+      return "unsupported";
+  }
+}
+
+ConversionPlan::ConversionPlan(const torch::jit::Block* b) {
+  root_ = planBlock(b);
+}
+
+PlanRange ConversionPlan::planBlock(const torch::jit::Block* b) {
+  // Reserve the entries of the block up front so they stay contiguous, sub
+  // blocks are appended after them
+  PlanRange range;
+  range.begin = entries_.size();
+  for (const auto n : b->nodes()) {
+    PlannedNode entry;
+    entry.node = n;
+    if (n->kind() == torch::jit::prim::Loop) {
+      entry.dispatch = NodeDispatch::kLoop;
+    } else if (n->kind() == torch::jit::prim::If) {
+      entry.dispatch = NodeDispatch::kConditional;
+    } else {
+      entry.evaluator = evaluators::getEvaluatorFor(n);
+      entry.converter = converters::find_node_converter_for(n);
+      if (entry.evaluator) {
+        entry.dispatch = NodeDispatch::kEvaluate;
+      } else if (isNodeConversionIgnored(n)) {
+        entry.dispatch = NodeDispatch::kIgnore;
+      } else if (entry.converter) {
+        entry.dispatch = NodeDispatch::kConvert;
+      } else {
+        entry.dispatch = NodeDispatch::kUnsupported;
+      }
+    }
+    index_[n] = entries_.size();
+    entries_.push_back(std::move(entry));
+  }
+  range.end = entries_.size();
+
+  for (size_t i = range.begin; i < range.end; i++) {
+    for (const auto sub_b : entries_[i].node->blocks()) {
+      // Planning the sub block may reallocate entries_, no references held
+      auto sub_range = planBlock(sub_b);
+      entries_[i].blocks.push_back(sub_range);
+    }
+  }
+  return range;
+}
+
+const PlannedNode* ConversionPlan::find(const torch::jit::Node* n) const {
+  auto it = index_.find(n);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  return &entries_[it->second];
+}
+
+void ConversionPlan::dumpRange(std::ostream& os, PlanRange r, size_t depth) const {
+  for (size_t i = r.begin; i < r.end; i++) {
+    auto& e = entries_[i];
+    // Only outputs and kind, printing the node would repeat its sub blocks
+    os << std::string(2 * depth, ' ') << '[' << i << "] " << to_string(e.dispatch) << ": ";
+    for (size_t j = 0; j < e.node->outputs().size(); j++) {
+      os << (j == 0 ? "%" : ", %") << e.node->outputs()[j]->debugName();
+    }
+    os << (e.node->outputs().size() == 0 ? "" : " = ") << e.node->kind().toQualString() << std::endl;
+    for (size_t j = 0; j < e.blocks.size(); j++) {
+      os << std::string(2 * (depth + 1), ' ') << "block" << j << ':' << std::endl;
+      dumpRange(os, e.blocks[j], depth + 2);
+    }
+  }
+}
+
+std::string ConversionPlan::Dump() const {
+  std::stringstream os;
+  dumpRange(os, root_, 0);
+  return os.str();
+}
+
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "c10/util/ArrayRef.h"
+#include "torch/csrc/jit/ir/ir.h"
+
+#include "core/conversion/converters/converters.h"
+#include "core/conversion/evaluators/evaluators.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+
+// How a node is handled when it is reached during conversion
+enum class NodeDispatch {
+  kEvaluate, // Run its evaluator at conversion time
+  kConvert, // Add layers to the network with its converter
+  kIgnore, // On the conversion ignore list, skipped
+  kLoop, // prim::Loop, evaluated trip by trip
+  kConditional, // prim::If, only the taken branch is converted
+  kUnsupported, // Neither, conversion fails if the node is reached
+};
+
+const char* to_string(NodeDispatch d);
+
+// Half open range of the plan entries of a block
+struct PlanRange {
+  size_t begin = 0;
+  size_t end = 0;
+};
+
+struct PlannedNode {
+  const torch::jit::Node* node = nullptr;
+  NodeDispatch dispatch = NodeDispatch::kUnsupported;
+  // Set whenever the registries have one for the node, not only for the
+  // dispatch picked for the top level block, conditionals for instance
+  // convert ignored nodes that have a converter
+  evaluators::NodeEvaluator evaluator;
+  converters::OpConverter converter;
+  // Entries of the sub blocks of loops and conditionals
+  std::vector<PlanRange> blocks;
+};
+
+// Resolves the evaluator, converter or control flow handling of every node
+// of a block (and its sub blocks) once, so conversion walks a flat array
+// instead of querying the registries for each node it visits. The entries of
+// a block are contiguous and in node order
+class ConversionPlan {
+ public:
+  explicit ConversionPlan(const torch::jit::Block* b);
+
+  PlanRange root() const {
+    return root_;
+  }
+
+  c10::ArrayRef<PlannedNode> entries(PlanRange r) const {
+    return c10::ArrayRef<PlannedNode>(entries_.data() + r.begin, r.end - r.begin);
+  }
+
+  // nullptr for nodes outside of the planned block
+  const PlannedNode* find(const torch::jit::Node* n) const;
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+  // One line per node with its dispatch, nested blocks are indented
+  std::string Dump() const;
+
+ private:
+  PlanRange planBlock(const torch::jit::Block* b);
+  void dumpRange(std::ostream& os, PlanRange r, size_t depth) const;
+
+  std::vector<PlannedNode> entries_;
+  std::unordered_map<const torch::jit::Node*, size_t> index_;
+  PlanRange root_;
+};
+
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
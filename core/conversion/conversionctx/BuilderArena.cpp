@@ -0,0 +1,46 @@
+#include <algorithm>
+
+#include "core/conversion/conversionctx/BuilderArena.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+
+void BuilderArena::addOwned(size_t nbytes) {
+  stats_.owned_bytes += nbytes;
+  stats_.peak_owned_bytes = std::max(stats_.peak_owned_bytes, stats_.owned_bytes);
+}
+
+void* BuilderArena::Allocate(size_t nbytes) {
+  allocations_.emplace_back(new uint8_t[std::max<size_t>(nbytes, 1)]);
+  addOwned(nbytes);
+  return allocations_.back().get();
+}
+
+const void* BuilderArena::Keep(const at::Tensor& t_host, bool borrowed) {
+  TRTORCH_CHECK(
+      t_host.device().is_cpu() && t_host.is_contiguous(), "Only contiguous CPU tensors can be kept for the builder");
+  tensors_.push_back(t_host);
+  if (borrowed) {
+    stats_.borrowed_bytes += t_host.nbytes();
+  } else {
+    addOwned(t_host.nbytes());
+  }
+  return t_host.data_ptr();
+}
+
+void BuilderArena::Clear() {
+  allocations_.clear();
+  tensors_.clear();
+  stats_.owned_bytes = 0;
+  stats_.borrowed_bytes = 0;
+}
+
+const BuilderArenaStats& BuilderArena::stats() const {
+  return stats_;
+}
+
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
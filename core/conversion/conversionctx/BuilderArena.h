@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ATen/Tensor.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+
+struct BuilderArenaStats {
+  // Host memory currently held for the build that was allocated or copied for it
+  uint64_t owned_bytes = 0;
+  // Highest owned_bytes reached
+  uint64_t peak_owned_bytes = 0;
+  // Host memory of tensors referenced without copying them
+  uint64_t borrowed_bytes = 0;
+};
+
+/**
+ * Holds the host memory TensorRT reads weights from while building an engine.
+ * Contiguous CPU tensors are referenced instead of copied, everything else is
+ * allocated here, sized by its real element size. All memory is released when
+ * the arena is cleared or destroyed
+ */
+class BuilderArena {
+ public:
+  /**
+   * @brief Allocates nbytes of uninitialized host memory
+   */
+  void* Allocate(size_t nbytes);
+
+  /**
+   * @brief Keeps the contiguous CPU tensor t_host alive and returns its data.
+   * borrowed is true if t_host belongs to the model (so holding it costs no
+   * memory) and false if it was copied for the build
+   */
+  const void* Keep(const at::Tensor& t_host, bool borrowed);
+
+  // Releases all memory held, pointers handed out before become invalid
+  void Clear();
+
+  const BuilderArenaStats& stats() const;
+
+ private:
+  void addOwned(size_t nbytes);
+
+  std::vector<std::unique_ptr<uint8_t[]>> allocations_;
+  std::vector<at::Tensor> tensors_;
+  BuilderArenaStats stats_;
+};
+
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
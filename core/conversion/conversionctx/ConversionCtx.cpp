@@ -66,10 +66,11 @@ ConversionCtx::ConversionCtx(BuilderSettings build_settings)
         cfg->setFlag(nvinfer1::BuilderFlag::kFP16);
       }
       input_type = nvinfer1::DataType::kFLOAT;
-      TRTORCH_CHECK(
-          settings.calibrator != nullptr,
-          "Requested inference in INT8 but no calibrator provided, set the ptq_calibrator field in the CompileSpec struct with your calibrator");
-      cfg->setInt8Calibrator(settings.calibrator);
+      if (settings.calibrator != nullptr) {
+        cfg->setInt8Calibrator(settings.calibrator);
+      } else {
+        LOG_DEBUG("No INT8 calibrator provided, dynamic ranges are taken from the quantization ranges in the graph");
+      }
       break;
     case nvinfer1::DataType::kFLOAT:
     default:
@@ -127,9 +128,6 @@ ConversionCtx::~ConversionCtx() {
   builder->destroy();
   net->destroy();
   cfg->destroy();
-  for (auto ptr : builder_resources) {
-    free(ptr);
-  }
 }
 
 nvinfer1::ITensor* ConversionCtx::AssociateValueAndTensor(const torch::jit::Value* value, nvinfer1::ITensor* tensor) {
@@ -144,7 +142,26 @@ torch::jit::IValue* ConversionCtx::AssociateValueAndIValue(const torch::jit::Val
 }
 
 std::string ConversionCtx::SerializeEngine() {
-  auto engine = builder->buildEngineWithConfig(*net, *cfg);
+  auto& dedup_stats = weights_dedup.stats();
+  if (dedup_stats.num_deduplicated > 0) {
+    LOG_INFO(
+        "Deduplicated " << dedup_stats.num_deduplicated << " of " << dedup_stats.num_weights
+                        << " weights, saving " << dedup_stats.bytes_saved << " bytes of host memory");
+  }
+  nvinfer1::ICudaEngine* engine = nullptr;
+  {
+    util::Profiler::Scope scope(profiler, "BuildEngine", "build");
+    engine = builder->buildEngineWithConfig(*net, *cfg);
+  }
+  auto& arena_stats = builder_arena.stats();
+  LOG_INFO(
+      "Host memory held for the engine build peaked at " << arena_stats.peak_owned_bytes << " bytes (plus "
+                                                         << arena_stats.borrowed_bytes
+                                                         << " bytes of weights referenced in place)");
+  // The engine holds its own copy of the weights now
+  builder_arena.Clear();
+  weights_dedup = WeightsDeduplicator();
+  util::Profiler::Scope scope(profiler, "SerializeEngine", "build");
   auto serialized_engine = engine->serialize();
   engine->destroy();
   return std::string((const char*)serialized_engine->data(), serialized_engine->size());
@@ -8,6 +8,10 @@
 #include "torch/csrc/jit/ir/ir.h"
 
 #include <cuda_runtime.h>
+#include "core/conversion/conversionctx/BuilderArena.h"
+#include "core/conversion/conversionctx/WeightsDeduplicator.h"
+#include "core/util/LayerProvenance.h"
+#include "core/util/Profiler.h"
 #include "core/util/prelude.h"
 
 namespace trtorch {
@@ -41,6 +45,12 @@ struct BuilderSettings {
   friend std::ostream& operator<<(std::ostream& os, const BuilderSettings& s);
 };
 
+// Time spent evaluating the nodes of one kind at conversion time
+struct EvaluatorStats {
+  uint64_t num_evaluations = 0;
+  double total_time_ms = 0;
+};
+
 struct ConversionCtx {
   ConversionCtx(BuilderSettings settings);
   std::string SerializeEngine();
@@ -60,15 +70,24 @@ struct ConversionCtx {
   nvinfer1::DataType op_precision;
   BuilderSettings settings;
   util::logging::TRTorchLogger logger;
-  // Pointers to data that needs to remain alive until conversion is done
-  // All data will be freed when the destructor is called
+  // Host memory that needs to remain alive until the engine is built
   // The weights class is the main consumer of this, each time a weight object
-  // is constructed from a PyTorch Tensor it allocates the data here to store a
-  // copy of the values
-  std::vector<void*> builder_resources;
+  // is constructed from a PyTorch Tensor its values are kept here (referencing
+  // the tensor itself if it already is contiguous on the CPU)
+  BuilderArena builder_arena;
+  // Lets weights referenced by several nodes share one copy in builder_arena
+  WeightsDeduplicator weights_dedup;
 
   std::unordered_map<const torch::jit::Value*, nvinfer1::ITensor*> value_tensor_map;
   std::unordered_map<const torch::jit::Value*, torch::jit::IValue> evaluated_value_map;
+  std::unordered_map<torch::jit::NodeKind, EvaluatorStats> evaluator_stats;
+  // Node each named layer of the network was converted from
+  util::LayerProvenance layer_provenance;
+  // Number of nodes whose layers were named after each base name so far
+  std::unordered_map<std::string, uint64_t> layer_name_counts;
+  // Records the time spent in each converter, evaluator and the engine build
+  // when set, owned by the caller
+  util::Profiler* profiler = nullptr;
 };
 
 } // namespace conversion
@@ -0,0 +1,97 @@
+#include <cstring>
+
+#include "ATen/ATen.h"
+
+#include "core/conversion/conversionctx/WeightsDeduplicator.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+
+uint64_t HashTensorContents(const at::Tensor& t_host) {
+  TRTORCH_CHECK(
+      t_host.device().is_cpu() && t_host.is_contiguous(), "Only contiguous CPU tensors can be hashed by content");
+  // FNV-1a over 8 byte words, weights can be gigabytes so going byte by byte
+  // would cost more than the copy deduplication saves
+  constexpr uint64_t kPrime = 0x100000001b3;
+  uint64_t hash = 0xcbf29ce484222325;
+  auto bytes = reinterpret_cast<const uint8_t*>(t_host.data_ptr());
+  size_t nbytes = t_host.nbytes();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= nbytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(uint64_t));
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < nbytes; i++) {
+    hash = (hash ^ bytes[i]) * kPrime;
+  }
+  return (hash ^ nbytes) * kPrime;
+}
+
+const void* WeightsDeduplicator::findByStorage(const at::Tensor& t) {
+  auto entries = storage_map_.find(t.storage().unsafeGetStorageImpl());
+  if (entries == storage_map_.end()) {
+    return nullptr;
+  }
+  for (auto& e : entries->second) {
+    if (e.t.storage_offset() == t.storage_offset() && e.t.sizes() == t.sizes() && e.t.strides() == t.strides() &&
+        e.t.scalar_type() == t.scalar_type()) {
+      return e.buf;
+    }
+  }
+  return nullptr;
+}
+
+const void* WeightsDeduplicator::findByContent(const at::Tensor& t_host, uint64_t hash) {
+  auto entries = content_map_.find(hash);
+  if (entries == content_map_.end()) {
+    return nullptr;
+  }
+  for (auto& e : entries->second) {
+    if (e.dtype == t_host.scalar_type() && e.nbytes == t_host.nbytes() &&
+        memcmp(e.buf, t_host.data_ptr(), e.nbytes) == 0) {
+      return e.buf;
+    }
+  }
+  return nullptr;
+}
+
+void WeightsDeduplicator::recordHit(const at::Tensor& t) {
+  stats_.num_deduplicated++;
+  stats_.bytes_saved += t.nbytes();
+}
+
+const void* WeightsDeduplicator::GetOrMaterialize(const at::Tensor& t, const Materializer& materialize) {
+  stats_.num_weights++;
+  if (auto buf = findByStorage(t)) {
+    recordHit(t);
+    return buf;
+  }
+
+  // At most one host copy is made, none if t already is contiguous on the CPU
+  auto t_host = t;
+  if (!t.device().is_cpu() || !t.is_contiguous()) {
+    t_host = at::empty(t.sizes(), t.options().device(at::kCPU));
+    t_host.copy_(t);
+  }
+  auto hash = HashTensorContents(t_host);
+  auto buf = findByContent(t_host, hash);
+  if (buf) {
+    recordHit(t);
+  } else {
+    buf = materialize(t_host);
+    content_map_[hash].push_back({t_host.scalar_type(), t_host.nbytes(), buf});
+  }
+  storage_map_[t.storage().unsafeGetStorageImpl()].push_back({t, buf});
+  return buf;
+}
+
+const WeightsDedupStats& WeightsDeduplicator::stats() const {
+  return stats_;
+}
+
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "ATen/Tensor.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+
+struct WeightsDedupStats {
+  // Weights requested over the conversion
+  uint64_t num_weights = 0;
+  // Weights served from a buffer materialized for earlier weights
+  uint64_t num_deduplicated = 0;
+  // Host memory not allocated thanks to deduplication
+  uint64_t bytes_saved = 0;
+};
+
+/**
+ * Tracks the host buffers weights were materialized into so that parameters
+ * referenced by several nodes (tied embeddings, shared blocks, constants
+ * duplicated by freezing) are only materialized once. Weights are matched
+ * first by storage (same storage, offset, shape, strides and type) and then by
+ * a hash of their contents confirmed by a full comparison
+ */
+class WeightsDeduplicator {
+ public:
+  using Materializer = std::function<const void*(const at::Tensor& t_host)>;
+
+  /**
+   * @brief Returns a buffer holding the values of t, only calling materialize
+   * with the contiguous CPU copy of t if no identical weights were seen before.
+   * The buffer must stay valid for the lifetime of the deduplicator
+   */
+  const void* GetOrMaterialize(const at::Tensor& t, const Materializer& materialize);
+
+  const WeightsDedupStats& stats() const;
+
+ private:
+  struct StorageEntry {
+    // Held so the storage (and with it the key) cannot be reused by another tensor
+    at::Tensor t;
+    const void* buf;
+  };
+
+  struct ContentEntry {
+    c10::ScalarType dtype;
+    size_t nbytes;
+    const void* buf;
+  };
+
+  const void* findByStorage(const at::Tensor& t);
+  const void* findByContent(const at::Tensor& t_host, uint64_t hash);
+  void recordHit(const at::Tensor& t);
+
+  std::unordered_map<const void*, std::vector<StorageEntry>> storage_map_;
+  std::unordered_map<uint64_t, std::vector<ContentEntry>> content_map_;
+  WeightsDedupStats stats_;
+};
+
+// Hash of the bytes of a contiguous CPU tensor
+uint64_t HashTensorContents(const at::Tensor& t_host);
+
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
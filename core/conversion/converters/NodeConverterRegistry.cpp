@@ -68,6 +68,18 @@ class NodeConverterRegistry {
     return iter->second;
   }
 
+  OpConverter FindConverter(const torch::jit::Node* n) {
+    auto schema = n->maybeSchema();
+    if (!schema) {
+      return nullptr;
+    }
+    auto iter = converter_lut_.find(schema->operator_name());
+    if (iter == converter_lut_.end()) {
+      return nullptr;
+    }
+    return iter->second;
+  }
+
   bool Convertable(const torch::jit::Node* n) {
     auto schema = n->maybeSchema();
     if (schema) {
@@ -120,6 +132,10 @@ OpConverter get_node_converter_for(const torch::jit::FunctionSchema* signature)
   return get_converter_registry().GetConverter(signature);
 }
 
+OpConverter find_node_converter_for(const torch::jit::Node* n) {
+  return get_converter_registry().FindConverter(n);
+}
+
 bool node_is_convertable(const torch::jit::Node* n) {
   return get_converter_registry().Convertable(n);
 }
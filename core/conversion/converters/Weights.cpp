@@ -19,11 +19,10 @@ Weights::Weights(ConversionCtx* ctx, float val) {
   this->num_output_maps = 1;
 
   this->data.type = nvinfer1::DataType::kFLOAT;
-  float* buf = reinterpret_cast<float*>(malloc(1 * sizeof(float)));
+  float* buf = reinterpret_cast<float*>(ctx->builder_arena.Allocate(sizeof(float)));
   buf[0] = val;
   this->data.values = buf;
   this->data.count = 1;
-  ctx->builder_resources.push_back(buf);
 
   this->shape.nbDims = 0;
   this->kernel_shape.nbDims = 0;
@@ -34,11 +33,10 @@ Weights::Weights(ConversionCtx* ctx, int32_t val) {
   this->num_output_maps = 1;
 
   this->data.type = nvinfer1::DataType::kINT32;
-  int32_t* buf = reinterpret_cast<int32_t*>(malloc(1 * sizeof(int32_t)));
+  int32_t* buf = reinterpret_cast<int32_t*>(ctx->builder_arena.Allocate(sizeof(int32_t)));
   buf[0] = val;
   this->data.values = buf;
   this->data.count = 1;
-  ctx->builder_resources.push_back(buf);
 
   this->shape.nbDims = 0;
   this->kernel_shape.nbDims = 0;
@@ -71,21 +69,21 @@ Weights::Weights(ConversionCtx* ctx, at::Tensor t) {
     this->kernel_shape.nbDims = 1;
     this->kernel_shape.d[0] = 1;
   }
-  auto t_cpu = t.to(at::kCPU);
-  t_cpu = t_cpu.contiguous();
-  auto dtype_optional = util::toTRTDataType(t_cpu.dtype());
+  auto dtype_optional = util::toTRTDataType(t.dtype());
   if (!dtype_optional) {
     TRTORCH_THROW_ERROR("The tensor requested to be converted to nvinfer1::Weights is of an unsupported type");
   }
 
-  // Store the data in the conversion context so it remains until building is
-  // complete
-  void* buf = malloc(t_cpu.numel() * sizeof(float));
-  ctx->builder_resources.push_back(buf);
-  memcpy(buf, t_cpu.data_ptr(), t_cpu.numel() * sizeof(float));
+  // Keep the data in the conversion context so it remains until building is
+  // complete, weights seen before in this conversion reuse their copy. The
+  // CPU contiguous version of t is t itself when no copy was needed, in which
+  // case it is only referenced
+  auto buf = ctx->weights_dedup.GetOrMaterialize(t, [ctx, &t](const at::Tensor& t_cpu) {
+    return ctx->builder_arena.Keep(t_cpu, /*borrowed=*/t_cpu.is_same(t));
+  });
 
   this->data.type = dtype_optional.value();
-  this->data.count = t_cpu.numel();
+  this->data.count = t.numel();
   this->data.values = buf;
 
   LOG_DEBUG(*this);
@@ -39,6 +39,8 @@ class RegisterNodeConversionPatterns {
 
 bool node_is_convertable(const torch::jit::Node* n);
 OpConverter get_node_converter_for(const torch::jit::FunctionSchema* signature);
+// Quiet lookup by node, returns nullptr if there is no converter for its schema
+OpConverter find_node_converter_for(const torch::jit::Node* n);
 std::vector<std::string> get_converter_list();
 
 } // namespace converters
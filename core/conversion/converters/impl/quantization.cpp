@@ -0,0 +1,43 @@
+#include "core/conversion/converters/converters.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace conversion {
+namespace converters {
+namespace impl {
+namespace {
+
+auto quantization_registrations TRTORCH_UNUSED = RegisterNodeConversionPatterns().pattern(
+    {"trt::quantize_range(Tensor self, float amax) -> Tensor",
+     [](ConversionCtx* ctx, const torch::jit::Node* n, args& args) -> bool {
+       // Inserted by lowering in place of QAT fake quantization, TensorRT
+       // quantizes the tensor itself in INT8 engines given its dynamic range
+       auto in = args[0].ITensorOrFreeze(ctx);
+       auto amax = static_cast<float>(args[1].unwrapToDouble());
+       TRTORCH_CHECK(amax > 0, "Expected a positive dynamic range for " << *n << " but got " << amax);
+
+       if (ctx->op_precision != nvinfer1::DataType::kINT8) {
+         LOG_DEBUG("Ignoring dynamic range of " << util::node_info(n) << " as the engine is not built for INT8");
+       }
+       TRTORCH_CHECK(in->setDynamicRange(-amax, amax), "Unable to set the dynamic range of " << *n);
+
+       // An identity keeps the output a distinct tensor (the input may be an
+       // input of the network), TensorRT removes it when building the engine
+       auto identity = ctx->net->addIdentity(*in);
+       TRTORCH_CHECK(identity, "Unable to create identity layer from node: " << *n);
+       identity->setName(util::node_info(n).c_str());
+       auto out = identity->getOutput(0);
+       out->setDynamicRange(-amax, amax);
+       out = ctx->AssociateValueAndTensor(n->outputs()[0], out);
+
+       LOG_DEBUG("Dynamic range of " << out->getName() << ": [" << -amax << ", " << amax << "]");
+       return true;
+     }});
+
+} // namespace
+} // namespace impl
+} // namespace converters
+} // namespace conversion
+} // namespace core
+} // namespace trtorch
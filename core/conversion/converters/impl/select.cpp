@@ -17,6 +17,9 @@ namespace {
 bool add_split(ConversionCtx* ctx, const torch::jit::Node* n, args& args, bool split_list) {
   auto in = args[0].ITensor();
   auto axis = args[2].unwrapToInt();
+  if (axis < 0) {
+    axis += in->getDimensions().nbDims;
+  }
   auto inDimSize = in->getDimensions().d[axis];
   auto numOutputs = 1;
   std::vector<int64_t> sizes;
@@ -73,6 +73,8 @@ struct EvalRegistration {
 };
 
 c10::optional<torch::jit::IValue> EvalNode(const torch::jit::Node* n, kwargs& args);
+// Returns nullptr if the node cannot be evaluated at conversion time
+NodeEvaluator getEvaluatorFor(const torch::jit::Node* n);
 bool shouldEvalAtConversionTime(const torch::jit::Node* n);
 std::vector<std::string> getEvaluatorList();
 void register_node_evaluator(torch::jit::NodeKind node_kind, NodeEvaluator evaluator);
@@ -1,16 +1,18 @@
+#include <mutex>
+
 #include "torch/csrc/jit/passes/common_subexpression_elimination.h"
 #include "torch/csrc/jit/passes/create_functional_graphs.h"
 #include "torch/csrc/jit/passes/dead_code_elimination.h"
 #include "torch/csrc/jit/passes/freeze_module.h"
 #include "torch/csrc/jit/passes/fuse_linear.h"
 #include "torch/csrc/jit/passes/guard_elimination.h"
-#include "torch/csrc/jit/passes/loop_unrolling.h"
 #include "torch/csrc/jit/passes/lower_graph.h"
 #include "torch/csrc/jit/passes/lower_tuples.h"
 #include "torch/csrc/jit/passes/peephole.h"
 #include "torch/csrc/jit/passes/remove_mutation.h"
 
 #include "core/lowering/lowering.h"
+#include "core/lowering/pass_manager.h"
 #include "core/lowering/passes/passes.h"
 #include "core/util/prelude.h"
 
@@ -24,54 +26,103 @@ void LowerBlock(torch::jit::Block* b) {
   DropUnusedNodes(b);
 }
 
-void LowerGraph(std::shared_ptr<torch::jit::Graph>& g) {
-  torch::jit::EliminateRedundantGuards(g);
-  torch::jit::RemoveListMutation(g);
-  torch::jit::RemoveTensorMutation(g);
-  torch::jit::CreateFunctionalGraphs(g);
-  torch::jit::InlineFunctionalGraphs(g);
-  torch::jit::PeepholeOptimize(g, false);
-  passes::EliminateExceptionOrPassPattern(g);
-  torch::jit::FuseLinear(g);
-  torch::jit::LowerAllTuples(g);
-  passes::RemoveContiguous(g);
-  passes::RemoveDropout(g);
-  passes::FuseFlattenLinear(g);
-  passes::Conv2DToConvolution(g);
-  passes::Conv3DToConvolution(g);
-  passes::FuseAddMMBranches(g);
-  passes::RemoveBNDimCheck(g);
-  torch::jit::EliminateCommonSubexpression(g);
-  // torch::jit::UnrollLoops(g);
-  torch::jit::EliminateCommonSubexpression(g);
-  passes::UnpackAddMM(g);
-  // passes::UnpackBatchNorm(g);
-  passes::UnpackLogSoftmax(g);
-  passes::RemoveNOPs(g);
-  passes::AliasOperators(g);
-  passes::SiluToSigmoidMultipication(g);
-  torch::jit::EliminateDeadCode(g);
+namespace {
+PassManager BuildLoweringPasses(const LowerInfo& lower_info) {
+  using torch::jit::Graph;
+  PassManager pm;
+  // Shape queries answered by the input ranges are folded first so the
+  // branches they decide are gone before anything else looks at the graph
+  auto input_shapes = lower_info.input_shapes;
+  auto input_dtype = lower_info.input_dtype;
+  auto input_device = lower_info.input_device;
+  pm.AddPass("PropagateStaticShapes", [input_shapes, input_dtype, input_device](std::shared_ptr<Graph>& g) {
+    if (!input_shapes.empty()) {
+      passes::PropagateStaticShapes(g, input_shapes, input_dtype, input_device);
+    }
+  });
+  pm.AddPass("EliminateRedundantGuards", [](std::shared_ptr<Graph>& g) { torch::jit::EliminateRedundantGuards(g); })
+      .AddPass("RemoveListMutation", [](std::shared_ptr<Graph>& g) { torch::jit::RemoveListMutation(g); })
+      .AddPass("RemoveTensorMutation", [](std::shared_ptr<Graph>& g) { torch::jit::RemoveTensorMutation(g); })
+      .AddPass("CreateFunctionalGraphs", [](std::shared_ptr<Graph>& g) { torch::jit::CreateFunctionalGraphs(g); })
+      .AddPass("InlineFunctionalGraphs", [](std::shared_ptr<Graph>& g) { torch::jit::InlineFunctionalGraphs(g); })
+      .AddPass("PeepholeOptimize", [](std::shared_ptr<Graph>& g) { torch::jit::PeepholeOptimize(g, false); })
+      .AddPass("EliminateExceptionOrPassPattern", passes::EliminateExceptionOrPassPattern)
+      .AddPass("FuseLinear", [](std::shared_ptr<Graph>& g) { torch::jit::FuseLinear(g); })
+      .AddPass("LowerAllTuples", [](std::shared_ptr<Graph>& g) { torch::jit::LowerAllTuples(g); })
+      .AddPass("RemoveContiguous", passes::RemoveContiguous)
+      .AddPass("RemoveDropout", passes::RemoveDropout)
+      .AddPass("FuseFlattenLinear", passes::FuseFlattenLinear)
+      .AddPass("Conv2DToConvolution", passes::Conv2DToConvolution)
+      .AddPass("Conv3DToConvolution", passes::Conv3DToConvolution)
+      .AddPass("FuseAddMMBranches", passes::FuseAddMMBranches)
+      .AddPass("RemoveBNDimCheck", passes::RemoveBNDimCheck)
+      // Runs while fake quantized weights are still recognizable so it can
+      // leave them alone
+      .AddPass("FoldConvBatchNorm", passes::FoldConvBatchNorm)
+      .AddPass("LowerFakeQuantization", passes::LowerFakeQuantization)
+      .AddPass(
+          "EliminateCommonSubexpression",
+          [](std::shared_ptr<Graph>& g) { torch::jit::EliminateCommonSubexpression(g); })
+      .AddPass(
+          "UnrollConstantLoops",
+          [max_trip_count = lower_info.max_unrolled_loop_trip_count](std::shared_ptr<Graph>& g) {
+            passes::UnrollConstantLoops(g, max_trip_count);
+          })
+      .AddPass("UnpackAddMM", passes::UnpackAddMM)
+      .AddPass("UnpackBatchNorm", passes::UnpackBatchNorm, /*enabled_by_default=*/false)
+      .AddPass("UnpackLogSoftmax", passes::UnpackLogSoftmax)
+      .AddPass("RemoveNOPs", passes::RemoveNOPs)
+      .AddPass("AliasOperators", passes::AliasOperators)
+      .AddPass("SiluToSigmoidMultipication", passes::SiluToSigmoidMultipication)
+      // Canonicalizing shuffles of constants lets them be folded, and folding
+      // exposes new chains of shuffles over the folded constants
+      .AddFixpointGroup(
+          "SimplifyConstantsAndShuffles",
+          {{"FoldParameterSubgraphs", [](std::shared_ptr<Graph>& g) { passes::FoldParameterSubgraphs(g); }},
+           {"CanonicalizeShuffles", passes::CanonicalizeShuffles}})
+      .AddPass("FuseSiblingLinears", [](std::shared_ptr<Graph>& g) { passes::FuseSiblingLinears(g); })
+      .AddPass("FuseSiblingConvolutions", passes::FuseSiblingConvolutions)
+      .AddPass("EliminateDeadCode", [](std::shared_ptr<Graph>& g) { torch::jit::EliminateDeadCode(g); });
+  return pm;
+}
+} // namespace
+
+void LowerGraph(std::shared_ptr<torch::jit::Graph>& g, const LowerInfo& lower_info) {
+  auto pm = BuildLoweringPasses(lower_info);
+  pm.set_profiler(lower_info.profiler.get());
+  pm.Run(g, lower_info.enabled_passes, lower_info.disabled_passes);
   LOG_GRAPH(*g);
+  LOG_DEBUG("Lowering pass statistics:\n" << pm.FormatStats());
 }
 
 torch::jit::Module LowerModule(const torch::jit::script::Module& mod) {
+  // Freezing clones the module which registers new class types in the
+  // compilation unit shared with the source module, this is not thread safe
+  // so methods being lowered concurrently take turns here
+  static std::mutex freeze_mutex;
+  std::lock_guard<std::mutex> lock(freeze_mutex);
   auto mod_ = torch::jit::freeze_module(mod);
   return mod_;
 }
 
 std::pair<std::shared_ptr<torch::jit::Graph>, std::vector<torch::jit::IValue>> Lower(
     const torch::jit::script::Module& mod,
-    std::string method_name) {
-  auto lowered_mod = LowerModule(mod);
+    std::string method_name,
+    const LowerInfo& lower_info) {
+  auto profiler = lower_info.profiler.get();
+  auto lowered_mod = [&]() {
+    util::Profiler::Scope scope(profiler, "FreezeModule", "lowering");
+    return LowerModule(mod);
+  }();
   auto g = lowered_mod.get_method(method_name).graph();
   LOG_GRAPH(*g);
 
   // Go through TRTorch Lowering to reformat graph to be conversion friendly
   // and also segment for accelerators and executors (TRT-DLA, TRT-GPU, PYT)
   LOG_GRAPH("TRTorch Graph Lowering");
-  lowering::LowerGraph(g);
-  //=[torch::jit::FoldConvBatchNorm2d(lowered_mod);
+  lowering::LowerGraph(g, lower_info);
   LOG_GRAPH("LibTorch Lowering");
+  util::Profiler::Scope scope(profiler, "LibTorchLowerGraph", "lowering");
   auto graph_and_ivalues = torch::jit::LowerGraph(*g, lowered_mod._ivalue());
   // Is this necessary?
   lowering::LowerBlock(g->block());
@@ -1,17 +1,40 @@
 #pragma once
 #include <memory>
+#include <string>
+#include <vector>
 #include "torch/csrc/jit/ir/ir.h"
 
+#include "core/util/Profiler.h"
+
 namespace trtorch {
 namespace core {
 namespace lowering {
 
+struct LowerInfo {
+  // Shapes of the tensor inputs of the method as far as they are known at
+  // compile time, dims that vary at runtime are -1. Empty if unknown
+  std::vector<std::vector<int64_t>> input_shapes;
+  // Type and device of the tensor inputs at runtime
+  at::ScalarType input_dtype = at::kFloat;
+  at::Device input_device = at::Device(at::kCUDA, 0);
+  // Loops with a constant trip count are unrolled as long as the trips of the
+  // loop nest multiplied out are at most this
+  int64_t max_unrolled_loop_trip_count = 32;
+  // Lowering passes which are off by default to run anyway
+  std::vector<std::string> enabled_passes;
+  // Lowering passes (or fixpoint groups) to skip
+  std::vector<std::string> disabled_passes;
+  // Records the time spent in each pass when set
+  std::shared_ptr<util::Profiler> profiler;
+};
+
 void LowerBlock(torch::jit::Block* b);
-void LowerGraph(std::shared_ptr<torch::jit::Graph>& g);
+void LowerGraph(std::shared_ptr<torch::jit::Graph>& g, const LowerInfo& lower_info = LowerInfo());
 torch::jit::Module LowerModule(const torch::jit::script::Module& mod);
 std::pair<std::shared_ptr<torch::jit::Graph>, std::vector<torch::jit::IValue>> Lower(
     const torch::jit::script::Module& mod,
-    std::string method_name);
+    std::string method_name,
+    const LowerInfo& lower_info = LowerInfo());
 
 } // namespace lowering
 } // namespace core
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+#include "core/lowering/pass_manager.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace {
+
+int64_t CountNodes(torch::jit::Block* b) {
+  int64_t count = 0;
+  for (auto n : b->nodes()) {
+    count++;
+    for (auto sub_block : n->blocks()) {
+      count += CountNodes(sub_block);
+    }
+  }
+  return count;
+}
+
+bool Contains(const std::vector<std::string>& names, const std::string& name) {
+  return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+} // namespace
+
+PassManager& PassManager::AddPass(std::string name, LoweringPass pass, bool enabled_by_default) {
+  TRTORCH_CHECK(!Contains(pass_names(), name), "Lowering pass " << name << " was added twice");
+  Entry e;
+  e.name = std::move(name);
+  e.pass = std::move(pass);
+  e.enabled_by_default = enabled_by_default;
+  entries_.push_back(std::move(e));
+  return *this;
+}
+
+PassManager& PassManager::AddFixpointGroup(
+    std::string name,
+    std::vector<std::pair<std::string, LoweringPass>> passes,
+    uint64_t max_rounds) {
+  TRTORCH_CHECK(max_rounds > 0, "Fixpoint group " << name << " needs to run at least one round");
+  TRTORCH_CHECK(!Contains(pass_names(), name), "Lowering pass " << name << " was added twice");
+  Entry e;
+  e.name = std::move(name);
+  e.max_rounds = max_rounds;
+  for (auto& p : passes) {
+    TRTORCH_CHECK(!Contains(pass_names(), p.first), "Lowering pass " << p.first << " was added twice");
+    Entry member;
+    member.name = std::move(p.first);
+    member.pass = std::move(p.second);
+    e.group.push_back(std::move(member));
+  }
+  entries_.push_back(std::move(e));
+  return *this;
+}
+
+std::vector<std::string> PassManager::pass_names() const {
+  std::vector<std::string> names;
+  for (auto& e : entries_) {
+    names.push_back(e.name);
+    for (auto& member : e.group) {
+      names.push_back(member.name);
+    }
+  }
+  return names;
+}
+
+const std::vector<PassStats>& PassManager::stats() const {
+  return stats_;
+}
+
+bool PassManager::isEnabled(
+    const Entry& e,
+    const std::vector<std::string>& enabled,
+    const std::vector<std::string>& disabled) const {
+  if (Contains(disabled, e.name)) {
+    return false;
+  }
+  return e.enabled_by_default || Contains(enabled, e.name);
+}
+
+void PassManager::runPass(const Entry& e, std::shared_ptr<torch::jit::Graph>& g) {
+  auto stats = std::find_if(stats_.begin(), stats_.end(), [&](const PassStats& s) { return s.name == e.name; });
+  if (stats == stats_.end()) {
+    PassStats s;
+    s.name = e.name;
+    stats = stats_.insert(stats_.end(), s);
+  }
+
+  auto nodes_before = CountNodes(g->block());
+  auto start = std::chrono::steady_clock::now();
+  e.pass(g);
+  auto end = std::chrono::steady_clock::now();
+  auto nodes_after = CountNodes(g->block());
+
+  stats->num_runs++;
+  stats->total_time_ms += std::chrono::duration<double, std::milli>(end - start).count();
+  stats->node_delta += nodes_after - nodes_before;
+  if (profiler_) {
+    profiler_->Record(e.name, "lowering", start, end);
+  }
+  LOG_GRAPH("Post " << e.name << ": " << *g);
+}
+
+void PassManager::runGroup(
+    const Entry& group,
+    std::shared_ptr<torch::jit::Graph>& g,
+    const std::vector<std::string>& enabled,
+    const std::vector<std::string>& disabled) {
+  auto before = g->toString();
+  for (uint64_t round = 1; round <= group.max_rounds; round++) {
+    for (auto& member : group.group) {
+      if (isEnabled(member, enabled, disabled)) {
+        runPass(member, g);
+      }
+    }
+    auto after = g->toString();
+    if (after == before) {
+      LOG_DEBUG("[Lowering Pass Manager]: " << group.name << " reached a fixpoint after " << round << " rounds");
+      return;
+    }
+    before = std::move(after);
+  }
+  LOG_DEBUG(
+      "[Lowering Pass Manager]: " << group.name << " stopped after " << group.max_rounds
+                                  << " rounds without reaching a fixpoint");
+}
+
+void PassManager::Run(
+    std::shared_ptr<torch::jit::Graph>& g,
+    const std::vector<std::string>& enabled,
+    const std::vector<std::string>& disabled) {
+  auto known = pass_names();
+  for (auto& names : {enabled, disabled}) {
+    for (auto& name : names) {
+      if (!Contains(known, name)) {
+        std::stringstream known_names;
+        for (auto& k : known) {
+          known_names << ' ' << k;
+        }
+        TRTORCH_THROW_ERROR("Unknown lowering pass " << name << ", known passes are:" << known_names.str());
+      }
+    }
+  }
+
+  stats_.clear();
+  for (auto& e : entries_) {
+    if (!isEnabled(e, enabled, disabled)) {
+      LOG_DEBUG("[Lowering Pass Manager]: Skipping disabled pass " << e.name);
+      continue;
+    }
+    if (e.group.empty()) {
+      runPass(e, g);
+    } else {
+      runGroup(e, g, enabled, disabled);
+    }
+  }
+}
+
+std::string PassManager::FormatStats() const {
+  size_t name_width = 4;
+  for (auto& s : stats_) {
+    name_width = std::max(name_width, s.name.size());
+  }
+
+  std::stringstream ss;
+  ss << std::left << std::setw(name_width) << "Pass" << std::right << std::setw(8) << "Runs" << std::setw(14)
+     << "Time (ms)" << std::setw(14) << "Node Delta" << std::endl;
+  double total_time_ms = 0;
+  int64_t total_delta = 0;
+  for (auto& s : stats_) {
+    ss << std::left << std::setw(name_width) << s.name << std::right << std::setw(8) << s.num_runs << std::setw(14)
+       << std::fixed << std::setprecision(3) << s.total_time_ms << std::setw(14) << s.node_delta << std::endl;
+    total_time_ms += s.total_time_ms;
+    total_delta += s.node_delta;
+  }
+  ss << std::left << std::setw(name_width) << "Total" << std::right << std::setw(8) << "" << std::setw(14)
+     << std::fixed << std::setprecision(3) << total_time_ms << std::setw(14) << total_delta << std::endl;
+  return ss.str();
+}
+
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,91 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "torch/csrc/jit/ir/ir.h"
+
+#include "core/util/Profiler.h"
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+
+using LoweringPass = std::function<void(std::shared_ptr<torch::jit::Graph>&)>;
+
+struct PassStats {
+  std::string name;
+  uint64_t num_runs = 0;
+  double total_time_ms = 0;
+  // Nodes added (positive) or removed (negative) summed over all runs
+  int64_t node_delta = 0;
+};
+
+class PassManager {
+ public:
+  /**
+   * @brief Appends a pass, passes off by default only run if they are named
+   * in the enabled list given to Run
+   */
+  PassManager& AddPass(std::string name, LoweringPass pass, bool enabled_by_default = true);
+
+  /**
+   * @brief Appends a group of passes which is run in order, over and over,
+   * until a whole round leaves the graph unchanged or max_rounds is reached.
+   * Disabling the group by name disables all of its passes
+   */
+  PassManager& AddFixpointGroup(
+      std::string name,
+      std::vector<std::pair<std::string, LoweringPass>> passes,
+      uint64_t max_rounds = 4);
+
+  /**
+   * @brief Runs the passes in the order they were added. Names in enabled and
+   * disabled must be known to the manager, disabling wins over enabling
+   */
+  void Run(
+      std::shared_ptr<torch::jit::Graph>& g,
+      const std::vector<std::string>& enabled = {},
+      const std::vector<std::string>& disabled = {});
+
+  // Names of all passes and groups, in order
+  std::vector<std::string> pass_names() const;
+
+  // Statistics of the passes that ran in the last call to Run, in order
+  const std::vector<PassStats>& stats() const;
+
+  // Table of stats(), one line per pass
+  std::string FormatStats() const;
+
+  // Every run of a pass is also recorded in the profiler if one is set
+  void set_profiler(util::Profiler* profiler) {
+    profiler_ = profiler;
+  }
+
+ private:
+  struct Entry {
+    std::string name;
+    LoweringPass pass;
+    bool enabled_by_default = true;
+    // Set for groups, in which case pass is unused
+    std::vector<Entry> group;
+    uint64_t max_rounds = 1;
+  };
+
+  bool isEnabled(const Entry& e, const std::vector<std::string>& enabled, const std::vector<std::string>& disabled)
+      const;
+  void runPass(const Entry& e, std::shared_ptr<torch::jit::Graph>& g);
+  void runGroup(
+      const Entry& group,
+      std::shared_ptr<torch::jit::Graph>& g,
+      const std::vector<std::string>& enabled,
+      const std::vector<std::string>& disabled);
+
+  std::vector<Entry> entries_;
+  std::vector<PassStats> stats_;
+  util::Profiler* profiler_ = nullptr;
+};
+
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,263 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+struct ShuffleCanonicalization {
+  ShuffleCanonicalization(std::shared_ptr<Graph> graph) : graph_(std::move(graph)) {}
+
+  void run() {
+    canonicalizeBlock(graph_->block());
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG(
+        "[Lowering Shuffles]: Removed " << num_identities_ << " identity permutations, composed " << num_composed_
+                                       << " permutations and collapsed " << num_collapsed_ << " reshapes");
+    LOG_GRAPH("Post canonicalize shuffles: " << *graph_);
+  }
+
+ private:
+  bool isPermutation(Node* n) {
+    return n->kind() == aten::permute || n->kind() == aten::transpose;
+  }
+
+  bool isReshape(Node* n) {
+    return n->kind() == aten::view || n->kind() == aten::reshape;
+  }
+
+  // Ops that only change the shape of their input without moving elements
+  bool changesShapeOnly(Node* n) {
+    return isReshape(n) || n->kind() == aten::flatten || n->kind() == aten::squeeze || n->kind() == aten::unsqueeze;
+  }
+
+  bool hasSingleUse(Node* n) {
+    return n->outputs().size() == 1 && n->output()->uses().size() == 1;
+  }
+
+  c10::optional<std::vector<int64_t>> constantIntList(Value* v) {
+    auto ivalue = toIValue(v);
+    if (!ivalue || !ivalue->isIntList()) {
+      return {};
+    }
+    return ivalue->toIntVector();
+  }
+
+  c10::optional<int64_t> constantInt(Value* v) {
+    auto ivalue = toIValue(v);
+    if (!ivalue || !ivalue->isInt()) {
+      return {};
+    }
+    return ivalue->toInt();
+  }
+
+  /// The permutation applied by n as dims into its input, given the rank of
+  /// its input if known (aten::transpose does not carry it):
+  ///   %y = aten::permute(%x, %dims)
+  ///   %y = aten::transpose(%x, %dim0, %dim1)
+  c10::optional<std::vector<int64_t>> permutation(Node* n, c10::optional<int64_t> rank) {
+    std::vector<int64_t> dims;
+    if (n->kind() == aten::permute) {
+      auto list = constantIntList(n->input(1));
+      if (!list) {
+        return {};
+      }
+      dims = *list;
+      if (rank && static_cast<int64_t>(dims.size()) != *rank) {
+        return {};
+      }
+    } else {
+      auto dim0 = constantInt(n->input(1));
+      auto dim1 = constantInt(n->input(2));
+      if (!rank || !dim0 || !dim1) {
+        return {};
+      }
+      for (int64_t i = 0; i < *rank; i++) {
+        dims.push_back(i);
+      }
+      auto a = *dim0 < 0 ? *dim0 + *rank : *dim0;
+      auto b = *dim1 < 0 ? *dim1 + *rank : *dim1;
+      if (a < 0 || a >= *rank || b < 0 || b >= *rank) {
+        return {};
+      }
+      std::swap(dims[a], dims[b]);
+    }
+
+    auto size = static_cast<int64_t>(dims.size());
+    for (auto& d : dims) {
+      d = d < 0 ? d + size : d;
+      if (d < 0 || d >= size) {
+        return {};
+      }
+    }
+    return dims;
+  }
+
+  // Rank of the input of a permutation, only permute carries it
+  c10::optional<int64_t> rankOf(Node* n) {
+    if (n->kind() == aten::permute) {
+      auto list = constantIntList(n->input(1));
+      if (list) {
+        return static_cast<int64_t>(list->size());
+      }
+    }
+    return {};
+  }
+
+  bool isIdentity(Node* n) {
+    if (n->kind() == aten::transpose) {
+      auto dim0 = constantInt(n->input(1));
+      auto dim1 = constantInt(n->input(2));
+      return dim0 && dim1 && *dim0 == *dim1;
+    }
+    auto dims = permutation(n, {});
+    if (!dims) {
+      return false;
+    }
+    for (size_t i = 0; i < dims->size(); i++) {
+      if ((*dims)[i] != static_cast<int64_t>(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // transpose(transpose(x, a, b), a, b) is the identity even when the rank is
+  // unknown, as long as both name the dims the same way
+  bool areInverseTransposes(Node* producer, Node* n) {
+    if (producer->kind() != aten::transpose || n->kind() != aten::transpose) {
+      return false;
+    }
+    auto a0 = constantInt(producer->input(1));
+    auto a1 = constantInt(producer->input(2));
+    auto b0 = constantInt(n->input(1));
+    auto b1 = constantInt(n->input(2));
+    if (!a0 || !a1 || !b0 || !b1) {
+      return false;
+    }
+    return (*a0 == *b0 && *a1 == *b1) || (*a0 == *b1 && *a1 == *b0);
+  }
+
+  bool tryRemoveIdentity(Node* n) {
+    if (!isIdentity(n)) {
+      return false;
+    }
+    LOG_GRAPH("Removing identity permutation " << *n);
+    n->output()->replaceAllUsesWith(n->input(0));
+    n->destroy();
+    num_identities_++;
+    return true;
+  }
+
+  /// %y = permute(%x, p1), %z = permute(%y, p2)  =>  %z = permute(%x, p) with p[i] = p1[p2[i]]
+  bool tryComposePermutations(Node* n) {
+    auto producer = n->input(0)->node();
+    if (!isPermutation(producer) || !hasSingleUse(producer)) {
+      return false;
+    }
+    auto x = producer->input(0);
+    if (areInverseTransposes(producer, n)) {
+      LOG_GRAPH("Removing inverse transposes " << *producer << " and " << *n);
+      n->output()->replaceAllUsesWith(x);
+      n->destroy();
+      producer->destroy();
+      num_identities_ += 2;
+      return true;
+    }
+
+    auto rank = rankOf(producer);
+    if (!rank) {
+      rank = rankOf(n);
+    }
+    auto first = permutation(producer, rank);
+    auto second = permutation(n, rank);
+    if (!first || !second || first->size() != second->size()) {
+      return false;
+    }
+
+    std::vector<int64_t> dims;
+    bool identity = true;
+    for (size_t i = 0; i < second->size(); i++) {
+      dims.push_back((*first)[(*second)[i]]);
+      identity &= dims.back() == static_cast<int64_t>(i);
+    }
+
+    LOG_GRAPH("Composing " << *producer << " and " << *n);
+    if (identity) {
+      n->output()->replaceAllUsesWith(x);
+      num_identities_++;
+    } else {
+      WithInsertPoint guard(n);
+      auto composed = graph_->insertNode(graph_->create(aten::permute, {x, graph_->insertConstant(dims)}));
+      composed->output()->setType(n->output()->type());
+      n->output()->replaceAllUsesWith(composed->output());
+      num_composed_++;
+    }
+    n->destroy();
+    producer->destroy();
+    return true;
+  }
+
+  /// %y = view(%x, s1), %z = reshape(%y, s2)  =>  %z = reshape(%x, s2)
+  /// Only the last reshape of a chain decides the final shape. A view is kept
+  /// a view (reshape does not support dynamic shapes in conversion) so it only
+  /// absorbs ops that are views themselves, which keeps it valid in PyTorch
+  bool tryCollapseReshapes(Node* n) {
+    auto producer = n->input(0)->node();
+    if (!changesShapeOnly(producer) || !hasSingleUse(producer)) {
+      return false;
+    }
+    if (n->kind() == aten::view && (producer->kind() == aten::reshape || producer->kind() == aten::flatten)) {
+      return false;
+    }
+    LOG_GRAPH("Collapsing " << *producer << " into " << *n);
+    n->replaceInput(0, producer->input(0));
+    producer->destroy();
+    num_collapsed_++;
+    return true;
+  }
+
+  void canonicalizeBlock(Block* b) {
+    for (auto it = b->nodes().begin(); it != b->nodes().end();) {
+      auto n = *it;
+      // Rewrites only ever remove n and nodes before it or insert nodes
+      // right before it
+      ++it;
+      for (auto sub_block : n->blocks()) {
+        canonicalizeBlock(sub_block);
+      }
+
+      if (isPermutation(n)) {
+        if (!tryRemoveIdentity(n)) {
+          tryComposePermutations(n);
+        }
+      } else if (isReshape(n)) {
+        while (tryCollapseReshapes(n)) {
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  size_t num_identities_ = 0;
+  size_t num_composed_ = 0;
+  size_t num_collapsed_ = 0;
+};
+} // namespace
+
+void CanonicalizeShuffles(std::shared_ptr<torch::jit::Graph>& graph) {
+  ShuffleCanonicalization canonicalization(graph);
+  canonicalization.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,195 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+struct ConvBatchNormFolding {
+  ConvBatchNormFolding(std::shared_ptr<Graph> graph) : graph_(std::move(graph)) {}
+
+  void run() {
+    std::vector<Node*> batch_norms;
+    findBatchNormNodes(graph_->block(), batch_norms);
+
+    size_t num_folded = 0;
+    for (auto bn : batch_norms) {
+      if (tryFold(bn)) {
+        num_folded++;
+      }
+    }
+    // Drops the original weight constants if nothing else used them
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG("[Lowering Batch Norm]: Folded " << num_folded << " of " << batch_norms.size() << " batch norms");
+    LOG_GRAPH("Post fold conv batch norm: " << *graph_);
+  }
+
+ private:
+  void findBatchNormNodes(Block* b, std::vector<Node*>& batch_norms) {
+    for (auto n : b->nodes()) {
+      if (n->kind() == aten::batch_norm) {
+        batch_norms.push_back(n);
+      }
+      for (auto sub_block : n->blocks()) {
+        findBatchNormNodes(sub_block, batch_norms);
+      }
+    }
+  }
+
+  bool isConvolution(const Node* n) {
+    switch (n->kind()) {
+      case aten::_convolution:
+      case aten::conv1d:
+      case aten::conv2d:
+      case aten::conv3d:
+      case aten::conv_transpose1d:
+      case aten::conv_transpose2d:
+      case aten::conv_transpose3d:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Returns the tensor held by a constant input, an undefined tensor for None
+  // and nullopt if the input is not known until runtime
+  c10::optional<at::Tensor> constantTensor(Value* v) {
+    auto ivalue = toIValue(v);
+    if (!ivalue) {
+      return {};
+    }
+    if (ivalue->isNone()) {
+      return at::Tensor();
+    }
+    if (!ivalue->isTensor()) {
+      return {};
+    }
+    return ivalue->toTensor();
+  }
+
+  bool tryFold(Node* bn) {
+    auto conv = bn->input(0)->node();
+    if (!isConvolution(conv)) {
+      return false;
+    }
+    if (conv->output()->uses().size() != 1) {
+      // Something other than the batch norm reads the convolution output,
+      // folding would change what it sees
+      LOG_GRAPH("Not folding " << *bn << " as the preceding convolution has other consumers");
+      return false;
+    }
+
+    /// Only frozen statistics can be folded:
+    /// %y = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %training=0, %momentum, %eps, %cudnn)
+    auto training = toIValue(bn->input(5));
+    auto eps = toIValue(bn->input(7));
+    auto gamma = constantTensor(bn->input(1));
+    auto beta = constantTensor(bn->input(2));
+    auto mean = constantTensor(bn->input(3));
+    auto var = constantTensor(bn->input(4));
+    if (!training || !training->isBool() || training->toBool() || !eps || !eps->isDouble() || !gamma || !beta ||
+        !mean || !var || !mean->defined() || !var->defined()) {
+      LOG_GRAPH("Not folding " << *bn << " as its statistics are not frozen");
+      return false;
+    }
+
+    // aten::_convolution carries transposed and groups as inputs 6 and 8, the
+    // aten::conv* ops take groups as input 6
+    bool transposed = false;
+    c10::optional<IValue> groups;
+    if (conv->kind() == aten::_convolution) {
+      auto transposed_ivalue = toIValue(conv->input(6));
+      if (!transposed_ivalue || !transposed_ivalue->isBool()) {
+        return false;
+      }
+      transposed = transposed_ivalue->toBool();
+      groups = toIValue(conv->input(8));
+    } else {
+      transposed = conv->kind() == aten::conv_transpose1d || conv->kind() == aten::conv_transpose2d ||
+          conv->kind() == aten::conv_transpose3d;
+      groups = toIValue(conv->input(6));
+    }
+    auto weight_producer = conv->input(1)->node()->kind();
+    if (weight_producer == aten::fake_quantize_per_tensor_affine ||
+        weight_producer == aten::fake_quantize_per_channel_affine) {
+      // Scaling quantized weights moves them off the INT8 grid they were
+      // trained on, the batch norm has to stay
+      LOG_GRAPH("Not folding " << *bn << " as the preceding convolution's weights are fake quantized");
+      return false;
+    }
+    auto weight = constantTensor(conv->input(1));
+    auto bias = constantTensor(conv->input(2));
+    if (!groups || !groups->isInt() || !weight || !weight->defined() || !bias) {
+      LOG_GRAPH("Not folding " << *bn << " as the preceding convolution's weights are not constant");
+      return false;
+    }
+
+    auto num_groups = groups->toInt();
+    auto out_channels = mean->numel();
+    auto& w = *weight;
+    auto weight_out_channels = transposed ? w.size(1) * num_groups : w.size(0);
+    if (w.dim() < 3 || weight_out_channels != out_channels || var->numel() != out_channels ||
+        (gamma->defined() && gamma->numel() != out_channels) || (beta->defined() && beta->numel() != out_channels)) {
+      LOG_GRAPH("Not folding " << *bn << " as its channels do not match the preceding convolution");
+      return false;
+    }
+
+    // The fused weights are new constants, the originals may be shared with
+    // other convolutions (through constant pooling or a reused module) which
+    // must keep seeing the unscaled values
+    at::NoGradGuard no_grad;
+    auto opts = w.options();
+    auto bn_w = gamma->defined() ? gamma->to(opts) : at::ones({out_channels}, opts);
+    auto bn_b = beta->defined() ? beta->to(opts) : at::zeros({out_channels}, opts);
+    auto bn_rm = mean->to(opts);
+    auto bn_var_rsqrt = at::rsqrt(var->to(opts) + eps->toDouble());
+    auto conv_b = bias->defined() ? bias->to(opts) : at::zeros({out_channels}, opts);
+    auto scale = bn_w * bn_var_rsqrt;
+
+    at::Tensor fused_w;
+    if (transposed) {
+      // Transposed weights are laid out [in, out / groups, k...], so the
+      // output channels are split across groups along dims 0 and 1
+      std::vector<int64_t> grouped_shape = {num_groups, w.size(0) / num_groups};
+      std::vector<int64_t> scale_shape = {num_groups, 1};
+      for (int64_t d = 1; d < w.dim(); d++) {
+        grouped_shape.push_back(w.size(d));
+        scale_shape.push_back(d == 1 ? w.size(1) : 1);
+      }
+      fused_w = (w.reshape(grouped_shape) * scale.reshape(scale_shape)).reshape(w.sizes());
+    } else {
+      std::vector<int64_t> scale_shape(w.dim(), 1);
+      scale_shape[0] = -1;
+      fused_w = w * scale.reshape(scale_shape);
+    }
+    auto fused_b = (conv_b - bn_rm) * bn_var_rsqrt * bn_w + bn_b;
+
+    WithInsertPoint guard(conv);
+    conv->replaceInput(1, graph_->insertConstant(fused_w.detach()));
+    conv->replaceInput(2, graph_->insertConstant(fused_b.detach()));
+    bn->output()->replaceAllUsesWith(conv->output());
+    LOG_GRAPH("Folded " << *bn << " into " << *conv);
+    bn->destroy();
+    return true;
+  }
+
+  std::shared_ptr<Graph> graph_;
+};
+} // namespace
+
+void FoldConvBatchNorm(std::shared_ptr<torch::jit::Graph>& graph) {
+  ConvBatchNormFolding folding(graph);
+  folding.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
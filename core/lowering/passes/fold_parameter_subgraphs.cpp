@@ -0,0 +1,197 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/constant_propagation.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+size_t CountNodes(Block* b) {
+  size_t count = 0;
+  for (auto n : b->nodes()) {
+    count++;
+    for (auto sub_block : n->blocks()) {
+      count += CountNodes(sub_block);
+    }
+  }
+  return count;
+}
+
+struct ParameterSubgraphFolding {
+  ParameterSubgraphFolding(std::shared_ptr<Graph> graph, int64_t max_constant_bytes)
+      : graph_(std::move(graph)), max_constant_bytes_(max_constant_bytes) {}
+
+  void run() {
+    auto num_nodes = CountNodes(graph_->block());
+    foldBlock(graph_->block());
+    // Removes the folded nodes along with the constants only they used
+    torch::jit::EliminateDeadCode(graph_);
+    auto num_removed = num_nodes - CountNodes(graph_->block());
+    LOG_DEBUG(
+        "[Lowering Constant Folding]: Folded " << num_folded_ << " nodes into constants, removing " << num_removed
+                                               << " nodes from the graph (" << num_too_large_
+                                               << " nodes skipped for exceeding " << max_constant_bytes_ << " bytes)");
+    LOG_GRAPH("Post fold parameter subgraphs: " << *graph_);
+  }
+
+ private:
+  // In place ops would write to the constant instead of a fresh tensor on
+  // every run, so neither what they read nor what they write is folded
+  bool feedsMutation(Value* v) {
+    for (auto& use : v->uses()) {
+      auto schema = use.user->maybeSchema();
+      if (schema && schema->is_mutable()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool isFoldable(Node* n) {
+    if (n->kind() == prim::Constant || !n->kind().is_aten() || !n->blocks().empty() || !n->maybeOperator() ||
+        n->isNondeterministic() || n->hasSideEffects() || n->schema().is_mutable()) {
+      return false;
+    }
+
+    bool reads_parameter = false;
+    for (auto in : n->inputs()) {
+      if (in->node()->kind() != prim::Constant) {
+        return false;
+      }
+      reads_parameter |= in->type()->isSubtypeOf(TensorType::get());
+    }
+    if (!reads_parameter) {
+      // Scalar only arithmetic is left to the evaluators
+      return false;
+    }
+
+    for (auto out : n->outputs()) {
+      // Tensor lists are only meaningful to converters as lists of ITensors
+      if (out->type()->isSubtypeOf(ListType::ofTensors()) || feedsMutation(out)) {
+        return false;
+      }
+    }
+    for (auto in : n->inputs()) {
+      if (feedsMutation(in)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Uses the traced output shapes when available to avoid computing outputs
+  // that would be rejected anyway
+  bool knownToBeTooLarge(Node* n) {
+    for (auto out : n->outputs()) {
+      auto type = out->type()->cast<TensorType>();
+      if (!type) {
+        continue;
+      }
+      auto sizes = type->sizes().concrete_sizes();
+      auto scalar_type = type->scalarType();
+      if (!sizes || !scalar_type) {
+        continue;
+      }
+      int64_t bytes = c10::elementSize(*scalar_type);
+      for (auto s : *sizes) {
+        bytes *= s;
+      }
+      if (bytes > max_constant_bytes_) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void foldBlock(Block* b) {
+    for (auto n : b->nodes()) {
+      for (auto sub_block : n->blocks()) {
+        foldBlock(sub_block);
+      }
+      if (!isFoldable(n)) {
+        continue;
+      }
+      if (knownToBeTooLarge(n)) {
+        num_too_large_++;
+        continue;
+      }
+      tryFold(n);
+    }
+  }
+
+  void tryFold(Node* n) {
+    c10::optional<Stack> outputs;
+    {
+      at::NoGradGuard no_grad;
+      outputs = runNodeIfInputsAreConstant(n);
+    }
+    if (!outputs) {
+      LOG_GRAPH("Failed to evaluate " << *n << " at compile time, leaving it in the graph");
+      return;
+    }
+
+    int64_t bytes = 0;
+    for (auto& out : *outputs) {
+      if (out.isTensor()) {
+        auto t = out.toTensor();
+        if (t.defined()) {
+          // Views (aten::t, aten::reshape, ...) are made contiguous and do
+          // not keep the storage of the weight they came from alive
+          if (!t.is_contiguous() || t.storage().nbytes() != t.nbytes()) {
+            t = t.clone(at::MemoryFormat::Contiguous);
+          }
+          bytes += t.nbytes();
+          out = t;
+        }
+      }
+    }
+    if (bytes > max_constant_bytes_) {
+      LOG_GRAPH("Not folding " << *n << " as it produces " << bytes << " bytes of constants");
+      num_too_large_++;
+      return;
+    }
+
+    std::vector<Value*> constants;
+    WithInsertPoint guard(n);
+    for (size_t i = 0; i < outputs->size(); i++) {
+      auto constant = tryInsertConstant(*graph_, (*outputs)[i]);
+      if (!constant) {
+        LOG_GRAPH("Cannot represent output " << i << " of " << *n << " as a constant, leaving it in the graph");
+        for (auto c : constants) {
+          c->node()->destroy();
+        }
+        return;
+      }
+      constants.push_back(*constant);
+    }
+
+    LOG_GRAPH("Folding " << *n << " into a constant");
+    for (size_t i = 0; i < constants.size(); i++) {
+      n->output(i)->replaceAllUsesWith(constants[i]);
+    }
+    num_folded_++;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  int64_t max_constant_bytes_;
+  size_t num_folded_ = 0;
+  size_t num_too_large_ = 0;
+};
+} // namespace
+
+void FoldParameterSubgraphs(std::shared_ptr<torch::jit::Graph>& graph, int64_t max_constant_bytes) {
+  ParameterSubgraphFolding folding(graph, max_constant_bytes);
+  folding.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,195 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+struct SiblingConvolutionFusion {
+  SiblingConvolutionFusion(std::shared_ptr<Graph> graph) : graph_(std::move(graph)) {}
+
+  void run() {
+    fuseBlock(graph_->block());
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG("[Lowering Horizontal Fusion]: Fused " << num_fused_ << " convolutions into " << num_groups_);
+    LOG_GRAPH("Post fuse sibling convolutions: " << *graph_);
+  }
+
+ private:
+  /// A convolution with constant weights and settings:
+  ///   %y = aten::_convolution(%x, %w, %b, %stride, %padding, %dilation, %transposed=0, %output_padding,
+  ///                           %groups=1, %benchmark, %deterministic, %cudnn_enabled[, %allow_tf32])
+  struct Branch {
+    Node* node;
+    at::Tensor weight;
+    at::Tensor bias;
+  };
+
+  void fuseBlock(Block* b) {
+    for (auto in : b->inputs()) {
+      fuseUsers(in);
+    }
+    // Fusing only ever replaces nodes after the one being visited
+    for (auto n : b->nodes()) {
+      for (auto sub_block : n->blocks()) {
+        fuseBlock(sub_block);
+      }
+      for (auto out : n->outputs()) {
+        fuseUsers(out);
+      }
+    }
+  }
+
+  c10::optional<Branch> asBranch(Node* n, Value* in) {
+    if (n->kind() != aten::_convolution || n->input(0) != in) {
+      return {};
+    }
+    auto weight = toIValue(n->input(1));
+    auto bias = toIValue(n->input(2));
+    auto transposed = toIValue(n->input(6));
+    auto groups = toIValue(n->input(8));
+    if (!weight || !weight->isTensor() || !bias || !(bias->isNone() || bias->isTensor()) || !transposed ||
+        !transposed->isBool() || transposed->toBool() || !groups || !groups->isInt() || groups->toInt() != 1) {
+      return {};
+    }
+    // Remaining settings have to be constant to be compared across branches
+    for (size_t i = 3; i < n->inputs().size(); i++) {
+      if (!toIValue(n->input(i))) {
+        return {};
+      }
+    }
+    return Branch{n, weight->toTensor(), bias->isTensor() ? bias->toTensor() : at::Tensor()};
+  }
+
+  bool sameConstant(Value* a, Value* b) {
+    if (a == b) {
+      return true;
+    }
+    auto x = toIValue(a);
+    auto y = toIValue(b);
+    if (x->isIntList() && y->isIntList()) {
+      return x->toIntVector() == y->toIntVector();
+    } else if (x->isInt() && y->isInt()) {
+      return x->toInt() == y->toInt();
+    } else if (x->isBool() && y->isBool()) {
+      return x->toBool() == y->toBool();
+    }
+    return false;
+  }
+
+  // Branches can share a convolution if everything but the number of output
+  // channels matches: kernel size, input channels, strides, padding, ...
+  bool compatible(const Branch& a, const Branch& b) {
+    if (a.node->owningBlock() != b.node->owningBlock() || a.node->inputs().size() != b.node->inputs().size() ||
+        a.weight.dim() != b.weight.dim() || a.weight.sizes().slice(1) != b.weight.sizes().slice(1) ||
+        a.weight.scalar_type() != b.weight.scalar_type() || a.weight.device() != b.weight.device()) {
+      return false;
+    }
+    for (size_t i = 3; i < a.node->inputs().size(); i++) {
+      if (!sameConstant(a.node->input(i), b.node->input(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void fuseUsers(Value* v) {
+    std::vector<std::vector<Branch>> groups;
+    for (auto& use : v->uses()) {
+      auto branch = asBranch(use.user, v);
+      if (!branch) {
+        continue;
+      }
+      bool grouped = false;
+      for (auto& g : groups) {
+        if (compatible(g[0], *branch)) {
+          g.push_back(*branch);
+          grouped = true;
+          break;
+        }
+      }
+      if (!grouped) {
+        groups.push_back({*branch});
+      }
+    }
+
+    for (auto& g : groups) {
+      if (g.size() > 1) {
+        fuse(g);
+      }
+    }
+  }
+
+  void fuse(std::vector<Branch>& group) {
+    auto first = group[0].node;
+    for (auto& b : group) {
+      if (b.node->isBefore(first)) {
+        first = b.node;
+      }
+    }
+
+    bool has_bias = false;
+    for (auto& b : group) {
+      has_bias |= b.bias.defined();
+    }
+
+    at::NoGradGuard no_grad;
+    std::vector<at::Tensor> weights;
+    std::vector<at::Tensor> biases;
+    std::vector<int64_t> sizes;
+    for (auto& b : group) {
+      auto out_channels = b.weight.size(0);
+      weights.push_back(b.weight);
+      sizes.push_back(out_channels);
+      if (has_bias) {
+        biases.push_back(
+            b.bias.defined() ? b.bias.to(b.weight.options()) : at::zeros({out_channels}, b.weight.options()));
+      }
+    }
+
+    // The fused convolution takes the place of the earliest branch and keeps
+    // its settings, which are the same for every branch
+    WithInsertPoint guard(first);
+    auto fused_weight = graph_->insertConstant(at::cat(weights, 0));
+    auto fused_bias = has_bias ? graph_->insertConstant(at::cat(biases, 0)) : graph_->insertConstant(IValue());
+    auto fused = graph_->insertNode(graph_->createClone(first, [](Value* v) { return v; }));
+    fused->replaceInput(1, fused_weight);
+    fused->replaceInput(2, fused_bias);
+
+    auto split_sizes = graph_->insertConstant(sizes);
+    auto split_dim = graph_->insertConstant(1);
+    auto split = graph_->insertNode(graph_->create(aten::split_with_sizes, {fused->output(), split_sizes, split_dim}));
+    split->output()->setType(ListType::ofTensors());
+    auto unpack = graph_->insertNode(graph_->createListUnpack(split->output(), group.size()));
+
+    for (size_t i = 0; i < group.size(); i++) {
+      group[i].node->output()->replaceAllUsesWith(unpack->output(i));
+      group[i].node->destroy();
+    }
+    LOG_GRAPH("Fused " << group.size() << " convolutions into " << *fused);
+    num_fused_ += group.size();
+    num_groups_++;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  size_t num_fused_ = 0;
+  size_t num_groups_ = 0;
+};
+} // namespace
+
+void FuseSiblingConvolutions(std::shared_ptr<torch::jit::Graph>& graph) {
+  SiblingConvolutionFusion fusion(graph);
+  fusion.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
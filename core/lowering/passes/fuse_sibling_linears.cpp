@@ -0,0 +1,194 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+struct SiblingLinearFusion {
+  SiblingLinearFusion(std::shared_ptr<Graph> graph, int64_t min_fused_width)
+      : graph_(std::move(graph)), min_fused_width_(min_fused_width) {}
+
+  void run() {
+    fuseBlock(graph_->block());
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG("[Lowering Horizontal Fusion]: Fused " << num_fused_ << " linear layers into " << num_groups_);
+    LOG_GRAPH("Post fuse sibling linears: " << *graph_);
+  }
+
+ private:
+  /// A linear layer whose weights are known at compile time, either
+  ///   %y = aten::linear(%x, %w, %b)   with %w [out, in] and %b [out] or None
+  ///   %y = aten::matmul(%x, %w)       with %w [in, out]
+  struct Branch {
+    Node* node;
+    at::Tensor weight;
+    at::Tensor bias;
+  };
+
+  void fuseBlock(Block* b) {
+    for (auto in : b->inputs()) {
+      fuseUsers(in);
+    }
+    // Fusing only ever replaces nodes after the one being visited
+    for (auto n : b->nodes()) {
+      for (auto sub_block : n->blocks()) {
+        fuseBlock(sub_block);
+      }
+      for (auto out : n->outputs()) {
+        fuseUsers(out);
+      }
+    }
+  }
+
+  c10::optional<Branch> asBranch(Node* n, Value* in) {
+    bool is_linear = n->kind() == aten::linear;
+    if ((!is_linear && n->kind() != aten::matmul) || n->input(0) != in) {
+      return {};
+    }
+    auto weight = toIValue(n->input(1));
+    if (!weight || !weight->isTensor() || weight->toTensor().dim() != 2) {
+      return {};
+    }
+    Branch branch{n, weight->toTensor(), at::Tensor()};
+    if (is_linear) {
+      auto bias = toIValue(n->input(2));
+      if (!bias || !(bias->isNone() || bias->isTensor())) {
+        return {};
+      }
+      if (bias->isTensor()) {
+        branch.bias = bias->toTensor();
+      }
+    }
+    return branch;
+  }
+
+  int64_t width(const Branch& b) {
+    return b.node->kind() == aten::linear ? b.weight.size(0) : b.weight.size(1);
+  }
+
+  int64_t inFeatures(const Branch& b) {
+    return b.node->kind() == aten::linear ? b.weight.size(1) : b.weight.size(0);
+  }
+
+  bool sameShape(const Branch& a, const Branch& b) {
+    return a.node->kind() == b.node->kind() && a.node->owningBlock() == b.node->owningBlock() &&
+        inFeatures(a) == inFeatures(b) && a.weight.scalar_type() == b.weight.scalar_type() &&
+        a.weight.device() == b.weight.device();
+  }
+
+  void fuseUsers(Value* v) {
+    std::vector<std::vector<Branch>> groups;
+    for (auto& use : v->uses()) {
+      auto branch = asBranch(use.user, v);
+      if (!branch) {
+        continue;
+      }
+      bool grouped = false;
+      for (auto& g : groups) {
+        if (sameShape(g[0], *branch)) {
+          g.push_back(*branch);
+          grouped = true;
+          break;
+        }
+      }
+      if (!grouped) {
+        groups.push_back({*branch});
+      }
+    }
+
+    for (auto& g : groups) {
+      if (g.size() < 2) {
+        continue;
+      }
+      int64_t fused_width = 0;
+      for (auto& b : g) {
+        fused_width += width(b);
+      }
+      if (fused_width < min_fused_width_) {
+        LOG_GRAPH(
+            "Not fusing " << g.size() << " linear layers reading %" << v->debugName() << " as their combined width "
+                          << fused_width << " is below " << min_fused_width_);
+        continue;
+      }
+      fuse(v, g);
+    }
+  }
+
+  void fuse(Value* v, std::vector<Branch>& group) {
+    auto first = group[0].node;
+    for (auto& b : group) {
+      if (b.node->isBefore(first)) {
+        first = b.node;
+      }
+    }
+
+    bool is_linear = first->kind() == aten::linear;
+    bool has_bias = false;
+    for (auto& b : group) {
+      has_bias |= b.bias.defined();
+    }
+
+    at::NoGradGuard no_grad;
+    std::vector<at::Tensor> weights;
+    std::vector<at::Tensor> biases;
+    std::vector<int64_t> sizes;
+    for (auto& b : group) {
+      weights.push_back(b.weight);
+      sizes.push_back(width(b));
+      if (has_bias) {
+        biases.push_back(b.bias.defined() ? b.bias.to(b.weight.options()) : at::zeros({width(b)}, b.weight.options()));
+      }
+    }
+
+    // The fused layer goes where the earliest branch was, its input and
+    // weights are all defined by then
+    WithInsertPoint guard(first);
+    auto fused_weight = graph_->insertConstant(at::cat(weights, is_linear ? 0 : 1));
+    Node* fused;
+    if (is_linear) {
+      auto fused_bias = has_bias ? graph_->insertConstant(at::cat(biases, 0)) : graph_->insertConstant(IValue());
+      fused = graph_->insertNode(graph_->create(aten::linear, {v, fused_weight, fused_bias}));
+    } else {
+      fused = graph_->insertNode(graph_->create(aten::matmul, {v, fused_weight}));
+    }
+    fused->output()->setType(TensorType::get());
+
+    auto split_sizes = graph_->insertConstant(sizes);
+    auto split_dim = graph_->insertConstant(-1);
+    auto split = graph_->insertNode(graph_->create(aten::split_with_sizes, {fused->output(), split_sizes, split_dim}));
+    split->output()->setType(ListType::ofTensors());
+    auto unpack = graph_->insertNode(graph_->createListUnpack(split->output(), group.size()));
+
+    for (size_t i = 0; i < group.size(); i++) {
+      group[i].node->output()->replaceAllUsesWith(unpack->output(i));
+      group[i].node->destroy();
+    }
+    LOG_GRAPH("Fused " << group.size() << " linear layers reading %" << v->debugName() << " into " << *fused);
+    num_fused_ += group.size();
+    num_groups_++;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  int64_t min_fused_width_;
+  size_t num_fused_ = 0;
+  size_t num_groups_ = 0;
+};
+} // namespace
+
+void FuseSiblingLinears(std::shared_ptr<torch::jit::Graph>& graph, int64_t min_fused_width) {
+  SiblingLinearFusion fusion(graph, min_fused_width);
+  fusion.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
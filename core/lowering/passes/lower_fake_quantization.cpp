@@ -0,0 +1,178 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+const auto kQuantizeRange = c10::Symbol::fromQualString("trt::quantize_range");
+
+struct FakeQuantizationLowering {
+  FakeQuantizationLowering(std::shared_ptr<Graph> graph) : graph_(std::move(graph)) {}
+
+  void run() {
+    lowerBlock(graph_->block());
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG(
+        "[Lowering Fake Quantization]: Extracted " << num_ranges_ << " dynamic ranges and quantized " << num_weights_
+                                                   << " weights");
+    LOG_GRAPH("Post lower fake quantization: " << *graph_);
+  }
+
+ private:
+  bool isFakeQuantize(Node* n) {
+    return n->kind() == aten::fake_quantize_per_tensor_affine || n->kind() == aten::fake_quantize_per_channel_affine;
+  }
+
+  bool allInputsConstant(Node* n) {
+    for (auto in : n->inputs()) {
+      if (!toIValue(in)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// TensorRT quantizes symmetrically to [-128, 127] with a scale of amax / 127,
+  /// which is exactly the usual QAT setup of a zero point of 0 and a quant
+  /// range of [-128, 127] (or [-127, 127]). Other setups are approximated by
+  /// the smallest symmetric range covering theirs
+  c10::optional<double> amax(double scale, int64_t zero_point, int64_t quant_min, int64_t quant_max) {
+    if (!(scale > 0) || !std::isfinite(scale)) {
+      return {};
+    }
+    if (zero_point == 0 && quant_max == 127 && (quant_min == -128 || quant_min == -127)) {
+      return scale * 127;
+    }
+    auto range = scale * std::max(std::abs(quant_min - zero_point), std::abs(quant_max - zero_point));
+    LOG_WARNING(
+        "TensorRT only supports symmetric INT8 quantization, approximating fake quantization with scale "
+        << scale << ", zero point " << zero_point << " and range [" << quant_min << ", " << quant_max
+        << "] by the dynamic range [" << -range << ", " << range << "]");
+    return range;
+  }
+
+  /// %y = aten::fake_quantize_per_tensor_affine(%x, %scale, %zero_point, %quant_min, %quant_max)
+  c10::optional<double> perTensorRange(Node* n) {
+    auto scale = toIValue(n->input(1));
+    auto zero_point = toIValue(n->input(2));
+    auto quant_min = toIValue(n->input(3));
+    auto quant_max = toIValue(n->input(4));
+    if (!scale || !zero_point || !quant_min || !quant_max) {
+      return {};
+    }
+    return amax(scale->toDouble(), zero_point->toInt(), quant_min->toInt(), quant_max->toInt());
+  }
+
+  /// %y = aten::fake_quantize_per_channel_affine(%x, %scales, %zero_points, %axis, %quant_min, %quant_max)
+  /// Dynamic ranges are per tensor, so the widest channel sets the range
+  c10::optional<double> perChannelRange(Node* n) {
+    auto scales = toIValue(n->input(1));
+    auto zero_points = toIValue(n->input(2));
+    auto quant_min = toIValue(n->input(4));
+    auto quant_max = toIValue(n->input(5));
+    if (!scales || !zero_points || !quant_min || !quant_max || !scales->isTensor() || !zero_points->isTensor()) {
+      return {};
+    }
+    auto s = scales->toTensor().to(at::kDouble).contiguous();
+    auto z = zero_points->toTensor().to(at::kLong).contiguous();
+    if (s.numel() == 0 || s.numel() != z.numel()) {
+      return {};
+    }
+
+    c10::optional<double> range;
+    for (int64_t i = 0; i < s.numel(); i++) {
+      auto channel = amax(s.data_ptr<double>()[i], z.data_ptr<int64_t>()[i], quant_min->toInt(), quant_max->toInt());
+      if (!channel) {
+        return {};
+      }
+      range = range ? std::max(*range, *channel) : *channel;
+    }
+    LOG_WARNING(
+        "TensorRT only supports per tensor dynamic ranges for activations, using the widest channel of "
+        << util::node_info(n) << " for the whole tensor");
+    return range;
+  }
+
+  /// Quantized weights are stored already rounded, TensorRT picks its own
+  /// (per channel) weight scales from them when building INT8 engines
+  void quantizeWeights(Node* n) {
+    auto ivalues = c10::fmap(n->inputs(), [](Value* v) { return *toIValue(v); });
+    auto weights = ivalues[0].toTensor();
+    at::Tensor quantized;
+    if (n->kind() == aten::fake_quantize_per_tensor_affine) {
+      quantized = at::fake_quantize_per_tensor_affine(
+          weights, ivalues[1].toDouble(), ivalues[2].toInt(), ivalues[3].toInt(), ivalues[4].toInt());
+    } else {
+      quantized = at::fake_quantize_per_channel_affine(
+          weights,
+          ivalues[1].toTensor(),
+          ivalues[2].toTensor(),
+          ivalues[3].toInt(),
+          ivalues[4].toInt(),
+          ivalues[5].toInt());
+    }
+    WithInsertPoint guard(n);
+    auto constant = graph_->insertConstant(quantized);
+    LOG_GRAPH("Quantizing weights of " << *n);
+    n->output()->replaceAllUsesWith(constant);
+    num_weights_++;
+  }
+
+  /// %y = aten::fake_quantize_...(%x, ...)  =>  %y = trt::quantize_range(%x, %amax)
+  void extractRange(Node* n) {
+    auto range = n->kind() == aten::fake_quantize_per_tensor_affine ? perTensorRange(n) : perChannelRange(n);
+    if (!range) {
+      LOG_WARNING(
+          "Unable to extract a dynamic range from " << util::node_info(n)
+                                                    << ", its quantization parameters are not constant");
+      return;
+    }
+    WithInsertPoint guard(n);
+    auto quantize_range =
+        graph_->insertNode(graph_->create(kQuantizeRange, {n->input(0), graph_->insertConstant(*range)}));
+    quantize_range->output()->setType(n->output()->type());
+    LOG_GRAPH("Replacing " << *n << " with a dynamic range of " << *range);
+    n->output()->replaceAllUsesWith(quantize_range->output());
+    num_ranges_++;
+  }
+
+  void lowerBlock(Block* b) {
+    for (auto n : b->nodes()) {
+      for (auto sub_block : n->blocks()) {
+        lowerBlock(sub_block);
+      }
+      if (!isFakeQuantize(n)) {
+        continue;
+      }
+      if (allInputsConstant(n)) {
+        quantizeWeights(n);
+      } else {
+        extractRange(n);
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  size_t num_ranges_ = 0;
+  size_t num_weights_ = 0;
+};
+} // namespace
+
+void LowerFakeQuantization(std::shared_ptr<torch::jit::Graph>& graph) {
+  FakeQuantizationLowering lowering(graph);
+  lowering.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
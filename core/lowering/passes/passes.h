@@ -7,15 +7,48 @@ namespace core {
 namespace lowering {
 namespace passes {
 
+// Composes chains of permutations, drops identity permutations and folds
+// chains of shape only ops into the reshape or view ending them
+void CanonicalizeShuffles(std::shared_ptr<torch::jit::Graph>& graph);
 void Conv2DToConvolution(std::shared_ptr<torch::jit::Graph>& graph);
 void Conv3DToConvolution(std::shared_ptr<torch::jit::Graph>& graph);
+void FoldConvBatchNorm(std::shared_ptr<torch::jit::Graph>& graph);
+// Evaluates nodes that only depend on constants (frozen parameters included)
+// and replaces them with their results, nodes producing more than
+// max_constant_bytes of tensors are left in the graph
+void FoldParameterSubgraphs(std::shared_ptr<torch::jit::Graph>& graph, int64_t max_constant_bytes = 64 << 20);
+// Replaces QAT fake quantization of activations by trt::quantize_range
+// carrying the equivalent INT8 dynamic range and applies fake quantization
+// of constants (weights) to the constants themselves
+void LowerFakeQuantization(std::shared_ptr<torch::jit::Graph>& graph);
 void FuseAddMMBranches(std::shared_ptr<torch::jit::Graph> graph);
 void FuseFlattenLinear(std::shared_ptr<torch::jit::Graph>& graph);
+// Replaces convolutions with constant weights and identical settings reading
+// the same value by one convolution over the concatenated output channels
+// followed by a channel split, expects aten::_convolution nodes
+void FuseSiblingConvolutions(std::shared_ptr<torch::jit::Graph>& graph);
+// Replaces linear layers with constant weights reading the same value by one
+// wider linear layer followed by aten::split_with_sizes, as long as their
+// combined output width is at least min_fused_width
+void FuseSiblingLinears(std::shared_ptr<torch::jit::Graph>& graph, int64_t min_fused_width = 128);
 void EliminateExceptionOrPassPattern(std::shared_ptr<torch::jit::Graph> graph);
+// Seeds the tensor inputs of the graph with the given shapes (-1 for dims
+// that vary at runtime), dtype and device, propagates them and folds the
+// aten::size / aten::dim queries they answer along with the branches depending
+// on them. The types of the values in the graph are left as they were
+void PropagateStaticShapes(
+    std::shared_ptr<torch::jit::Graph>& graph,
+    const std::vector<std::vector<int64_t>>& input_shapes,
+    at::ScalarType input_dtype,
+    at::Device input_device);
 void RemoveBNDimCheck(std::shared_ptr<torch::jit::Graph> graph);
 void RemoveContiguous(std::shared_ptr<torch::jit::Graph>& graph);
 void RemoveDropout(std::shared_ptr<torch::jit::Graph>& graph);
 void RemoveNOPs(std::shared_ptr<torch::jit::Graph> graph);
+// Replaces for-loops with a constant trip count by that many copies of their
+// body, as long as the trips of a loop nest multiplied out (e.g. 4 x 8 for a
+// loop of 8 trips inside one of 4) are at most max_trip_count
+void UnrollConstantLoops(std::shared_ptr<torch::jit::Graph>& graph, int64_t max_trip_count = 32);
 void UnpackAddMM(std::shared_ptr<torch::jit::Graph>& graph);
 void UnpackBatchNorm(std::shared_ptr<torch::jit::Graph>& graph);
 void UnpackLogSoftmax(std::shared_ptr<torch::jit::Graph>& graph);
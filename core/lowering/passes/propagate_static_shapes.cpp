@@ -0,0 +1,221 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/constant_propagation.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+#include "torch/csrc/jit/passes/shape_analysis.h"
+
+#include "core/util/prelude.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+struct StaticShapePropagation {
+  StaticShapePropagation(
+      std::shared_ptr<Graph> graph,
+      const std::vector<std::vector<int64_t>>& input_shapes,
+      at::ScalarType input_dtype,
+      at::Device input_device)
+      : graph_(std::move(graph)), input_shapes_(input_shapes), input_dtype_(input_dtype), input_device_(input_device) {}
+
+  void run() {
+    std::vector<Value*> tensor_inputs;
+    for (auto in : graph_->inputs()) {
+      if (in->type()->isSubtypeOf(TensorType::get())) {
+        tensor_inputs.push_back(in);
+      }
+    }
+    if (tensor_inputs.size() != input_shapes_.size()) {
+      LOG_WARNING(
+          "Skipping static shape propagation, the graph takes " << tensor_inputs.size() << " tensors but "
+                                                                << input_shapes_.size() << " input shapes were given");
+      return;
+    }
+
+    // Shape analysis refines the types of every value it reaches, which later
+    // passes would otherwise take as given. Values are keyed by their unique
+    // id as nodes are destroyed and created while folding
+    std::unordered_map<size_t, TypePtr> original_types;
+    saveTypes(graph_->block(), original_types);
+
+    // Folding sizes can take a branch out of a prim::If, whose outputs then
+    // get more precise shapes, so keep going until nothing changes
+    size_t num_folded = 0;
+    for (size_t iter = 0; iter < kMaxIterations; iter++) {
+      seedInputs(tensor_inputs);
+      try {
+        torch::jit::PropagateInputShapes(graph_);
+      } catch (const std::exception& e) {
+        LOG_WARNING("Stopping static shape propagation early, shape analysis failed: " << e.what());
+        break;
+      }
+      auto folded = foldBlock(graph_->block());
+      if (folded == 0) {
+        break;
+      }
+      num_folded += folded;
+      // Evaluates what now only depends on constants, prim::Ifs on constant
+      // conditions are replaced by the branch taken
+      torch::jit::ConstantPropagation(graph_);
+    }
+
+    restoreTypes(graph_->block(), original_types);
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG("[Lowering Shape Propagation]: Folded " << num_folded << " shape queries into constants");
+    LOG_GRAPH("Post static shape propagation: " << *graph_);
+  }
+
+ private:
+  static constexpr size_t kMaxIterations = 8;
+
+  void seedInputs(const std::vector<Value*>& tensor_inputs) {
+    for (size_t i = 0; i < tensor_inputs.size(); i++) {
+      std::vector<c10::optional<int64_t>> sizes;
+      for (auto d : input_shapes_[i]) {
+        sizes.push_back(d < 0 ? c10::nullopt : c10::optional<int64_t>(d));
+      }
+      tensor_inputs[i]->setType(TensorType::create(
+          input_dtype_,
+          input_device_,
+          c10::VaryingShape<int64_t>(sizes),
+          c10::VaryingShape<int64_t>(input_shapes_[i].size()),
+          false));
+    }
+  }
+
+  void saveTypes(Block* b, std::unordered_map<size_t, TypePtr>& types) {
+    for (auto in : b->inputs()) {
+      types[in->unique()] = in->type();
+    }
+    for (auto n : b->nodes()) {
+      for (auto out : n->outputs()) {
+        types[out->unique()] = out->type();
+      }
+      for (auto sub_block : n->blocks()) {
+        saveTypes(sub_block, types);
+      }
+    }
+  }
+
+  /// Values created since (the folded constants) keep the types they were
+  /// created with
+  void restoreTypes(Block* b, const std::unordered_map<size_t, TypePtr>& types) {
+    auto restore = [&](Value* v) {
+      auto it = types.find(v->unique());
+      if (it != types.end()) {
+        v->setType(it->second);
+      }
+    };
+    for (auto in : b->inputs()) {
+      restore(in);
+    }
+    for (auto n : b->nodes()) {
+      for (auto out : n->outputs()) {
+        restore(out);
+      }
+      for (auto sub_block : n->blocks()) {
+        restoreTypes(sub_block, types);
+      }
+    }
+  }
+
+  c10::optional<int64_t> knownDim(Value* v) {
+    auto type = v->type()->cast<TensorType>();
+    if (!type) {
+      return {};
+    }
+    auto rank = type->sizes().size();
+    if (!rank) {
+      return {};
+    }
+    return static_cast<int64_t>(*rank);
+  }
+
+  c10::optional<int64_t> knownSize(Value* v, int64_t dim) {
+    auto type = v->type()->cast<TensorType>();
+    auto rank = knownDim(v);
+    if (!type || !rank) {
+      return {};
+    }
+    dim = dim < 0 ? dim + *rank : dim;
+    if (dim < 0 || dim >= *rank) {
+      return {};
+    }
+    return type->sizes()[dim];
+  }
+
+  /// Replaces shape queries whose answer is fixed by the input shapes:
+  ///   %s : int[] = aten::size(%x)
+  ///   %s : int = aten::size(%x, %dim)
+  ///   %d : int = aten::dim(%x)
+  size_t foldBlock(Block* b) {
+    size_t folded = 0;
+    for (auto it = b->nodes().begin(); it != b->nodes().end(); it++) {
+      auto n = *it;
+      for (auto sub_block : n->blocks()) {
+        folded += foldBlock(sub_block);
+      }
+
+      c10::optional<IValue> value;
+      if (n->kind() == aten::size && n->inputs().size() == 1) {
+        auto type = n->input(0)->type()->cast<TensorType>();
+        if (type) {
+          auto sizes = type->sizes().concrete_sizes();
+          if (sizes) {
+            value = IValue(*sizes);
+          }
+        }
+      } else if (n->kind() == aten::size && n->inputs().size() == 2) {
+        auto dim = toIValue(n->input(1));
+        if (dim && dim->isInt()) {
+          auto size = knownSize(n->input(0), dim->toInt());
+          if (size) {
+            value = IValue(*size);
+          }
+        }
+      } else if (n->kind() == aten::dim) {
+        auto rank = knownDim(n->input(0));
+        if (rank) {
+          value = IValue(*rank);
+        }
+      }
+
+      if (value) {
+        WithInsertPoint guard(n);
+        auto constant = graph_->insertConstant(*value);
+        LOG_GRAPH("Folding " << *n << " into " << *value);
+        n->output()->replaceAllUsesWith(constant);
+        it.destroyCurrent();
+        folded++;
+      }
+    }
+    return folded;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  const std::vector<std::vector<int64_t>>& input_shapes_;
+  at::ScalarType input_dtype_;
+  at::Device input_device_;
+};
+
+constexpr size_t StaticShapePropagation::kMaxIterations;
+} // namespace
+
+void PropagateStaticShapes(
+    std::shared_ptr<torch::jit::Graph>& graph,
+    const std::vector<std::vector<int64_t>>& input_shapes,
+    at::ScalarType input_dtype,
+    at::Device input_device) {
+  StaticShapePropagation propagation(graph, input_shapes, input_dtype, input_device);
+  propagation.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
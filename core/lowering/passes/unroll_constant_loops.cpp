@@ -0,0 +1,139 @@
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+
+#include "core/util/prelude.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace lowering {
+namespace passes {
+namespace {
+using namespace torch::jit;
+
+struct ConstantLoopUnrolling {
+  ConstantLoopUnrolling(std::shared_ptr<Graph> graph, int64_t max_trip_count)
+      : graph_(std::move(graph)), max_trip_count_(max_trip_count) {}
+
+  void run() {
+    unrollBlock(graph_->block());
+    torch::jit::EliminateDeadCode(graph_);
+    LOG_DEBUG(
+        "[Lowering Loop Unrolling]: Unrolled " << num_unrolled_ << " loops into " << num_trips_
+                                               << " copies of their bodies");
+    LOG_GRAPH("Post unroll constant loops: " << *graph_);
+  }
+
+ private:
+  c10::optional<int64_t> constantTripCount(Node* n) {
+    auto trip_count = toIValue(n->input(0));
+    if (!trip_count || !trip_count->isInt()) {
+      return {};
+    }
+    // The interpreter runs no trips for negative counts
+    return std::max<int64_t>(trip_count->toInt(), 0);
+  }
+
+  bool isConstantTrue(Value* v) {
+    auto ivalue = toIValue(v);
+    return ivalue && ivalue->isBool() && ivalue->toBool();
+  }
+
+  /// Only for-loops are unrolled, their condition is true going in and after
+  /// every trip so they run exactly trip count times:
+  ///   %y = prim::Loop(%n, %true, %x)
+  ///     block0(%i : int, %x_i):
+  ///       ...
+  ///       -> (%true, %x_next)
+  /// nested_trips is the number of copies of inner loop bodies already
+  /// unrolled into the body. The limit applies to the trips of the whole nest,
+  /// so the copies of the innermost bodies in the graph stay within it. Returns
+  /// the number of copies of innermost bodies in place of the loop afterwards
+  int64_t tryUnroll(Node* n, int64_t nested_trips) {
+    auto trip_count = constantTripCount(n);
+    if (!trip_count) {
+      return nested_trips;
+    }
+    auto body = n->blocks()[0];
+    if (!isConstantTrue(n->input(1)) || !isConstantTrue(body->outputs()[0])) {
+      return nested_trips;
+    }
+    auto copies_per_trip = std::max<int64_t>(nested_trips, 1);
+    if (*trip_count > max_trip_count_ || (*trip_count > 0 && copies_per_trip > max_trip_count_ / *trip_count)) {
+      LOG_DEBUG(
+          "[Lowering Loop Unrolling]: Not unrolling loop with " << *trip_count << " trips over " << copies_per_trip
+                                                                << " unrolled inner trips, more than the limit of "
+                                                                << max_trip_count_);
+      return nested_trips;
+    }
+
+    LOG_GRAPH("Unrolling " << *trip_count << " trips of " << *n);
+    WithInsertPoint guard(n);
+    std::vector<Value*> carried(n->inputs().begin() + 2, n->inputs().end());
+    for (int64_t i = 0; i < *trip_count; i++) {
+      std::unordered_map<Value*, Value*> env;
+      env[body->inputs()[0]] = graph_->insertConstant(i);
+      for (size_t j = 0; j < carried.size(); j++) {
+        env[body->inputs()[j + 1]] = carried[j];
+      }
+      auto value_map = [&](Value* v) {
+        auto it = env.find(v);
+        return it == env.end() ? v : it->second;
+      };
+      for (auto body_node : body->nodes()) {
+        auto clone = graph_->insertNode(graph_->createClone(body_node, value_map));
+        for (size_t j = 0; j < body_node->outputs().size(); j++) {
+          env[body_node->outputs()[j]] = clone->outputs()[j];
+        }
+      }
+      for (size_t j = 0; j < carried.size(); j++) {
+        carried[j] = value_map(body->outputs()[j + 1]);
+      }
+    }
+
+    for (size_t j = 0; j < carried.size(); j++) {
+      n->outputs()[j]->replaceAllUsesWith(carried[j]);
+    }
+    n->destroy();
+    num_unrolled_++;
+    num_trips_ += *trip_count;
+    return *trip_count * copies_per_trip;
+  }
+
+  // Returns the number of copies of loop bodies unrolled into the block
+  int64_t unrollBlock(Block* b) {
+    int64_t block_trips = 0;
+    for (auto it = b->nodes().begin(); it != b->nodes().end();) {
+      auto n = *it;
+      // Unrolling only inserts nodes before n and removes n itself
+      ++it;
+      // Inner loops go first, the copies of an outer body are then free of
+      // the loops that could be unrolled
+      int64_t nested_trips = 0;
+      for (auto sub_block : n->blocks()) {
+        nested_trips += unrollBlock(sub_block);
+      }
+      block_trips += n->kind() == prim::Loop ? tryUnroll(n, nested_trips) : nested_trips;
+    }
+    return block_trips;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  int64_t max_trip_count_;
+  size_t num_unrolled_ = 0;
+  int64_t num_trips_ = 0;
+};
+} // namespace
+
+void UnrollConstantLoops(std::shared_ptr<torch::jit::Graph>& graph, int64_t max_trip_count) {
+  ConstantLoopUnrolling unrolling(graph, max_trip_count);
+  unrolling.run();
+}
+
+} // namespace passes
+} // namespace lowering
+} // namespace core
+} // namespace trtorch
@@ -1,3 +1,4 @@
+#include "ATen/ATen.h"
 #include "torch/csrc/jit/runtime/custom_operator.h"
 
 namespace torch {
@@ -11,6 +12,16 @@ RegisterOperators trt_placeholder_ops_reg({
     /// Op marks a Tensor to be conveted from an Torch Tensor
     /// to a TRT constant Tensor
     Operator("trt::const(Tensor val) -> Tensor", [](Stack* stack) {}, aliasAnalysisFromSchema()),
+    /// Op marks the INT8 dynamic range [-amax, amax] of a Tensor (extracted
+    /// from QAT fake quantization), run in PyTorch it applies that quantization
+    Operator(
+        "trt::quantize_range(Tensor self, float amax) -> Tensor",
+        [](Stack* stack) {
+          auto amax = pop(*stack).toDouble();
+          auto self = pop(*stack).toTensor();
+          push(*stack, at::fake_quantize_per_tensor_affine(self, amax / 127, 0, -128, 127));
+        },
+        aliasAnalysisFromSchema()),
 });
 
 } // namespace jit
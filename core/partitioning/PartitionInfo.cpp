@@ -0,0 +1,31 @@
+#include <iostream>
+#include <sstream>
+
+#include "core/partitioning/PartitionInfo.h"
+
+namespace trtorch {
+namespace core {
+namespace partitioning {
+
+// clang-format off
+std::ostream& operator<<(std::ostream& os, const PartitionInfo& s) {
+  os << "Settings requested for Torch Fallback:"           \
+     << "\n    Enabled: " << s.enabled;
+  if (s.enabled) {
+    os << "\n    Minimum Block Size: " << s.min_block_size \
+       << "\n    Forced Fallback Operators: [";
+    for (size_t i = 0; i < s.forced_fallback_operators.size(); i++) {
+      os << s.forced_fallback_operators[i];
+      if (i + 1 < s.forced_fallback_operators.size()) {
+        os << ", ";
+      }
+    }
+    os << ']';
+  }
+  return os;
+}
+// clang-format on
+
+} // namespace partitioning
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace partitioning {
+
+struct PartitionInfo {
+  // Split the graph into TensorRT and TorchScript segments instead of
+  // requiring every operator in the method to be convertible
+  bool enabled = false;
+  // Minimum number of (non constant) nodes a run of supported operators needs
+  // before it is worth building an engine for it
+  uint64_t min_block_size = 1;
+  // Operators (by qualified name, e.g. aten::relu) that should always be run
+  // in TorchScript even if a converter exists
+  std::vector<std::string> forced_fallback_operators;
+};
+
+std::ostream& operator<<(std::ostream& os, const PartitionInfo& s);
+
+} // namespace partitioning
+} // namespace core
+} // namespace trtorch
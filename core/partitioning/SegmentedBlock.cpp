@@ -0,0 +1,73 @@
+#include <sstream>
+
+#include "core/partitioning/SegmentedBlock.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace partitioning {
+
+void SegmentedBlock::BuildGraph(std::vector<torch::jit::Value*> inputs, std::vector<torch::jit::Value*> outputs) {
+  inputs_ = std::move(inputs);
+  outputs_ = std::move(outputs);
+  g_ = std::make_shared<torch::jit::Graph>();
+
+  std::unordered_map<torch::jit::Value*, torch::jit::Value*> old_to_new;
+  for (auto in : inputs_) {
+    auto new_in = g_->addInput();
+    new_in->copyMetadata(in);
+    old_to_new[in] = new_in;
+  }
+
+  // Constants are not tracked as part of the segment boundary, every segment
+  // gets its own copy of the constants it uses
+  auto env = [&](torch::jit::Value* v) -> torch::jit::Value* {
+    auto it = old_to_new.find(v);
+    if (it != old_to_new.end()) {
+      return it->second;
+    }
+    TRTORCH_CHECK(
+        v->node()->kind() == torch::jit::prim::Constant,
+        "Value " << v->debugName() << " is used in segment but was not found in the segment inputs (SegmentedBlock)");
+    auto const_node = g_->createClone(v->node(), [](torch::jit::Value* v) { return v; });
+    g_->prependNode(const_node);
+    old_to_new[v] = const_node->output();
+    return const_node->output();
+  };
+
+  for (auto n : nodes_) {
+    auto new_node = g_->createClone(n, env);
+    g_->appendNode(new_node);
+    for (size_t i = 0; i < n->outputs().size(); i++) {
+      old_to_new[n->outputs()[i]] = new_node->outputs()[i];
+    }
+  }
+
+  for (auto out : outputs_) {
+    g_->registerOutput(env(out));
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const SegmentedBlock::SegmentedBlockTarget& t) {
+  switch (t) {
+    case SegmentedBlock::kTensorRT:
+      return os << "TensorRT";
+    case SegmentedBlock::kTorch:
+    default:
+      return os << "Torch";
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const SegmentedBlock& b) {
+  os << "Segment Block @" << &b << ":" << std::endl;
+  os << "    Target: " << b.target() << std::endl;
+  os << "    Nodes:" << std::endl;
+  for (auto n : b.raw_nodes()) {
+    os << "        " << util::node_info(n) << std::endl;
+  }
+  return os;
+}
+
+} // namespace partitioning
+} // namespace core
+} // namespace trtorch
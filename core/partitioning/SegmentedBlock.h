@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "core/conversion/conversion.h"
+#include "torch/csrc/jit/ir/ir.h"
+
+namespace trtorch {
+namespace core {
+namespace partitioning {
+
+// A maximal run of nodes from a lowered block that will be executed by the
+// same backend. The nodes are the nodes of the source graph, the segment
+// builds its own standalone graph from them once its boundary is known
+struct SegmentedBlock {
+ public:
+  enum SegmentedBlockTarget {
+    kTorch,
+    kTensorRT,
+  };
+
+  SegmentedBlock() = default;
+  SegmentedBlock(SegmentedBlockTarget target) : target_(target) {}
+  SegmentedBlock(SegmentedBlockTarget target, std::vector<torch::jit::Node*> nodes)
+      : target_(target), nodes_(std::move(nodes)) {}
+
+  void AppendNode(torch::jit::Node* n) {
+    nodes_.push_back(n);
+  }
+
+  // Set the values flowing in and out of the segment (in terms of the source
+  // graph) and build the standalone graph for the segment. Inputs of the
+  // standalone graph line up with inputs(), outputs line up with outputs()
+  void BuildGraph(std::vector<torch::jit::Value*> inputs, std::vector<torch::jit::Value*> outputs);
+
+  SegmentedBlockTarget target() const {
+    return target_;
+  }
+  void set_target(SegmentedBlockTarget target) {
+    target_ = target;
+  }
+  bool empty() const {
+    return nodes_.empty();
+  }
+  const std::vector<torch::jit::Node*>& raw_nodes() const {
+    return nodes_;
+  }
+  std::vector<torch::jit::Node*>& raw_nodes() {
+    return nodes_;
+  }
+  const std::vector<torch::jit::Value*>& inputs() const {
+    return inputs_;
+  }
+  const std::vector<torch::jit::Value*>& outputs() const {
+    return outputs_;
+  }
+  std::shared_ptr<torch::jit::Graph>& g() {
+    return g_;
+  }
+
+  // Shapes of the engine inputs (segment inputs that are tensors and not
+  // static parameters) as found by shape analysis
+  void register_in_shapes(std::vector<conversion::InputRange> in_shapes) {
+    in_shapes_ = std::move(in_shapes);
+  }
+  const std::vector<conversion::InputRange>& in_shapes() const {
+    return in_shapes_;
+  }
+
+ private:
+  SegmentedBlockTarget target_ = kTorch;
+  std::vector<torch::jit::Node*> nodes_;
+  std::vector<torch::jit::Value*> inputs_;
+  std::vector<torch::jit::Value*> outputs_;
+  std::vector<conversion::InputRange> in_shapes_;
+  std::shared_ptr<torch::jit::Graph> g_;
+};
+
+std::ostream& operator<<(std::ostream& os, const SegmentedBlock::SegmentedBlockTarget& t);
+std::ostream& operator<<(std::ostream& os, const SegmentedBlock& b);
+
+} // namespace partitioning
+} // namespace core
+} // namespace trtorch
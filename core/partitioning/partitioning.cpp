@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "torch/csrc/jit/runtime/graph_executor.h"
+
+#include "core/conversion/evaluators/evaluators.h"
+#include "core/partitioning/partitioning.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace partitioning {
+namespace {
+using NodeSet = std::unordered_set<torch::jit::Node*>;
+
+bool isTensor(const torch::jit::Value* v) {
+  return v->type()->isSubtypeOf(c10::TensorType::get());
+}
+
+bool isStatic(torch::jit::Value* v, const conversion::GraphParams& static_params) {
+  return static_params.find(v) != static_params.end();
+}
+
+// Inputs of ops that take integer tensors of indices:
+// aten::embedding(%weight, %indices, ...), aten::index_select(%self, %dim, %index), ...
+const std::unordered_map<std::string, size_t>& indexInputs() {
+  static const std::unordered_map<std::string, size_t> index_inputs = {
+      {"aten::embedding", 1}, {"aten::embedding_bag", 1}, {"aten::index_select", 2}, {"aten::gather", 2}};
+  return index_inputs;
+}
+
+// Frozen graphs rarely carry the dtypes of their inputs, those that are not
+// known and not used as indices are assumed to be in the engine's input type
+at::ScalarType inputDType(const torch::jit::Value* in, at::ScalarType default_dtype) {
+  auto type = in->type()->cast<c10::TensorType>();
+  if (type && type->scalarType()) {
+    return *type->scalarType();
+  }
+  for (auto& use : in->uses()) {
+    auto it = indexInputs().find(use.user->kind().toQualString());
+    if (it != indexInputs().end() && it->second == use.offset) {
+      return at::kLong;
+    }
+  }
+  return default_dtype;
+}
+
+bool isSegmentedNode(const torch::jit::Node* n) {
+  // Constants get copied into every segment that uses them and drop nodes
+  // only have meaning to the interpreter, so neither get assigned a segment
+  return n->kind() != torch::jit::prim::Constant && n->kind() != torch::jit::prim::Drop;
+}
+
+// Walks up from a (possibly nested) node to the node in the top level block
+// that contains it
+torch::jit::Node* topLevelNode(torch::jit::Node* n, const torch::jit::Block* b) {
+  while (n && n->owningBlock() != b) {
+    n = n->owningBlock()->owningNode();
+  }
+  return n;
+}
+
+struct Partitioner {
+  Partitioner(torch::jit::Block* b, const conversion::GraphParams& static_params, const PartitionInfo& partition_info)
+      : block_(b), static_params_(static_params), partition_info_(partition_info) {
+    size_t idx = 0;
+    for (auto n : block_->nodes()) {
+      node_index_[n] = idx++;
+    }
+  }
+
+  PartitionedGraph run() {
+    PartitionedGraph segmented_blocks;
+    while (true) {
+      segmented_blocks = segmentNodes();
+      bool changed = resolveNonTensorInputs(segmented_blocks);
+      changed = checkTensorRTBoundaries(segmented_blocks) || changed;
+      if (!changed) {
+        break;
+      }
+      LOG_DEBUG(
+          "Invalid TensorRT segment boundaries found, resegmenting with " << fallback_nodes_.size()
+                                                                          << " nodes forced to fallback (Partitioning)");
+    }
+
+    auto node_sets = segmentNodeSets(segmented_blocks);
+    auto node_segments = nodeSegments(node_sets);
+    for (size_t i = 0; i < segmented_blocks.size(); i++) {
+      auto& seg = segmented_blocks[i];
+      seg.BuildGraph(segmentInputs(seg, node_sets[i]), segmentOutputs(seg, i, node_sets, node_segments));
+      LOG_DEBUG(seg);
+      LOG_GRAPH("Segment " << i << " (" << seg.target() << "): " << *seg.g());
+    }
+    return segmented_blocks;
+  }
+
+ private:
+  bool isConvertible(torch::jit::Node* n) {
+    if (fallback_nodes_.find(n) != fallback_nodes_.end()) {
+      return false;
+    }
+    // Nodes with sub blocks are run in TorchScript, the conversion time
+    // control flow evaluation cannot be mixed with partitioning
+    if (n->blocks().size() != 0) {
+      return false;
+    }
+    for (auto const& op : partition_info_.forced_fallback_operators) {
+      if (op == n->kind().toQualString()) {
+        return false;
+      }
+    }
+    return conversion::OpSupported(n);
+  }
+
+  PartitionedGraph segmentNodes() {
+    PartitionedGraph segmented_blocks;
+    std::vector<torch::jit::Node*> trt_run;
+
+    auto append_to_torch = [&](torch::jit::Node* n) {
+      if (segmented_blocks.empty() || segmented_blocks.back().target() != SegmentedBlock::kTorch) {
+        segmented_blocks.emplace_back(SegmentedBlock::kTorch);
+      }
+      segmented_blocks.back().AppendNode(n);
+    };
+
+    auto finalize_trt_run = [&]() {
+      if (trt_run.empty()) {
+        return;
+      }
+      if (trt_run.size() >= partition_info_.min_block_size) {
+        segmented_blocks.emplace_back(SegmentedBlock::kTensorRT, trt_run);
+      } else {
+        for (auto n : trt_run) {
+          append_to_torch(n);
+        }
+      }
+      trt_run.clear();
+    };
+
+    for (auto n : block_->nodes()) {
+      if (!isSegmentedNode(n)) {
+        continue;
+      }
+      if (isConvertible(n)) {
+        trt_run.push_back(n);
+      } else {
+        finalize_trt_run();
+        append_to_torch(n);
+      }
+    }
+    finalize_trt_run();
+    return segmented_blocks;
+  }
+
+  std::vector<NodeSet> segmentNodeSets(const PartitionedGraph& segmented_blocks) {
+    std::vector<NodeSet> node_sets;
+    for (auto& seg : segmented_blocks) {
+      node_sets.emplace_back(seg.raw_nodes().begin(), seg.raw_nodes().end());
+    }
+    return node_sets;
+  }
+
+  std::unordered_map<torch::jit::Node*, std::vector<size_t>> nodeSegments(const std::vector<NodeSet>& node_sets) {
+    std::unordered_map<torch::jit::Node*, std::vector<size_t>> node_segments;
+    for (size_t i = 0; i < node_sets.size(); i++) {
+      for (auto n : node_sets[i]) {
+        node_segments[n].push_back(i);
+      }
+    }
+    return node_segments;
+  }
+
+  // Values used in the segment (including inside sub blocks) that are
+  // defined outside of it, in order of first use
+  std::vector<torch::jit::Value*> segmentInputs(const SegmentedBlock& seg, const NodeSet& seg_nodes) {
+    std::vector<torch::jit::Value*> inputs;
+    std::unordered_set<torch::jit::Value*> seen;
+    std::function<void(torch::jit::Node*)> visit = [&](torch::jit::Node* n) {
+      for (auto in : n->inputs()) {
+        auto producer = in->node();
+        if (producer->owningBlock() != block_ || producer->kind() == torch::jit::prim::Constant ||
+            seg_nodes.find(producer) != seg_nodes.end()) {
+          continue;
+        }
+        if (seen.insert(in).second) {
+          inputs.push_back(in);
+        }
+      }
+      for (auto sub_b : n->blocks()) {
+        for (auto sub_n : sub_b->nodes()) {
+          visit(sub_n);
+        }
+        visit(sub_b->return_node());
+      }
+    };
+
+    for (auto n : seg.raw_nodes()) {
+      visit(n);
+    }
+    return inputs;
+  }
+
+  // Values defined in the segment that are used by the graph outputs or
+  // another segment which does not have its own copy of the producer
+  std::vector<torch::jit::Value*> segmentOutputs(
+      const SegmentedBlock& seg,
+      size_t seg_idx,
+      const std::vector<NodeSet>& node_sets,
+      std::unordered_map<torch::jit::Node*, std::vector<size_t>>& node_segments) {
+    std::vector<torch::jit::Value*> outputs;
+    for (auto n : seg.raw_nodes()) {
+      for (auto out : n->outputs()) {
+        bool needed = false;
+        for (auto use : out->uses()) {
+          auto user = topLevelNode(use.user, block_);
+          if (user == block_->return_node()) {
+            needed = true;
+          } else if (user && isSegmentedNode(user) && node_sets[seg_idx].find(user) == node_sets[seg_idx].end()) {
+            for (auto user_seg : node_segments[user]) {
+              if (node_sets[user_seg].find(n) == node_sets[user_seg].end()) {
+                needed = true;
+              }
+            }
+          }
+        }
+        if (needed) {
+          outputs.push_back(out);
+        }
+      }
+    }
+    return outputs;
+  }
+
+  bool collectDependencies(
+      torch::jit::Value* v,
+      const SegmentedBlock& seg,
+      const NodeSet& seg_nodes,
+      std::vector<torch::jit::Node*>& deps,
+      NodeSet& visited) {
+    auto p = v->node();
+    if (p->kind() == torch::jit::prim::Constant || p->kind() == torch::jit::prim::Param ||
+        seg_nodes.find(p) != seg_nodes.end() || visited.find(p) != visited.end()) {
+      return true;
+    }
+    if (p->hasSideEffects() || p->blocks().size() != 0) {
+      return false;
+    }
+    if (seg.target() == SegmentedBlock::kTensorRT && !isConvertible(p)) {
+      return false;
+    }
+    visited.insert(p);
+    for (auto in : p->inputs()) {
+      if (!isTensor(in) && !collectDependencies(in, seg, seg_nodes, deps, visited)) {
+        return false;
+      }
+    }
+    deps.push_back(p);
+    return true;
+  }
+
+  // Non tensor values (sizes, lists, scalars) cannot cross into or out of a
+  // TensorRT engine. Recompute them in the consuming segment by copying over
+  // the chain of nodes producing them, stopping at tensors
+  bool resolveNonTensorInputs(PartitionedGraph& segmented_blocks) {
+    bool changed = false;
+    for (auto& seg : segmented_blocks) {
+      NodeSet seg_nodes(seg.raw_nodes().begin(), seg.raw_nodes().end());
+      for (auto in : segmentInputs(seg, seg_nodes)) {
+        if (isTensor(in) || in->node()->kind() == torch::jit::prim::Param) {
+          continue;
+        }
+        std::vector<torch::jit::Node*> deps;
+        NodeSet visited;
+        if (collectDependencies(in, seg, seg_nodes, deps, visited)) {
+          for (auto d : deps) {
+            LOG_GRAPH("Copying " << util::node_info(d) << " into " << seg.target() << " segment (Partitioning)");
+            seg.AppendNode(d);
+            seg_nodes.insert(d);
+          }
+        } else if (seg.target() == SegmentedBlock::kTensorRT) {
+          for (auto use : in->uses()) {
+            auto user = topLevelNode(use.user, block_);
+            if (seg_nodes.find(user) != seg_nodes.end()) {
+              changed = fallback_nodes_.insert(user).second || changed;
+            }
+          }
+        }
+      }
+      std::sort(seg.raw_nodes().begin(), seg.raw_nodes().end(), [&](torch::jit::Node* a, torch::jit::Node* b) {
+        return node_index_[a] < node_index_[b];
+      });
+    }
+    return changed;
+  }
+
+  // TensorRT segments may only take and produce tensors and must have at
+  // least one runtime input, evaluated outputs are also not supported since
+  // they do not have a corresponding ITensor to mark as an engine output
+  bool checkTensorRTBoundaries(PartitionedGraph& segmented_blocks) {
+    bool changed = false;
+    auto node_sets = segmentNodeSets(segmented_blocks);
+    auto node_segments = nodeSegments(node_sets);
+    for (size_t i = 0; i < segmented_blocks.size(); i++) {
+      auto& seg = segmented_blocks[i];
+      if (seg.target() != SegmentedBlock::kTensorRT) {
+        continue;
+      }
+
+      bool has_engine_input = false;
+      for (auto in : segmentInputs(seg, node_sets[i])) {
+        if (isStatic(in, static_params_)) {
+          continue;
+        }
+        if (isTensor(in)) {
+          has_engine_input = true;
+          continue;
+        }
+        LOG_DEBUG("TensorRT segment requires non tensor input " << in->debugName() << ", falling back users");
+        for (auto use : in->uses()) {
+          auto user = topLevelNode(use.user, block_);
+          if (node_sets[i].find(user) != node_sets[i].end()) {
+            changed = fallback_nodes_.insert(user).second || changed;
+          }
+        }
+      }
+
+      for (auto out : segmentOutputs(seg, i, node_sets, node_segments)) {
+        auto producer = out->node();
+        if (!isTensor(out) || conversion::evaluators::shouldEvalAtConversionTime(producer)) {
+          LOG_DEBUG("TensorRT segment cannot produce output " << out->debugName() << ", falling back producer");
+          changed = fallback_nodes_.insert(producer).second || changed;
+        }
+      }
+
+      if (!has_engine_input) {
+        LOG_DEBUG("TensorRT segment has no runtime inputs, falling back segment");
+        for (auto n : seg.raw_nodes()) {
+          changed = fallback_nodes_.insert(n).second || changed;
+        }
+      }
+    }
+    return changed;
+  }
+
+  torch::jit::Block* block_;
+  const conversion::GraphParams& static_params_;
+  const PartitionInfo& partition_info_;
+  std::unordered_map<torch::jit::Node*, size_t> node_index_;
+  NodeSet fallback_nodes_;
+};
+} // namespace
+
+PartitionedGraph SegmentGraph(
+    torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const PartitionInfo& partition_info) {
+  Partitioner partitioner(b, static_params, partition_info);
+  return partitioner.run();
+}
+
+void RunShapeAnalysis(
+    PartitionedGraph& segmented_blocks,
+    torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const std::vector<conversion::InputRange>& input_ranges,
+    at::ScalarType input_dtype) {
+  std::vector<torch::jit::Value*> graph_inputs;
+  for (auto in : b->inputs()) {
+    if (isTensor(in) && !isStatic(in, static_params)) {
+      graph_inputs.push_back(in);
+    }
+  }
+
+  TRTORCH_CHECK(
+      graph_inputs.size() == input_ranges.size(),
+      "Expected dimension specifications for all input tensors"
+          << ", but found " << graph_inputs.size() << " input tensors and " << input_ranges.size()
+          << " dimension specs (partitioning.RunShapeAnalysis)");
+
+  std::vector<at::ScalarType> dtypes;
+  for (auto in : graph_inputs) {
+    dtypes.push_back(inputDType(in, input_dtype));
+  }
+
+  // shapes[segment][engine input][min | opt | max]
+  std::vector<std::vector<std::vector<std::vector<int64_t>>>> shapes(segmented_blocks.size());
+  std::vector<std::function<nvinfer1::Dims(const conversion::InputRange&)>> profiles = {
+      [](const conversion::InputRange& r) { return r.min; },
+      [](const conversion::InputRange& r) { return r.opt; },
+      [](const conversion::InputRange& r) { return r.max; }};
+
+  for (auto& profile : profiles) {
+    std::unordered_map<const torch::jit::Value*, torch::jit::IValue> ivalues_map;
+    for (auto& p : static_params) {
+      ivalues_map[p.first] = p.second;
+    }
+    for (size_t i = 0; i < graph_inputs.size(); i++) {
+      auto shape = util::toVec(profile(input_ranges[i]));
+      auto options = at::TensorOptions().device(at::kCUDA).dtype(dtypes[i]);
+      // Zeros are valid indices for any non empty tensor
+      ivalues_map[graph_inputs[i]] =
+          at::isFloatingType(dtypes[i]) ? at::randn(shape, options) : at::zeros(shape, options);
+    }
+
+    for (size_t s = 0; s < segmented_blocks.size(); s++) {
+      auto& seg = segmented_blocks[s];
+      torch::jit::Stack stack;
+      std::vector<std::vector<int64_t>> in_shapes;
+      for (auto in : seg.inputs()) {
+        auto it = ivalues_map.find(in);
+        TRTORCH_CHECK(
+            it != ivalues_map.end(),
+            "Unable to find value for segment input " << in->debugName() << " (partitioning.RunShapeAnalysis)");
+        if (isTensor(in) && !isStatic(in, static_params)) {
+          in_shapes.push_back(util::toVec(it->second.toTensor().sizes()));
+        }
+        torch::jit::push(stack, it->second);
+      }
+      shapes[s].push_back(in_shapes);
+
+      auto g = seg.g()->copy();
+      torch::jit::GraphExecutor executor(g, "");
+      executor.run(stack);
+      TRTORCH_CHECK(
+          stack.size() == seg.outputs().size(),
+          "Segment produced " << stack.size() << " values but " << seg.outputs().size()
+                              << " were expected (partitioning.RunShapeAnalysis)");
+      for (size_t o = 0; o < seg.outputs().size(); o++) {
+        ivalues_map[seg.outputs()[o]] = stack[o];
+      }
+    }
+  }
+
+  for (size_t s = 0; s < segmented_blocks.size(); s++) {
+    auto& seg = segmented_blocks[s];
+    if (seg.target() != SegmentedBlock::kTensorRT) {
+      continue;
+    }
+    std::vector<conversion::InputRange> in_shapes;
+    for (size_t i = 0; i < shapes[s][0].size(); i++) {
+      in_shapes.push_back(conversion::InputRange(shapes[s][0][i], shapes[s][1][i], shapes[s][2][i]));
+    }
+    seg.register_in_shapes(in_shapes);
+  }
+}
+
+PartitionedGraph Partition(
+    torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const std::vector<conversion::InputRange>& input_ranges,
+    const PartitionInfo& partition_info,
+    at::ScalarType input_dtype) {
+  LOG_DEBUG(partition_info);
+  auto segmented_blocks = SegmentGraph(b, static_params, partition_info);
+  RunShapeAnalysis(segmented_blocks, b, static_params, input_ranges, input_dtype);
+  return segmented_blocks;
+}
+
+} // namespace partitioning
+} // namespace core
+} // namespace trtorch
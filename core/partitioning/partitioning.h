@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include "core/conversion/conversion.h"
+#include "core/partitioning/PartitionInfo.h"
+#include "core/partitioning/SegmentedBlock.h"
+#include "torch/csrc/jit/ir/ir.h"
+
+namespace trtorch {
+namespace core {
+namespace partitioning {
+
+typedef std::vector<SegmentedBlock> PartitionedGraph;
+
+// Splits an already lowered block into an ordered list of segments that are
+// either fully convertible to TensorRT or need to run in TorchScript.
+// Segments are built so that TensorRT segments only exchange tensors with
+// the rest of the graph, non tensor values needed across a boundary are
+// recomputed in the consuming segment when possible or the producing nodes
+// are moved to TorchScript
+PartitionedGraph SegmentGraph(
+    torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const PartitionInfo& partition_info);
+
+// Runs the segments with random inputs in the min, opt and max shapes of
+// the input ranges and records the shapes of tensors flowing into each
+// TensorRT segment. Inputs take the dtype of their type in the graph, inputs
+// used as indices are long and the rest use input_dtype
+void RunShapeAnalysis(
+    PartitionedGraph& segmented_blocks,
+    torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const std::vector<conversion::InputRange>& input_ranges,
+    at::ScalarType input_dtype = at::kFloat);
+
+PartitionedGraph Partition(
+    torch::jit::Block* b,
+    const conversion::GraphParams& static_params,
+    const std::vector<conversion::InputRange>& input_ranges,
+    const PartitionInfo& partition_info,
+    at::ScalarType input_dtype = at::kFloat);
+
+} // namespace partitioning
+} // namespace core
+} // namespace trtorch
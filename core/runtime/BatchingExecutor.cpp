@@ -0,0 +1,196 @@
+#include "core/runtime/BatchingExecutor.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+constexpr int64_t BatchingExecutor::kUnbatchable;
+
+std::vector<at::Tensor> ConcatBatch(const std::vector<std::vector<at::Tensor>>& requests) {
+  TRTORCH_CHECK(!requests.empty(), "Cannot build a batch out of no requests");
+  if (requests.size() == 1) {
+    return requests[0];
+  }
+
+  std::vector<at::Tensor> batch;
+  for (size_t i = 0; i < requests[0].size(); i++) {
+    std::vector<at::Tensor> parts;
+    for (auto& r : requests) {
+      TRTORCH_CHECK(r.size() == requests[0].size(), "Requests in a batch must have the same number of inputs");
+      parts.push_back(r[i]);
+    }
+    batch.push_back(at::cat(parts, 0));
+  }
+  return batch;
+}
+
+std::vector<std::vector<at::Tensor>> ScatterBatch(
+    const std::vector<at::Tensor>& outputs,
+    const std::vector<int64_t>& batch_sizes) {
+  std::vector<std::vector<at::Tensor>> results(batch_sizes.size());
+  if (batch_sizes.size() == 1) {
+    results[0] = outputs;
+    return results;
+  }
+
+  int64_t total = 0;
+  for (auto b : batch_sizes) {
+    total += b;
+  }
+  for (auto& out : outputs) {
+    TRTORCH_CHECK(
+        out.dim() > 0 && out.size(0) == total,
+        "Expected every output of a batched run to have a leading dimension of "
+            << total << " but found an output of shape " << out.sizes());
+    int64_t start = 0;
+    for (size_t r = 0; r < batch_sizes.size(); r++) {
+      results[r].push_back(out.narrow(0, start, batch_sizes[r]));
+      start += batch_sizes[r];
+    }
+  }
+  return results;
+}
+
+BatchingExecutor::BatchingExecutor(RunFn run, BatchingSettings settings)
+    : run_(std::move(run)), settings_(settings) {
+  TRTORCH_CHECK(settings_.max_batch_size > 0, "The maximum batch size for request batching must be at least 1");
+  TRTORCH_CHECK(settings_.max_delay.count() >= 0, "The maximum delay for request batching cannot be negative");
+  worker_ = std::thread([this]() { Work(); });
+}
+
+BatchingExecutor::~BatchingExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+int64_t BatchingExecutor::BatchSize(const std::vector<at::Tensor>& inputs) {
+  if (inputs.empty()) {
+    return kUnbatchable;
+  }
+  for (auto& in : inputs) {
+    if (in.dim() == 0 || in.size(0) != inputs[0].size(0)) {
+      return kUnbatchable;
+    }
+  }
+  return inputs[0].size(0);
+}
+
+bool BatchingExecutor::Compatible(const Request& a, const Request& b) {
+  if (a.batch_size == kUnbatchable || b.batch_size == kUnbatchable || a.inputs.size() != b.inputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.inputs.size(); i++) {
+    auto& x = a.inputs[i];
+    auto& y = b.inputs[i];
+    if (x.scalar_type() != y.scalar_type() || x.device() != y.device() || x.dim() != y.dim() ||
+        x.sizes().slice(1) != y.sizes().slice(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::future<std::vector<at::Tensor>> BatchingExecutor::Submit(std::vector<at::Tensor> inputs) {
+  Request r;
+  r.batch_size = BatchSize(inputs);
+  r.inputs = std::move(inputs);
+  r.enqueued = std::chrono::steady_clock::now();
+  auto future = r.result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TRTORCH_CHECK(!stop_, "Cannot submit requests to a batching executor that is shutting down");
+    queue_.push_back(std::move(r));
+  }
+  cv_.notify_all();
+  return future;
+}
+
+std::vector<size_t> BatchingExecutor::SelectBatch() {
+  auto& first = queue_.front();
+  std::vector<size_t> selected = {0};
+  if (first.batch_size == kUnbatchable || first.batch_size >= settings_.max_batch_size) {
+    return selected;
+  }
+
+  int64_t total = first.batch_size;
+  for (size_t i = 1; i < queue_.size() && total < settings_.max_batch_size; i++) {
+    if (Compatible(first, queue_[i]) && total + queue_[i].batch_size <= settings_.max_batch_size) {
+      selected.push_back(i);
+      total += queue_[i].batch_size;
+    }
+  }
+  return selected;
+}
+
+void BatchingExecutor::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // Only reachable once stopping
+      return;
+    }
+
+    // Wait for the batch to fill up, the oldest request's deadline passing or
+    // shutdown, whichever comes first
+    auto deadline = queue_.front().enqueued + settings_.max_delay;
+    auto selected = SelectBatch();
+    while (!stop_ && std::chrono::steady_clock::now() < deadline) {
+      int64_t total = 0;
+      for (auto i : selected) {
+        total += queue_[i].batch_size;
+      }
+      if (queue_[selected[0]].batch_size == kUnbatchable || total >= settings_.max_batch_size) {
+        break;
+      }
+      cv_.wait_until(lock, deadline);
+      selected = SelectBatch();
+    }
+
+    std::vector<Request> batch;
+    for (auto i : selected) {
+      batch.push_back(std::move(queue_[i]));
+    }
+    // Erase back to front so earlier indices stay valid
+    for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+      queue_.erase(queue_.begin() + *it);
+    }
+
+    lock.unlock();
+    Run(batch);
+    lock.lock();
+  }
+}
+
+void BatchingExecutor::Run(std::vector<Request>& batch) {
+  num_batches_++;
+  num_requests_ += batch.size();
+  // Requests before this one already have their results, a promise can only
+  // be satisfied once
+  size_t next = 0;
+  try {
+    std::vector<std::vector<at::Tensor>> requests;
+    std::vector<int64_t> batch_sizes;
+    for (auto& r : batch) {
+      requests.push_back(std::move(r.inputs));
+      batch_sizes.push_back(r.batch_size);
+    }
+    auto results = ScatterBatch(run_(ConcatBatch(requests)), batch_sizes);
+    for (; next < batch.size(); next++) {
+      batch[next].result.set_value(std::move(results[next]));
+    }
+  } catch (...) {
+    for (; next < batch.size(); next++) {
+      batch[next].result.set_exception(std::current_exception());
+    }
+  }
+}
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ATen/ATen.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+struct BatchingSettings {
+  // Largest batch (sum of the dim 0 sizes of the requests) run at once
+  int64_t max_batch_size = 1;
+  // Longest the oldest queued request waits for others to join its batch
+  std::chrono::microseconds max_delay = std::chrono::microseconds(1000);
+};
+
+// Concatenates the inputs of several requests along dim 0, input i of the
+// batch is made of input i of every request
+std::vector<at::Tensor> ConcatBatch(const std::vector<std::vector<at::Tensor>>& requests);
+
+// Splits each output along dim 0 into one slice per request, the slices are
+// views of the outputs
+std::vector<std::vector<at::Tensor>> ScatterBatch(
+    const std::vector<at::Tensor>& outputs,
+    const std::vector<int64_t>& batch_sizes);
+
+// Queues requests from concurrent callers and runs them together: requests
+// whose inputs only differ in dim 0 are concatenated until the batch is full
+// or the oldest request has waited max_delay, run once and the results are
+// handed back to each caller through its future.
+//
+// Requests are run in order of arrival, a request only skips ahead of older
+// ones that could not have joined the same batch (different trailing shapes
+// or types). Requests that do not fit in a batch on their own, or whose
+// inputs disagree on dim 0, are run alone.
+//
+// The run callback is only ever invoked from the executor's worker thread
+class BatchingExecutor {
+ public:
+  using RunFn = std::function<std::vector<at::Tensor>(std::vector<at::Tensor>)>;
+
+  BatchingExecutor(RunFn run, BatchingSettings settings);
+  BatchingExecutor(const BatchingExecutor&) = delete;
+  BatchingExecutor& operator=(const BatchingExecutor&) = delete;
+  // Runs every request still queued before returning
+  ~BatchingExecutor();
+
+  std::future<std::vector<at::Tensor>> Submit(std::vector<at::Tensor> inputs);
+
+  const BatchingSettings& settings() const {
+    return settings_;
+  }
+  uint64_t num_batches() const {
+    return num_batches_;
+  }
+  uint64_t num_requests() const {
+    return num_requests_;
+  }
+
+ private:
+  struct Request {
+    std::vector<at::Tensor> inputs;
+    // kUnbatchable if the inputs cannot be concatenated with others
+    int64_t batch_size;
+    std::chrono::steady_clock::time_point enqueued;
+    std::promise<std::vector<at::Tensor>> result;
+  };
+  static constexpr int64_t kUnbatchable = -1;
+
+  static int64_t BatchSize(const std::vector<at::Tensor>& inputs);
+  static bool Compatible(const Request& a, const Request& b);
+  // Indices into queue_ of the requests making up the next batch
+  std::vector<size_t> SelectBatch();
+  void Work();
+  void Run(std::vector<Request>& batch);
+
+  RunFn run_;
+  BatchingSettings settings_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stop_ = false;
+  std::atomic<uint64_t> num_batches_{0};
+  std::atomic<uint64_t> num_requests_{0};
+  std::thread worker_;
+};
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+// A fixed capacity pool of execution contexts shared by all callers of a
+// single engine. Contexts are created lazily, only once every existing
+// context is checked out, and are handed out without taking a lock. Callers
+// prefer a free context that last ran on their own stream so a caller
+// issuing back to back requests on one stream keeps reusing one context.
+//
+// Context is left generic so the checkout logic can be exercised without a
+// GPU, the runtime instantiates it with a TensorRT execution context
+template <typename Context>
+class ExecutionContextPool {
+ public:
+  static constexpr int64_t kNoStream = -1;
+  // Times Checkout retries before sleeping when every context is taken
+  static constexpr int kSpinRounds = 16;
+  // Creates the context for a slot, slots are numbered from 0 in the order
+  // they are created
+  using Factory = std::function<Context*(size_t slot)>;
+  using Deleter = std::function<void(Context*)>;
+
+  // Exclusive use of a context, the context is returned to the pool when the
+  // lease is destroyed
+  class Lease {
+   public:
+    Lease(Lease&& other) noexcept
+        : pool_(other.pool_), slot_(other.slot_), ctx_(other.ctx_), last_stream_(other.last_stream_) {
+      other.pool_ = nullptr;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease& operator=(Lease&&) = delete;
+    ~Lease() {
+      if (pool_) {
+        pool_->Return(slot_);
+      }
+    }
+
+    Context* get() const {
+      return ctx_;
+    }
+    Context* operator->() const {
+      return ctx_;
+    }
+    size_t slot() const {
+      return slot_;
+    }
+    // Stream the context was used on by its previous holder (kNoStream for
+    // a freshly created context). Work from that stream may still be in
+    // flight when this differs from the caller's stream
+    int64_t last_stream() const {
+      return last_stream_;
+    }
+
+   private:
+    friend class ExecutionContextPool;
+    Lease(ExecutionContextPool* pool, size_t slot, Context* ctx, int64_t last_stream)
+        : pool_(pool), slot_(slot), ctx_(ctx), last_stream_(last_stream) {}
+
+    ExecutionContextPool* pool_;
+    size_t slot_;
+    Context* ctx_;
+    int64_t last_stream_;
+  };
+
+  ExecutionContextPool(size_t capacity, Factory factory, Deleter deleter)
+      : capacity_(capacity), factory_(std::move(factory)), deleter_(std::move(deleter)), slots_(new Slot[capacity]) {
+    TRTORCH_CHECK(capacity_ > 0, "Execution context pool needs a capacity of at least 1");
+  }
+
+  ExecutionContextPool(const ExecutionContextPool&) = delete;
+  ExecutionContextPool& operator=(const ExecutionContextPool&) = delete;
+
+  // All leases must have been returned by the time the pool is destroyed
+  ~ExecutionContextPool() {
+    for (size_t i = 0; i < size(); i++) {
+      if (slots_[i].ctx) {
+        deleter_(slots_[i].ctx);
+      }
+    }
+  }
+
+  // Only waits if all capacity contexts are checked out, first by yielding a
+  // few times and then by sleeping until a context is returned
+  Lease Checkout(int64_t stream) {
+    size_t slot;
+    for (int i = 0; i < kSpinRounds; i++) {
+      if (TryReserve(stream, &slot)) {
+        return LeaseSlot(slot, stream);
+      }
+      std::this_thread::yield();
+    }
+    {
+      std::unique_lock<std::mutex> lock(wait_mutex_);
+      waiters_.fetch_add(1, std::memory_order_relaxed);
+      // Pairs with the fence in Return, either Return sees the waiter and
+      // notifies or the scan below sees the returned slot
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!TryReserve(stream, &slot)) {
+        returned_.wait(lock);
+      }
+      waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return LeaseSlot(slot, stream);
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  // Number of contexts created so far
+  size_t size() const {
+    auto reserved = reserved_.load(std::memory_order_acquire);
+    return reserved < capacity_ ? reserved : capacity_;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<bool> busy{true};
+    std::atomic<int64_t> last_stream{kNoStream};
+    Context* ctx = nullptr;
+  };
+
+  bool TryAcquire(size_t i) {
+    bool expected = false;
+    return slots_[i].busy.compare_exchange_strong(expected, true, std::memory_order_acquire);
+  }
+
+  // Acquires a free context, preferring one that last ran on stream, or
+  // reserves a new slot if the pool can still grow
+  bool TryReserve(int64_t stream, size_t* slot) {
+    auto num_slots = size();
+    for (size_t i = 0; i < num_slots; i++) {
+      if (slots_[i].last_stream.load(std::memory_order_relaxed) == stream && TryAcquire(i)) {
+        *slot = i;
+        return true;
+      }
+    }
+    for (size_t i = 0; i < num_slots; i++) {
+      if (TryAcquire(i)) {
+        *slot = i;
+        return true;
+      }
+    }
+    size_t reserved = reserved_.load(std::memory_order_relaxed);
+    while (reserved < capacity_) {
+      if (reserved_.compare_exchange_weak(reserved, reserved + 1, std::memory_order_acq_rel)) {
+        // Unconstructed slots start out busy so no one else can take this
+        // one until it is returned
+        *slot = reserved;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Called with slot i acquired. Creates the context of the slot if it does
+  // not have one yet, if that fails the slot is released without a context
+  // (so the next caller to acquire it tries again) and the error is rethrown
+  Lease LeaseSlot(size_t i, int64_t stream) {
+    if (!slots_[i].ctx) {
+      try {
+        auto ctx = factory_(i);
+        TRTORCH_CHECK(ctx, "Unable to create execution context " << i << " for the execution context pool");
+        slots_[i].ctx = ctx;
+      } catch (...) {
+        Return(i);
+        throw;
+      }
+    }
+    return MakeLease(i, stream);
+  }
+
+  Lease MakeLease(size_t i, int64_t stream) {
+    auto last_stream = slots_[i].last_stream.exchange(stream, std::memory_order_relaxed);
+    return Lease(this, i, slots_[i].ctx, last_stream);
+  }
+
+  void Return(size_t i) {
+    slots_[i].busy.store(false, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
+      // Taking the lock ensures a waiter that missed this slot in its scan
+      // is already waiting on the condition variable
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      returned_.notify_one();
+    }
+  }
+
+  size_t capacity_;
+  Factory factory_;
+  Deleter deleter_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> reserved_{0};
+  std::atomic<int> waiters_{0};
+  std::mutex wait_mutex_;
+  std::condition_variable returned_;
+};
+
+template <typename Context>
+constexpr int64_t ExecutionContextPool<Context>::kNoStream;
+template <typename Context>
+constexpr int ExecutionContextPool<Context>::kSpinRounds;
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
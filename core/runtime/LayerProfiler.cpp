@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "core/runtime/LayerProfiler.h"
+#include "core/util/Profiler.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+namespace {
+std::string DescribeNodes(const util::LayerProvenance* provenance, const std::string& layer) {
+  if (!provenance) {
+    return "";
+  }
+  std::stringstream nodes;
+  auto found = provenance->Lookup(layer);
+  for (size_t i = 0; i < found.size(); i++) {
+    auto& node = found[i].second;
+    nodes << (i == 0 ? "" : "; ") << node.kind;
+    if (!node.scope.empty()) {
+      nodes << " in " << node.scope;
+    }
+    if (!node.source.empty()) {
+      nodes << " at " << node.source;
+    }
+  }
+  return nodes.str();
+}
+} // namespace
+
+void LayerProfiler::reportLayerTime(const char* layer_name, float ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(layer_name);
+  if (it == index_.end()) {
+    it = index_.emplace(layer_name, timings_.size()).first;
+    LayerTiming t;
+    t.layer = layer_name;
+    t.min_ms = ms;
+    t.max_ms = ms;
+    timings_.push_back(std::move(t));
+  }
+  auto& t = timings_[it->second];
+  t.num_calls++;
+  t.total_ms += ms;
+  t.min_ms = std::min(t.min_ms, static_cast<double>(ms));
+  t.max_ms = std::max(t.max_ms, static_cast<double>(ms));
+}
+
+void LayerProfiler::RecordRun() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_runs_++;
+}
+
+void LayerProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  timings_.clear();
+  index_.clear();
+  num_runs_ = 0;
+}
+
+std::vector<LayerTiming> LayerProfiler::Timings() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return timings_;
+}
+
+uint64_t LayerProfiler::num_runs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_runs_;
+}
+
+std::string LayerProfiler::Table(const util::LayerProvenance* provenance) const {
+  auto rows = Timings();
+  std::stable_sort(
+      rows.begin(), rows.end(), [](const LayerTiming& a, const LayerTiming& b) { return a.total_ms > b.total_ms; });
+
+  double total_ms = 0;
+  size_t layer_width = 5;
+  for (auto& r : rows) {
+    total_ms += r.total_ms;
+    layer_width = std::max(layer_width, r.layer.size());
+  }
+
+  std::stringstream table;
+  table << "Runs: " << num_runs() << std::endl;
+  table << std::left << std::setw(layer_width) << "Layer" << std::right << std::setw(8) << "Calls" << std::setw(14)
+        << "Total (ms)" << std::setw(14) << "Mean (ms)" << std::setw(14) << "Min (ms)" << std::setw(14) << "Max (ms)"
+        << std::setw(8) << "%" << (provenance ? "  Nodes" : "") << std::endl;
+  table << std::fixed << std::setprecision(3);
+  for (auto& r : rows) {
+    table << std::left << std::setw(layer_width) << r.layer << std::right << std::setw(8) << r.num_calls
+          << std::setw(14) << r.total_ms << std::setw(14) << r.total_ms / r.num_calls << std::setw(14) << r.min_ms
+          << std::setw(14) << r.max_ms << std::setw(8) << std::setprecision(1)
+          << (total_ms > 0 ? 100 * r.total_ms / total_ms : 0) << std::setprecision(3);
+    if (provenance) {
+      table << "  " << DescribeNodes(provenance, r.layer);
+    }
+    table << std::endl;
+  }
+  table << std::left << std::setw(layer_width) << "Total" << std::right << std::setw(8) << "" << std::setw(14)
+        << total_ms << std::endl;
+  return table.str();
+}
+
+std::string LayerProfiler::ToJSON(const util::LayerProvenance* provenance) const {
+  auto rows = Timings();
+  double total_ms = 0;
+  for (auto& r : rows) {
+    total_ms += r.total_ms;
+  }
+
+  std::stringstream json;
+  json << std::fixed << std::setprecision(6);
+  json << "{\"runs\": " << num_runs() << ", \"total_ms\": " << total_ms << ", \"layers\": [";
+  for (size_t i = 0; i < rows.size(); i++) {
+    auto& r = rows[i];
+    json << (i == 0 ? "\n" : ",\n");
+    json << "  {\"name\": \"" << util::EscapeJSON(r.layer) << "\", \"calls\": " << r.num_calls
+         << ", \"total_ms\": " << r.total_ms << ", \"mean_ms\": " << r.total_ms / r.num_calls
+         << ", \"min_ms\": " << r.min_ms << ", \"max_ms\": " << r.max_ms << ", \"nodes\": [";
+    if (provenance) {
+      auto found = provenance->Lookup(r.layer);
+      for (size_t j = 0; j < found.size(); j++) {
+        auto& node = found[j].second;
+        json << (j == 0 ? "" : ", ") << "{\"layer\": \"" << util::EscapeJSON(found[j].first) << "\", \"kind\": \""
+             << util::EscapeJSON(node.kind) << "\", \"scope\": \"" << util::EscapeJSON(node.scope)
+             << "\", \"source\": \"" << util::EscapeJSON(node.source) << "\"}";
+      }
+    }
+    json << "]}";
+  }
+  json << "\n]}\n";
+  return json.str();
+}
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
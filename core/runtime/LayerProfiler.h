@@ -0,0 +1,56 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "NvInfer.h"
+#include "core/util/LayerProvenance.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+// Execution time of one layer of an engine, accumulated across calls
+struct LayerTiming {
+  std::string layer;
+  uint64_t num_calls = 0;
+  double total_ms = 0;
+  double min_ms = 0;
+  double max_ms = 0;
+};
+
+// Accumulates the per layer execution times TensorRT reports for every run of
+// an engine. One profiler is shared by all execution contexts of an engine so
+// reports are thread safe
+class LayerProfiler : public nvinfer1::IProfiler {
+ public:
+  void reportLayerTime(const char* layer_name, float ms) override;
+  // Counts one run of the engine, for the average time per run
+  void RecordRun();
+  void Clear();
+
+  // Layers in the order the engine first ran them
+  std::vector<LayerTiming> Timings() const;
+  uint64_t num_runs() const;
+
+  // Layers slowest first with their share of the total time and the nodes
+  // they were converted from (if provenance is provided)
+  std::string Table(const util::LayerProvenance* provenance = nullptr) const;
+  // {"runs": <n>, "total_ms": <t>, "layers": [{"name": ..., "calls": ...,
+  //   "total_ms": ..., "mean_ms": ..., "min_ms": ..., "max_ms": ...,
+  //   "nodes": [{"layer": ..., "kind": ..., "scope": ..., "source": ...}]}]}
+  // with the layers in execution order
+  std::string ToJSON(const util::LayerProvenance* provenance = nullptr) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<LayerTiming> timings_;
+  std::unordered_map<std::string, size_t> index_;
+  uint64_t num_runs_ = 0;
+};
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+// The shapes each input of an engine accepts under one optimization profile,
+// indexed [input][dim]
+struct ProfileShapes {
+  std::vector<std::vector<int64_t>> min;
+  std::vector<std::vector<int64_t>> opt;
+  std::vector<std::vector<int64_t>> max;
+};
+
+// Picks the optimization profile an engine should run a set of input shapes
+// with. Among the profiles whose [min, max] range contains every input shape
+// the one whose opt shapes are closest (relative to their size, so a batch of
+// 2 is further from an opt batch of 1 than from one of 64) is selected, ties
+// go to the profile with the smallest max volume then the lowest index.
+//
+// Kept free of TensorRT types so selection can be tested without a GPU
+class ProfileSelector {
+ public:
+  static constexpr int64_t kNoProfile = -1;
+
+  ProfileSelector() = default;
+  explicit ProfileSelector(std::vector<ProfileShapes> profiles) : profiles_(std::move(profiles)) {
+    for (size_t p = 0; p < profiles_.size(); p++) {
+      auto& prof = profiles_[p];
+      TRTORCH_CHECK(
+          prof.min.size() == prof.opt.size() && prof.opt.size() == prof.max.size(),
+          "Optimization profile " << p << " does not list min, opt and max shapes for every input");
+      TRTORCH_CHECK(
+          p == 0 || prof.opt.size() == profiles_[0].opt.size(),
+          "Optimization profile " << p << " covers " << prof.opt.size() << " inputs, expected "
+                                  << profiles_[0].opt.size());
+    }
+  }
+
+  size_t num_profiles() const {
+    return profiles_.size();
+  }
+
+  const ProfileShapes& profile(size_t p) const {
+    return profiles_[p];
+  }
+
+  // Returns the index of the best fitting profile for the input shapes
+  // (ordered the same way as the inputs of the profiles) or kNoProfile if no
+  // profile accepts them
+  int64_t Select(const std::vector<std::vector<int64_t>>& input_shapes) const {
+    int64_t best = kNoProfile;
+    double best_distance = 0;
+    double best_volume = 0;
+    for (size_t p = 0; p < profiles_.size(); p++) {
+      if (!Contains(profiles_[p], input_shapes)) {
+        continue;
+      }
+      auto distance = Distance(profiles_[p], input_shapes);
+      auto volume = MaxVolume(profiles_[p]);
+      if (best == kNoProfile || distance < best_distance || (distance == best_distance && volume < best_volume)) {
+        best = static_cast<int64_t>(p);
+        best_distance = distance;
+        best_volume = volume;
+      }
+    }
+    return best;
+  }
+
+  static bool Contains(const ProfileShapes& prof, const std::vector<std::vector<int64_t>>& input_shapes) {
+    if (input_shapes.size() != prof.opt.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < input_shapes.size(); i++) {
+      auto& shape = input_shapes[i];
+      if (shape.size() != prof.min[i].size() || shape.size() != prof.max[i].size()) {
+        return false;
+      }
+      for (size_t d = 0; d < shape.size(); d++) {
+        if (shape[d] < prof.min[i][d] || shape[d] > prof.max[i][d]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  // Sum over every dimension of |log2(shape / opt)|
+  static double Distance(const ProfileShapes& prof, const std::vector<std::vector<int64_t>>& input_shapes) {
+    double distance = 0;
+    for (size_t i = 0; i < input_shapes.size(); i++) {
+      for (size_t d = 0; d < input_shapes[i].size(); d++) {
+        // Zero sized dimensions are treated as 1 so the log stays finite
+        auto s = static_cast<double>(std::max<int64_t>(input_shapes[i][d], 1));
+        auto o = static_cast<double>(std::max<int64_t>(prof.opt[i][d], 1));
+        distance += std::fabs(std::log2(s / o));
+      }
+    }
+    return distance;
+  }
+
+  static double MaxVolume(const ProfileShapes& prof) {
+    double volume = 0;
+    for (auto& shape : prof.max) {
+      double v = 1;
+      for (auto d : shape) {
+        v *= static_cast<double>(d);
+      }
+      volume += v;
+    }
+    return volume;
+  }
+
+  std::vector<ProfileShapes> profiles_;
+};
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
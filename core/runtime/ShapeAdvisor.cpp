@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <limits>
+
+#include "core/runtime/ShapeAdvisor.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+namespace {
+
+struct Cluster {
+  ShapeSignature min;
+  ShapeSignature max;
+  ShapeSignature mode;
+  uint64_t mode_count = 0;
+  uint64_t count = 0;
+  // Elements actually carried by the calls in the cluster
+  double elements = 0;
+};
+
+double Volume(const ShapeSignature& shapes) {
+  double v = 0;
+  for (auto& shape : shapes) {
+    double s = 1;
+    for (auto d : shape) {
+      s *= static_cast<double>(d);
+    }
+    v += s;
+  }
+  return v;
+}
+
+double PaddedElements(const Cluster& c) {
+  return static_cast<double>(c.count) * Volume(c.max);
+}
+
+bool Compatible(const Cluster& a, const Cluster& b) {
+  if (a.max.size() != b.max.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.max.size(); i++) {
+    if (a.max[i].size() != b.max[i].size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Cluster Merge(const Cluster& a, const Cluster& b) {
+  Cluster m = a;
+  for (size_t i = 0; i < m.max.size(); i++) {
+    for (size_t d = 0; d < m.max[i].size(); d++) {
+      m.min[i][d] = std::min(a.min[i][d], b.min[i][d]);
+      m.max[i][d] = std::max(a.max[i][d], b.max[i][d]);
+    }
+  }
+  if (b.mode_count > a.mode_count) {
+    m.mode = b.mode;
+    m.mode_count = b.mode_count;
+  }
+  m.count = a.count + b.count;
+  m.elements = a.elements + b.elements;
+  return m;
+}
+
+// Padded elements added by merging the two clusters
+double MergeCost(const Cluster& a, const Cluster& b) {
+  if (!Compatible(a, b)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return PaddedElements(Merge(a, b)) - PaddedElements(a) - PaddedElements(b);
+}
+
+double Waste(double padded, double elements) {
+  return padded > 0 ? 1.0 - elements / padded : 0;
+}
+
+} // namespace
+
+ShapeAdvice AdviseShapeBuckets(
+    const std::vector<std::pair<ShapeSignature, uint64_t>>& entries,
+    const ShapeAdvisorSettings& settings) {
+  TRTORCH_CHECK(settings.max_buckets > 0, "At least one shape bucket is required");
+  TRTORCH_CHECK(
+      settings.max_padding_waste >= 0 && settings.max_padding_waste < 1,
+      "The maximum padding waste must be a fraction in [0, 1)");
+
+  std::vector<Cluster> clusters;
+  double total_padded = 0;
+  double total_elements = 0;
+  for (auto& e : entries) {
+    if (e.second == 0) {
+      continue;
+    }
+    Cluster c;
+    c.min = c.max = c.mode = e.first;
+    c.mode_count = c.count = e.second;
+    c.elements = static_cast<double>(e.second) * Volume(e.first);
+    total_padded += PaddedElements(c);
+    total_elements += c.elements;
+    clusters.push_back(std::move(c));
+  }
+
+  // costs[i][j] for i < j
+  auto n = clusters.size();
+  std::vector<std::vector<double>> costs(n, std::vector<double>(n, 0));
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = i + 1; j < n; j++) {
+      costs[i][j] = MergeCost(clusters[i], clusters[j]);
+    }
+  }
+
+  std::vector<bool> alive(n, true);
+  auto num_alive = n;
+  while (num_alive > 1) {
+    size_t best_i = 0;
+    size_t best_j = 0;
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; i++) {
+      if (!alive[i]) {
+        continue;
+      }
+      for (size_t j = i + 1; j < n; j++) {
+        if (alive[j] && costs[i][j] < best_cost) {
+          best_cost = costs[i][j];
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+    if (best_cost == std::numeric_limits<double>::infinity()) {
+      // Only signatures of different ranks are left
+      break;
+    }
+
+    bool over_budget = num_alive > settings.max_buckets;
+    bool within_waste = Waste(total_padded + best_cost, total_elements) <= settings.max_padding_waste;
+    if (!over_budget && !within_waste) {
+      break;
+    }
+
+    clusters[best_i] = Merge(clusters[best_i], clusters[best_j]);
+    alive[best_j] = false;
+    num_alive--;
+    total_padded += best_cost;
+    for (size_t k = 0; k < n; k++) {
+      if (alive[k] && k != best_i) {
+        auto cost = MergeCost(clusters[best_i], clusters[k]);
+        if (k < best_i) {
+          costs[k][best_i] = cost;
+        } else {
+          costs[best_i][k] = cost;
+        }
+      }
+    }
+  }
+
+  ShapeAdvice advice;
+  for (size_t i = 0; i < n; i++) {
+    if (!alive[i]) {
+      continue;
+    }
+    auto& c = clusters[i];
+    ShapeBucket b;
+    b.min = c.min;
+    b.opt = c.mode;
+    b.max = c.max;
+    b.count = c.count;
+    b.padding_waste = Waste(PaddedElements(c), c.elements);
+    advice.num_calls += c.count;
+    advice.buckets.push_back(std::move(b));
+  }
+  std::stable_sort(advice.buckets.begin(), advice.buckets.end(), [](const ShapeBucket& a, const ShapeBucket& b) {
+    return a.count > b.count;
+  });
+  advice.padding_waste = Waste(total_padded, total_elements);
+  return advice;
+}
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
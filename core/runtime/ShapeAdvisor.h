@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include "core/runtime/ShapeHistogram.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+// A group of input shape signatures that can be served by one optimization
+// profile (or, with static engines, by padding every input up to max)
+struct ShapeBucket {
+  // Indexed [input][dim], in call order
+  std::vector<std::vector<int64_t>> min;
+  std::vector<std::vector<int64_t>> opt;
+  std::vector<std::vector<int64_t>> max;
+  // Number of recorded calls that fall in the bucket
+  uint64_t count = 0;
+  // Fraction of the elements processed that would be padding if every call
+  // in the bucket was padded up to max
+  double padding_waste = 0;
+};
+
+struct ShapeAdvice {
+  // Most frequently hit bucket first
+  std::vector<ShapeBucket> buckets;
+  uint64_t num_calls = 0;
+  // Padding waste over all calls
+  double padding_waste = 0;
+};
+
+struct ShapeAdvisorSettings {
+  // Upper bound on the number of buckets suggested. It can only be exceeded
+  // when the histogram holds signatures of different ranks, which can never
+  // share a bucket
+  size_t max_buckets = 4;
+  // Buckets keep being merged below max_buckets while the overall padding
+  // waste stays at or under this fraction
+  double max_padding_waste = 0;
+};
+
+// Groups the signatures of a histogram into buckets by repeatedly merging the
+// two buckets whose union adds the fewest padded elements. Each bucket's opt
+// shape is its most frequent signature, which is the shape TensorRT tunes
+// kernels for
+ShapeAdvice AdviseShapeBuckets(
+    const std::vector<std::pair<ShapeSignature, uint64_t>>& entries,
+    const ShapeAdvisorSettings& settings = ShapeAdvisorSettings());
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
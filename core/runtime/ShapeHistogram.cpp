@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <sstream>
+
+#include "core/runtime/ShapeHistogram.h"
+#include "core/util/prelude.h"
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+constexpr size_t ShapeHistogram::kMaxSignatures;
+
+namespace {
+const char kHeader[] = "# trtorch shape histogram v1";
+
+// Unlike getline keeps empty fields, so scalar inputs survive a round trip
+std::vector<std::string> Split(const std::string& s, char delim) {
+  std::vector<std::string> fields;
+  size_t start = 0;
+  while (true) {
+    auto end = s.find(delim, start);
+    fields.push_back(s.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    if (end == std::string::npos) {
+      return fields;
+    }
+    start = end + 1;
+  }
+}
+
+std::vector<int64_t> ParseShape(const std::string& shape_str) {
+  std::vector<int64_t> shape;
+  if (shape_str.empty()) {
+    // Scalar input
+    return shape;
+  }
+  for (auto& dim : Split(shape_str, 'x')) {
+    TRTORCH_CHECK(!dim.empty(), "Malformed shape " << shape_str << " in shape histogram");
+    shape.push_back(std::stoll(dim));
+  }
+  return shape;
+}
+} // namespace
+
+std::string ShapeToString(const std::vector<int64_t>& shape) {
+  std::stringstream ss;
+  for (size_t i = 0; i < shape.size(); i++) {
+    ss << (i == 0 ? "" : "x") << shape[i];
+  }
+  return ss.str();
+}
+
+void ShapeHistogram::Record(const ShapeSignature& shapes, uint64_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_recorded_ += count;
+  auto it = counts_.find(shapes);
+  if (it != counts_.end()) {
+    it->second += count;
+  } else if (counts_.size() < kMaxSignatures) {
+    counts_.emplace(shapes, count);
+  } else {
+    num_overflowed_ += count;
+  }
+}
+
+void ShapeHistogram::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  counts_.clear();
+  num_recorded_ = 0;
+  num_overflowed_ = 0;
+}
+
+std::vector<std::pair<ShapeSignature, uint64_t>> ShapeHistogram::Entries() const {
+  std::vector<std::pair<ShapeSignature, uint64_t>> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.assign(counts_.begin(), counts_.end());
+  }
+  // Stable so signatures with the same count stay in shape order
+  std::stable_sort(entries.begin(), entries.end(), [](const std::pair<ShapeSignature, uint64_t>& a,
+                                                      const std::pair<ShapeSignature, uint64_t>& b) {
+    return a.second > b.second;
+  });
+  return entries;
+}
+
+uint64_t ShapeHistogram::num_recorded() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_recorded_;
+}
+
+uint64_t ShapeHistogram::num_overflowed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_overflowed_;
+}
+
+std::string ShapeHistogram::Serialize() const {
+  std::stringstream ss;
+  ss << kHeader << '\n';
+  ss << "overflow " << num_overflowed() << '\n';
+  for (auto& e : Entries()) {
+    ss << e.second << ' ';
+    for (size_t i = 0; i < e.first.size(); i++) {
+      ss << (i == 0 ? "" : ";") << ShapeToString(e.first[i]);
+    }
+    ss << '\n';
+  }
+  return ss.str();
+}
+
+void ShapeHistogram::Deserialize(const std::string& serialized) {
+  std::stringstream ss(serialized);
+  std::string line;
+  TRTORCH_CHECK(
+      std::getline(ss, line) && line == kHeader, "Expected a shape histogram starting with \"" << kHeader << "\"");
+
+  while (std::getline(ss, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::stringstream line_ss(line);
+    std::string first;
+    line_ss >> first;
+    if (first == "overflow") {
+      uint64_t overflowed = 0;
+      TRTORCH_CHECK(line_ss >> overflowed, "Malformed overflow count in shape histogram: " << line);
+      std::lock_guard<std::mutex> lock(mutex_);
+      num_overflowed_ += overflowed;
+      num_recorded_ += overflowed;
+      continue;
+    }
+
+    uint64_t count = std::stoull(first);
+    std::string shapes_str;
+    line_ss >> shapes_str;
+    ShapeSignature shapes;
+    for (auto& shape_str : Split(shapes_str, ';')) {
+      shapes.push_back(ParseShape(shape_str));
+    }
+    Record(shapes, count);
+  }
+}
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
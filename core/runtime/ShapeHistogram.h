@@ -0,0 +1,56 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace runtime {
+
+// Shapes of every input of one call, in call order
+using ShapeSignature = std::vector<std::vector<int64_t>>;
+
+// Counts how often each input shape signature is seen by an engine. Only
+// kMaxSignatures distinct signatures are tracked so the memory used stays
+// bounded under arbitrary traffic, calls with signatures beyond that are only
+// counted as overflow.
+//
+// The text format produced by Serialize is what the shape advisor consumes:
+//   # trtorch shape histogram v1
+//   overflow <count>
+//   <count> <dim>x<dim>x...;<dim>x...
+// with one line per signature and one ';' separated shape per input
+class ShapeHistogram {
+ public:
+  static constexpr size_t kMaxSignatures = 512;
+
+  ShapeHistogram() = default;
+  ShapeHistogram(const ShapeHistogram&) = delete;
+  ShapeHistogram& operator=(const ShapeHistogram&) = delete;
+
+  void Record(const ShapeSignature& shapes, uint64_t count = 1);
+  void Clear();
+
+  // Signatures with their counts, most frequent first
+  std::vector<std::pair<ShapeSignature, uint64_t>> Entries() const;
+  uint64_t num_recorded() const;
+  uint64_t num_overflowed() const;
+
+  std::string Serialize() const;
+  // Merges a histogram produced by Serialize into this one
+  void Deserialize(const std::string& serialized);
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<ShapeSignature, uint64_t> counts_;
+  uint64_t num_recorded_ = 0;
+  uint64_t num_overflowed_ = 0;
+};
+
+std::string ShapeToString(const std::vector<int64_t>& shape);
+
+} // namespace runtime
+} // namespace core
+} // namespace trtorch
@@ -1,4 +1,9 @@
 #include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
 
 #include "NvInfer.h"
 #include "torch/csrc/jit/frontend/function_schema_parser.h"
@@ -15,20 +20,67 @@ std::string slugify(std::string s) {
   return s;
 }
 
-TRTEngine::TRTEngine(std::string serialized_engine)
-    : logger(
-          std::string("[] - "),
-          util::logging::get_logger().get_reportable_severity(),
-          util::logging::get_logger().get_is_colored_output_on()) {
-  std::string _name = "deserialized_trt";
-  new (this) TRTEngine(_name, serialized_engine);
+constexpr int64_t ProfileSelector::kNoProfile;
+
+namespace {
+std::atomic<uint64_t> max_execution_contexts(4);
+} // namespace
+
+void set_max_execution_contexts(uint64_t max_contexts) {
+  TRTORCH_CHECK(max_contexts > 0, "At least one execution context per engine is required");
+  max_execution_contexts = max_contexts;
+}
+
+uint64_t get_max_execution_contexts() {
+  return max_execution_contexts;
+}
+
+void CudaGraph::Reset() {
+  if (exec) {
+    cudaGraphExecDestroy(exec);
+    exec = nullptr;
+  }
+  if (graph) {
+    cudaGraphDestroy(graph);
+    graph = nullptr;
+  }
+  input_shapes.clear();
+  inputs.clear();
+  outputs.clear();
+}
+
+CudaGraph::~CudaGraph() {
+  Reset();
+}
+
+namespace {
+const std::vector<std::string>& verify_serialization(const std::vector<std::string>& serialized_info) {
+  TRTORCH_CHECK(
+      serialized_info.size() == SERIALIZATION_LEN && serialized_info[ABI_TARGET_IDX] == ABI_VERSION,
+      "Program to be deserialized targets a different TRTorch ABI version (expected "
+          << ABI_VERSION << "), recompile the program with this version of TRTorch");
+  return serialized_info;
+}
+} // namespace
+
+TRTEngine::TRTEngine(std::string serialized_engine) : TRTEngine("deserialized_trt", std::move(serialized_engine)) {}
+
+TRTEngine::TRTEngine(std::vector<std::string> serialized_info)
+    : TRTEngine(
+          verify_serialization(serialized_info)[NAME_IDX],
+          verify_serialization(serialized_info)[ENGINE_IDX],
+          util::LayerProvenance::Deserialize(verify_serialization(serialized_info)[LAYER_PROVENANCE_IDX])) {
+  // The stored name already went through slugify
+  name = serialized_info[NAME_IDX];
+  set_cuda_graph_enabled(serialized_info[CUDA_GRAPH_IDX] == "1");
 }
 
-TRTEngine::TRTEngine(std::string mod_name, std::string serialized_engine)
+TRTEngine::TRTEngine(std::string mod_name, std::string serialized_engine, util::LayerProvenance layer_provenance)
     : logger(
           std::string("[") + mod_name + std::string("_engine] - "),
           util::logging::get_logger().get_reportable_severity(),
-          util::logging::get_logger().get_is_colored_output_on()) {
+          util::logging::get_logger().get_is_colored_output_on()),
+      layer_provenance(std::move(layer_provenance)) {
   rt = nvinfer1::createInferRuntime(logger);
 
   name = slugify(mod_name) + "_engine";
@@ -38,38 +90,285 @@ TRTEngine::TRTEngine(std::string mod_name, std::string serialized_engine)
   // descriptive way (using something associated with the graph maybe)
   id = reinterpret_cast<EngineID>(cuda_engine);
 
-  exec_ctx = cuda_engine->createExecutionContext();
+  // With several optimization profiles TensorRT duplicates every binding once
+  // per profile (named "<name> [profile k]" for k > 0), the bindings of the
+  // first profile are enough to describe the engine's inputs and outputs
+  auto num_profiles = static_cast<int64_t>(cuda_engine->getNbOptimizationProfiles());
+  bindings_per_profile = cuda_engine->getNbBindings() / num_profiles;
 
   uint64_t inputs = 0;
   uint64_t outputs = 0;
 
-  for (int64_t x = 0; x < cuda_engine->getNbBindings(); x++) {
+  for (int64_t x = 0; x < bindings_per_profile; x++) {
     std::string name = cuda_engine->getBindingName(x);
     std::string idx_s = name.substr(name.find("_") + 1);
     uint64_t idx = static_cast<uint64_t>(std::stoi(idx_s));
 
+    BindingInfo info;
+    info.binding = x;
+    info.pyt_idx = idx;
+    info.dtype = util::toATenDType(cuda_engine->getBindingDataType(x));
     if (cuda_engine->bindingIsInput(x)) {
       inputs++;
       in_binding_map[x] = idx;
+      in_bindings.push_back(info);
+      auto dims = cuda_engine->getBindingDimensions(x);
+      for (int i = 0; i < dims.nbDims; i++) {
+        is_dynamic |= dims.d[i] == -1;
+      }
     } else {
       outputs++;
       out_binding_map[x] = idx;
+      out_bindings.push_back(info);
     }
   }
   num_io = std::make_pair(inputs, outputs);
+
+  // Only engines with dynamic inputs have a choice of profile
+  if (!is_dynamic) {
+    num_profiles = 1;
+  }
+
+  std::vector<ProfileShapes> profiles;
+  for (int64_t p = 0; p < num_profiles; p++) {
+    ProfileShapes shapes;
+    for (auto& b : in_bindings) {
+      auto binding = static_cast<int>(b.binding + p * bindings_per_profile);
+      auto profile = static_cast<int>(p);
+      shapes.min.push_back(
+          util::toVec(cuda_engine->getProfileDimensions(binding, profile, nvinfer1::OptProfileSelector::kMIN)));
+      shapes.opt.push_back(
+          util::toVec(cuda_engine->getProfileDimensions(binding, profile, nvinfer1::OptProfileSelector::kOPT)));
+      shapes.max.push_back(
+          util::toVec(cuda_engine->getProfileDimensions(binding, profile, nvinfer1::OptProfileSelector::kMAX)));
+    }
+    profiles.push_back(std::move(shapes));
+  }
+  profile_selector = ProfileSelector(std::move(profiles));
+
+  // A profile can only be bound to one execution context at a time so with
+  // dynamic inputs each profile gets exactly one context, engines with static
+  // inputs can have as many contexts as there are concurrent callers
+  auto max_contexts = is_dynamic ? 1 : get_max_execution_contexts();
+  if (num_profiles > 1) {
+    LOG_DEBUG(logger, "Engine has " << num_profiles << " optimization profiles, using one execution context for each");
+  }
+
+  auto engine = cuda_engine;
+  auto num_bindings = static_cast<size_t>(cuda_engine->getNbBindings());
+  auto per_profile = bindings_per_profile;
+  for (int64_t p = 0; p < num_profiles; p++) {
+    exec_ctx_pools.push_back(std::make_shared<ExecutionContextPool<ExecutionContext>>(
+        max_contexts,
+        [engine, num_bindings, per_profile, p](size_t slot) -> ExecutionContext* {
+          auto exec_ctx = std::unique_ptr<ExecutionContext>(new ExecutionContext());
+          exec_ctx->bindings.resize(num_bindings, nullptr);
+          exec_ctx->profile = p;
+          exec_ctx->binding_offset = p * per_profile;
+          exec_ctx->ctx = engine->createExecutionContext();
+          TRTORCH_CHECK(exec_ctx->ctx, "Unable to create TensorRT execution context");
+          if (p != 0) {
+            TRTORCH_CHECK(
+                exec_ctx->ctx->setOptimizationProfile(static_cast<int>(p)),
+                "Unable to assign optimization profile " << p << " to execution context");
+          }
+          TRTORCH_CHECK(
+              cudaEventCreateWithFlags(&exec_ctx->done, cudaEventDisableTiming) == cudaSuccess,
+              "Unable to create CUDA event for execution context");
+          return exec_ctx.release();
+        },
+        [](ExecutionContext* exec_ctx) {
+          cudaEventDestroy(exec_ctx->done);
+          exec_ctx->ctx->destroy();
+          delete exec_ctx;
+        }));
+  }
 }
 
 TRTEngine& TRTEngine::operator=(const TRTEngine& other) {
   id = other.id;
   rt = other.rt;
   cuda_engine = other.cuda_engine;
-  exec_ctx = other.exec_ctx;
+  exec_ctx_pools = other.exec_ctx_pools;
+  profile_selector = other.profile_selector;
   num_io = other.num_io;
+  bindings_per_profile = other.bindings_per_profile;
+  in_bindings = other.in_bindings;
+  out_bindings = other.out_bindings;
+  is_dynamic = other.is_dynamic;
+  cuda_graph_enabled = other.cuda_graph_enabled.load();
+  shape_recording_enabled = other.shape_recording_enabled.load();
+  shape_histogram = other.shape_histogram;
+  layer_provenance = other.layer_provenance;
+  layer_profiling_enabled = other.layer_profiling_enabled.load();
+  layer_profiler = other.layer_profiler;
   return (*this);
 }
 
+std::vector<std::string> TRTEngine::serialize() {
+  auto serialized_engine = cuda_engine->serialize();
+  std::vector<std::string> serialized_info(SERIALIZATION_LEN);
+  serialized_info[ABI_TARGET_IDX] = ABI_VERSION;
+  serialized_info[NAME_IDX] = name;
+  serialized_info[ENGINE_IDX] = std::string((const char*)serialized_engine->data(), serialized_engine->size());
+  serialized_info[CUDA_GRAPH_IDX] = cuda_graph_enabled ? "1" : "0";
+  serialized_info[LAYER_PROVENANCE_IDX] = layer_provenance.Serialize();
+  serialized_engine->destroy();
+  return serialized_info;
+}
+
+int64_t TRTEngine::select_profile(const std::vector<at::Tensor>& inputs) {
+  if (profile_selector.num_profiles() == 1) {
+    return 0;
+  }
+  std::vector<std::vector<int64_t>> shapes;
+  for (auto& b : in_bindings) {
+    shapes.push_back(inputs[b.pyt_idx].sizes().vec());
+  }
+  auto profile = profile_selector.Select(shapes);
+  if (profile == ProfileSelector::kNoProfile) {
+    std::stringstream ss;
+    for (auto& s : shapes) {
+      ss << c10::IntArrayRef(s) << ' ';
+    }
+    TRTORCH_THROW_ERROR(
+        "Input shapes " << ss.str() << "are not covered by any of the " << profile_selector.num_profiles()
+                        << " optimization profiles of engine " << name);
+  }
+  return profile;
+}
+
+int64_t TRTEngine::get_num_optimization_profiles() {
+  return static_cast<int64_t>(profile_selector.num_profiles());
+}
+
+void TRTEngine::set_cuda_graph_enabled(bool enabled) {
+  if (enabled && is_dynamic) {
+    LOG_WARNING(
+        logger,
+        "CUDA graphs are enabled for an engine with dynamic inputs, a new graph is captured every time the input shapes change");
+  }
+  cuda_graph_enabled = enabled;
+}
+
+int64_t TRTEngine::get_cuda_graph_hits() {
+  return cuda_graph_hits;
+}
+
+int64_t TRTEngine::get_cuda_graph_misses() {
+  return cuda_graph_misses;
+}
+
+int64_t TRTEngine::get_max_batch_size() {
+  int64_t max_batch_size = 0;
+  for (size_t p = 0; p < profile_selector.num_profiles(); p++) {
+    auto& prof = profile_selector.profile(p);
+    int64_t profile_max = std::numeric_limits<int64_t>::max();
+    for (auto& shape : prof.max) {
+      profile_max = std::min(profile_max, shape.empty() ? int64_t(0) : shape[0]);
+    }
+    max_batch_size = std::max(max_batch_size, profile_max);
+  }
+  return max_batch_size;
+}
+
+void TRTEngine::set_dynamic_batching(bool enabled, int64_t max_batch_size, int64_t max_delay_us) {
+  if (!enabled) {
+    // Callers already waiting on the previous executor keep it alive until
+    // their batch has run
+    std::atomic_store(&batching_executor, std::shared_ptr<BatchingExecutor>());
+    return;
+  }
+
+  auto engine_max_batch_size = get_max_batch_size();
+  bool batch_is_dynamic = false;
+  for (size_t p = 0; p < profile_selector.num_profiles(); p++) {
+    for (size_t i = 0; i < profile_selector.profile(p).min.size(); i++) {
+      auto& prof = profile_selector.profile(p);
+      batch_is_dynamic |= !prof.min[i].empty() && prof.min[i][0] < prof.max[i][0];
+    }
+  }
+  TRTORCH_CHECK(
+      is_dynamic && batch_is_dynamic,
+      "Dynamic batching requires an engine compiled with a dynamic batch dimension (dim 0) for its inputs");
+  TRTORCH_CHECK(max_batch_size >= 0, "The maximum batch size for dynamic batching must be 0 or greater");
+  TRTORCH_CHECK(max_delay_us >= 0, "The maximum delay for dynamic batching must be 0 or greater");
+  TRTORCH_CHECK(
+      max_batch_size <= engine_max_batch_size,
+      "Engine " << name << " accepts batches of at most " << engine_max_batch_size << ", cannot batch up to "
+                << max_batch_size);
+
+  BatchingSettings settings;
+  settings.max_batch_size = max_batch_size == 0 ? engine_max_batch_size : max_batch_size;
+  settings.max_delay = std::chrono::microseconds(max_delay_us);
+  LOG_DEBUG(
+      logger,
+      "Batching calls up to batch " << settings.max_batch_size << " with a maximum delay of " << max_delay_us << "us");
+  std::atomic_store(&batching_executor, make_engine_batching_executor(this, settings));
+}
+
+void TRTEngine::set_shape_recording_enabled(bool enabled) {
+  shape_recording_enabled = enabled;
+}
+
+std::string TRTEngine::get_shape_histogram() {
+  return shape_histogram->Serialize();
+}
+
+void TRTEngine::reset_shape_histogram() {
+  shape_histogram->Clear();
+}
+
+std::string TRTEngine::get_layer_provenance() {
+  return layer_provenance.Serialize();
+}
+
+c10::List<c10::Dict<std::string, std::string>> TRTEngine::lookup_layer(std::string layer_name) {
+  c10::List<c10::Dict<std::string, std::string>> nodes;
+  for (auto& l : layer_provenance.Lookup(layer_name)) {
+    c10::Dict<std::string, std::string> node;
+    node.insert("layer", l.first);
+    node.insert("kind", l.second.kind);
+    node.insert("scope", l.second.scope);
+    node.insert("source", l.second.source);
+    node.insert("node", l.second.node);
+    nodes.push_back(std::move(node));
+  }
+  return nodes;
+}
+
+void TRTEngine::set_layer_profiling_enabled(bool enabled) {
+  if (enabled && cuda_graph_enabled) {
+    LOG_WARNING(logger, "CUDA graphs are not used while layers are profiled");
+  }
+  layer_profiling_enabled = enabled;
+}
+
+std::string TRTEngine::get_layer_profile() {
+  return layer_profiler->Table(&layer_provenance);
+}
+
+std::string TRTEngine::get_layer_profile_json() {
+  return layer_profiler->ToJSON(&layer_provenance);
+}
+
+void TRTEngine::dump_layer_profile(std::string path) {
+  std::ofstream out(path);
+  TRTORCH_CHECK(out, "Unable to open " << path << " to write the layer profile of engine " << name);
+  out << get_layer_profile_json();
+  TRTORCH_CHECK(out, "Failed to write the layer profile of engine " << name << " to " << path);
+}
+
+void TRTEngine::reset_layer_profile() {
+  layer_profiler->Clear();
+}
+
 TRTEngine::~TRTEngine() {
-  exec_ctx->destroy();
+  // The batching executor's worker runs on the engine's contexts and has to be
+  // stopped before anything else goes away
+  std::atomic_store(&batching_executor, std::shared_ptr<BatchingExecutor>());
+  // Contexts have to be destroyed before the engine they were created from
+  exec_ctx_pools.clear();
   cuda_engine->destroy();
   rt->destroy();
 }
@@ -88,13 +387,26 @@ static auto TRTORCH_UNUSED TRTEngineTSRegistrtion =
         .def(torch::init<std::string>())
         // TODO: .def("__call__", &TRTEngine::Run)
         // TODO: .def("run", &TRTEngine::Run)
+        .def("get_num_optimization_profiles", &TRTEngine::get_num_optimization_profiles)
+        .def("set_cuda_graph_enabled", &TRTEngine::set_cuda_graph_enabled)
+        .def("get_cuda_graph_hits", &TRTEngine::get_cuda_graph_hits)
+        .def("get_cuda_graph_misses", &TRTEngine::get_cuda_graph_misses)
+        .def("get_max_batch_size", &TRTEngine::get_max_batch_size)
+        .def("set_dynamic_batching", &TRTEngine::set_dynamic_batching)
+        .def("set_shape_recording_enabled", &TRTEngine::set_shape_recording_enabled)
+        .def("get_shape_histogram", &TRTEngine::get_shape_histogram)
+        .def("reset_shape_histogram", &TRTEngine::reset_shape_histogram)
+        .def("get_layer_provenance", &TRTEngine::get_layer_provenance)
+        .def("lookup_layer", &TRTEngine::lookup_layer)
+        .def("set_layer_profiling_enabled", &TRTEngine::set_layer_profiling_enabled)
+        .def("get_layer_profile", &TRTEngine::get_layer_profile)
+        .def("get_layer_profile_json", &TRTEngine::get_layer_profile_json)
+        .def("dump_layer_profile", &TRTEngine::dump_layer_profile)
+        .def("reset_layer_profile", &TRTEngine::reset_layer_profile)
         .def_pickle(
-            [](const c10::intrusive_ptr<TRTEngine>& self) -> std::string {
-              auto serialized_engine = self->cuda_engine->serialize();
-              return std::string((const char*)serialized_engine->data(), serialized_engine->size());
-            },
-            [](std::string seralized_engine) -> c10::intrusive_ptr<TRTEngine> {
-              return c10::make_intrusive<TRTEngine>(std::move(seralized_engine));
+            [](const c10::intrusive_ptr<TRTEngine>& self) -> std::vector<std::string> { return self->serialize(); },
+            [](std::vector<std::string> seralized_info) -> c10::intrusive_ptr<TRTEngine> {
+              return c10::make_intrusive<TRTEngine>(std::move(seralized_info));
             });
 } // namespace
 } // namespace runtime
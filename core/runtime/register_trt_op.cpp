@@ -1,3 +1,6 @@
+#include "ATen/cuda/CUDAEvent.h"
+#include "c10/cuda/CUDACachingAllocator.h"
+#include "c10/cuda/CUDAGuard.h"
 #include "c10/cuda/CUDAStream.h"
 
 #include "torch/csrc/jit/runtime/custom_operator.h"
@@ -10,52 +13,260 @@ namespace trtorch {
 namespace core {
 namespace runtime {
 
-std::vector<at::Tensor> execute_engine(std::vector<at::Tensor> inputs, c10::intrusive_ptr<TRTEngine> compiled_engine) {
+namespace {
+bool input_shapes_match(const CudaGraph& cg, const std::vector<at::Tensor>& inputs, const TRTEngine& engine) {
+  if (cg.exec == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < engine.in_bindings.size(); i++) {
+    if (inputs[engine.in_bindings[i].pyt_idx].sizes() != at::IntArrayRef(cg.input_shapes[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Records the enqueue on a side stream into a CUDA graph, nothing is executed
+bool capture_cuda_graph(ExecutionContext* exec_ctx, const at::Device& device, util::logging::TRTorchLogger& logger) {
+  auto& cg = exec_ctx->cuda_graph;
+  auto capture_stream = c10::cuda::getStreamFromPool(false, device.index());
+  if (cudaStreamBeginCapture(capture_stream, cudaStreamCaptureModeThreadLocal) != cudaSuccess) {
+    LOG_WARNING(logger, "Unable to begin CUDA graph capture");
+    return false;
+  }
+  bool enqueued = exec_ctx->ctx->enqueueV2(exec_ctx->bindings.data(), capture_stream, nullptr);
+  auto capture_status = cudaStreamEndCapture(capture_stream, &cg.graph);
+  if (!enqueued || capture_status != cudaSuccess) {
+    LOG_WARNING(logger, "Unable to capture engine execution into a CUDA graph: " << cudaGetErrorString(capture_status));
+    return false;
+  }
+  if (cudaGraphInstantiate(&cg.exec, cg.graph, nullptr, nullptr, 0) != cudaSuccess) {
+    LOG_WARNING(logger, "Unable to instantiate captured CUDA graph");
+    return false;
+  }
+  return true;
+}
+
+std::vector<at::Tensor> run_engine(
+    std::vector<at::Tensor>& inputs,
+    TRTEngine* compiled_engine,
+    std::vector<at::Tensor>* out) {
   LOG_DEBUG("Attempting to run engine (ID: " << compiled_engine->name << ")");
-  std::vector<void*> gpu_handles;
+  TRTORCH_CHECK(
+      inputs.size() == compiled_engine->num_io.first,
+      "Engine expects " << compiled_engine->num_io.first << " inputs but " << inputs.size() << " were provided");
 
-  std::vector<at::Tensor> contig_inputs{};
-  contig_inputs.reserve(inputs.size());
+  if (compiled_engine->shape_recording_enabled) {
+    ShapeSignature shapes;
+    for (auto& in : inputs) {
+      shapes.push_back(in.sizes().vec());
+    }
+    compiled_engine->shape_histogram->Record(shapes);
+  }
+
+  auto device = inputs[0].device();
+  c10::cuda::CUDAStream stream = c10::cuda::getCurrentCUDAStream(device.index());
 
-  for (size_t i = 0; i < inputs.size(); i++) {
-    uint64_t pyt_idx = compiled_engine->in_binding_map[i];
+  // Binding dimensions are per context, concurrent callers each get their own
+  // from the pool of the profile that best fits the input shapes
+  auto profile = compiled_engine->select_profile(inputs);
+  LOG_DEBUG("Running with optimization profile " << profile);
+  auto exec_ctx = compiled_engine->exec_ctx_pools[profile]->Checkout(stream.id());
+  if (exec_ctx.last_stream() != ExecutionContextPool<ExecutionContext>::kNoStream &&
+      exec_ctx.last_stream() != stream.id()) {
+    // The previous holder may still be using the context's activation memory
+    // on its own stream
     TRTORCH_CHECK(
-        inputs[pyt_idx].is_cuda(),
-        "Expected input tensors to have device cuda, found device " << inputs[pyt_idx].device());
-    auto expected_type = util::toATenDType(compiled_engine->exec_ctx->getEngine().getBindingDataType(i));
+        cudaStreamWaitEvent(stream, exec_ctx->done, 0) == cudaSuccess,
+        "Unable to synchronize execution context with its previous stream");
+  }
+
+  // TensorRT only reports layer times for synchronous execution, which cannot
+  // be captured into a CUDA graph
+  bool profile_layers = compiled_engine->layer_profiling_enabled;
+  exec_ctx->ctx->setProfiler(profile_layers ? compiled_engine->layer_profiler.get() : nullptr);
+
+  // With CUDA graphs the engine always runs on the static buffers captured in
+  // the graph, inputs are copied in and outputs copied out. A graph is only
+  // valid for the input shapes it was captured with
+  auto& cg = exec_ctx->cuda_graph;
+  bool use_graph = compiled_engine->cuda_graph_enabled && !profile_layers;
+  bool graph_hit = false;
+  if (use_graph) {
+    graph_hit = input_shapes_match(cg, inputs, *compiled_engine);
+    if (graph_hit) {
+      compiled_engine->cuda_graph_hits++;
+    } else {
+      compiled_engine->cuda_graph_misses++;
+      cg.Reset();
+    }
+  }
+
+  // Only inputs that are not already contiguous need a copy, it has to stay
+  // alive until the engine is enqueued
+  std::vector<at::Tensor> contig_inputs;
+  for (size_t i = 0; i < compiled_engine->in_bindings.size(); i++) {
+    auto& b = compiled_engine->in_bindings[i];
+    auto& in = inputs[b.pyt_idx];
+    TRTORCH_CHECK(in.is_cuda(), "Expected input tensors to have device cuda, found device " << in.device());
     TRTORCH_CHECK(
-        inputs[pyt_idx].dtype() == expected_type,
-        "Expected input tensors to have type " << expected_type << ", found type " << inputs[pyt_idx].dtype());
-    auto dims = core::util::toDimsPad(inputs[pyt_idx].sizes(), 1);
-    auto shape = core::util::toVec(dims);
-    contig_inputs.push_back(inputs[pyt_idx].view(shape).contiguous());
+        in.scalar_type() == b.dtype, "Expected input tensors to have type " << b.dtype << ", found type " << in.dtype());
+    if (graph_hit) {
+      cg.inputs[i].copy_(in, true);
+      continue;
+    }
+
+    auto binding = b.binding + exec_ctx->binding_offset;
+    auto dims = core::util::toDimsPad(in.sizes(), 1);
     LOG_DEBUG("Input shape: " << dims);
-    compiled_engine->exec_ctx->setBindingDimensions(i, dims);
-    gpu_handles.push_back(contig_inputs.back().data_ptr());
+    exec_ctx->ctx->setBindingDimensions(binding, dims);
+    if (use_graph) {
+      cg.input_shapes.push_back(in.sizes().vec());
+      cg.inputs.push_back(at::empty(in.sizes(), in.options()));
+      cg.inputs.back().copy_(in, true);
+      exec_ctx->bindings[binding] = cg.inputs.back().data_ptr();
+    } else if (in.is_contiguous()) {
+      exec_ctx->bindings[binding] = in.data_ptr();
+    } else {
+      contig_inputs.push_back(in.contiguous());
+      exec_ctx->bindings[binding] = contig_inputs.back().data_ptr();
+    }
   }
 
-  TRTORCH_CHECK(
-      compiled_engine->exec_ctx->allInputDimensionsSpecified(), "Not enough inputs provided (runtime.RunCudaEngine)");
+  TRTORCH_CHECK(exec_ctx->ctx->allInputDimensionsSpecified(), "Not enough inputs provided (runtime.RunCudaEngine)");
+
+  if (out) {
+    TRTORCH_CHECK(
+        out->size() == compiled_engine->num_io.second,
+        "Engine produces " << compiled_engine->num_io.second << " outputs but " << out->size()
+                           << " output tensors were provided");
+  }
 
   std::vector<at::Tensor> outputs(compiled_engine->num_io.second);
-  for (size_t o = inputs.size(); o < (compiled_engine->num_io.first + compiled_engine->num_io.second); o++) {
-    uint64_t pyt_idx = compiled_engine->out_binding_map[o];
-    auto out_shape = compiled_engine->exec_ctx->getBindingDimensions(o);
+  for (auto& b : compiled_engine->out_bindings) {
+    auto binding = b.binding + exec_ctx->binding_offset;
+    auto out_shape = exec_ctx->ctx->getBindingDimensions(binding);
     LOG_DEBUG("Output shape: " << out_shape);
     auto dims = core::util::toVec(out_shape);
-    auto type = util::toATenDType(compiled_engine->exec_ctx->getEngine().getBindingDataType(o));
-    outputs[pyt_idx] = std::move(at::empty(dims, {at::kCUDA}).to(type).contiguous());
-    gpu_handles.push_back(outputs[pyt_idx].data_ptr());
+    if (out) {
+      auto& o = (*out)[b.pyt_idx];
+      TRTORCH_CHECK(
+          o.device() == device, "Expected output tensors to be on device " << device << ", found device " << o.device());
+      TRTORCH_CHECK(
+          o.scalar_type() == b.dtype, "Expected output tensors to have type " << b.dtype << ", found type " << o.dtype());
+      TRTORCH_CHECK(o.is_contiguous(), "Expected output tensors to be contiguous");
+      if (o.sizes() != at::IntArrayRef(dims)) {
+        o.resize_(dims);
+      }
+      outputs[b.pyt_idx] = o;
+    } else {
+      // Allocated directly in the binding type. The caching allocator hands
+      // out blocks from the pool of the current stream and holds back freed
+      // blocks still in use on other streams (see recordStream), so reuse
+      // across calls is stream safe
+      outputs[b.pyt_idx] = at::empty(dims, at::TensorOptions().device(device).dtype(b.dtype));
+    }
+
+    if (!use_graph) {
+      exec_ctx->bindings[binding] = outputs[b.pyt_idx].data_ptr();
+    } else if (!graph_hit) {
+      cg.outputs.push_back(at::empty(dims, at::TensorOptions().device(device).dtype(b.dtype)));
+      exec_ctx->bindings[binding] = cg.outputs.back().data_ptr();
+    }
+  }
+
+  if (graph_hit) {
+    TRTORCH_CHECK(cudaGraphLaunch(cg.exec, stream) == cudaSuccess, "Unable to launch captured CUDA graph");
+  } else if (profile_layers) {
+    // Synchronous execution does not run on the caller's stream, the inputs
+    // have to be ready before it starts
+    stream.synchronize();
+    TRTORCH_CHECK(
+        exec_ctx->ctx->executeV2(exec_ctx->bindings.data()),
+        "Failed to run engine " << compiled_engine->name << " with layer profiling");
+    compiled_engine->layer_profiler->RecordRun();
+  } else {
+    exec_ctx->ctx->enqueueV2(exec_ctx->bindings.data(), stream, nullptr);
   }
 
-  c10::cuda::CUDAStream stream = c10::cuda::getCurrentCUDAStream(inputs[0].device().index());
-  compiled_engine->exec_ctx->enqueueV2(gpu_handles.data(), stream, nullptr);
+  if (use_graph) {
+    for (size_t i = 0; i < compiled_engine->out_bindings.size(); i++) {
+      outputs[compiled_engine->out_bindings[i].pyt_idx].copy_(cg.outputs[i], true);
+    }
+    // The enqueue above already produced this call's results, the capture is
+    // for subsequent calls with the same shapes
+    if (!graph_hit && !capture_cuda_graph(exec_ctx.get(), device, compiled_engine->logger)) {
+      LOG_WARNING(compiled_engine->logger, "Disabling CUDA graphs for engine " << compiled_engine->name);
+      compiled_engine->cuda_graph_enabled = false;
+      cg.Reset();
+    }
+  }
+
+  TRTORCH_CHECK(
+      cudaEventRecord(exec_ctx->done, stream) == cudaSuccess, "Unable to record completion of execution context");
 
   return outputs;
 }
 
+std::vector<at::Tensor> run_batched(std::vector<at::Tensor>& inputs, BatchingExecutor& batcher) {
+  TRTORCH_CHECK(!inputs.empty(), "Engine expects at least one input");
+  auto stream = c10::cuda::getCurrentCUDAStream(inputs[0].device().index());
+  // The batch is assembled and run on the executor's stream, the inputs need
+  // to be ready by the time they get there
+  stream.synchronize();
+  auto outputs = batcher.Submit(std::move(inputs)).get();
+  // Outputs are complete, but were allocated on the executor's stream. Let the
+  // caching allocator know they are now used on the caller's
+  for (auto& o : outputs) {
+    c10::cuda::CUDACachingAllocator::recordStream(o.storage().data_ptr(), stream);
+  }
+  return outputs;
+}
+} // namespace
+
+std::shared_ptr<BatchingExecutor> make_engine_batching_executor(TRTEngine* engine, BatchingSettings settings) {
+  // Only ever called from the executor's worker thread
+  c10::optional<c10::cuda::CUDAStream> run_stream;
+  return std::make_shared<BatchingExecutor>(
+      [engine, run_stream](std::vector<at::Tensor> batch) mutable {
+        auto device = batch[0].device();
+        if (!run_stream || run_stream->device() != device) {
+          run_stream = c10::cuda::getStreamFromPool(false, device.index());
+        }
+        // The batch was concatenated on the worker thread's current stream
+        at::cuda::CUDAEvent batch_ready;
+        batch_ready.record(c10::cuda::getCurrentCUDAStream(device.index()));
+        c10::cuda::CUDAStreamGuard guard(*run_stream);
+        batch_ready.block(*run_stream);
+
+        auto outputs = run_engine(batch, engine, nullptr);
+        // Callers get their slices of the outputs as soon as this returns
+        run_stream->synchronize();
+        return outputs;
+      },
+      settings);
+}
+
+std::vector<at::Tensor> execute_engine(std::vector<at::Tensor> inputs, c10::intrusive_ptr<TRTEngine> compiled_engine) {
+  auto batcher = std::atomic_load(&compiled_engine->batching_executor);
+  if (batcher) {
+    return run_batched(inputs, *batcher);
+  }
+  return run_engine(inputs, compiled_engine.get(), nullptr);
+}
+
+std::vector<at::Tensor> execute_engine_out(
+    std::vector<at::Tensor> inputs,
+    c10::intrusive_ptr<TRTEngine> compiled_engine,
+    std::vector<at::Tensor> out) {
+  // Results go straight into the caller's tensors, so these calls are never
+  // batched with others
+  return run_engine(inputs, compiled_engine.get(), &out);
+}
+
 TORCH_LIBRARY(tensorrt, m) {
   m.def("execute_engine", execute_engine);
+  m.def("execute_engine_out", execute_engine_out);
 }
 
 } // namespace runtime
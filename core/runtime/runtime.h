@@ -1,7 +1,16 @@
 #pragma once
+#include <cuda_runtime.h>
+#include <atomic>
+#include <memory>
 #include <utility>
 #include "ATen/core/function_schema.h"
 #include "NvInfer.h"
+#include "core/runtime/BatchingExecutor.h"
+#include "core/runtime/ExecutionContextPool.h"
+#include "core/runtime/LayerProfiler.h"
+#include "core/runtime/ProfileSelector.h"
+#include "core/runtime/ShapeHistogram.h"
+#include "core/util/LayerProvenance.h"
 #include "core/util/prelude.h"
 #include "torch/custom_class.h"
 
@@ -11,11 +20,74 @@ namespace runtime {
 
 using EngineID = int64_t;
 
+// Version of the layout used to serialize engines into TorchScript modules,
+// bump whenever SerializedInfoIndex changes
+const std::string ABI_VERSION = "2";
+
+typedef enum {
+  ABI_TARGET_IDX = 0,
+  NAME_IDX,
+  ENGINE_IDX,
+  CUDA_GRAPH_IDX,
+  LAYER_PROVENANCE_IDX,
+  SERIALIZATION_LEN, // NEVER USED FOR DATA, USED TO DETERMINE LENGTH OF SERIALIZED INFO
+} SerializedInfoIndex;
+
+// A CUDA graph captured from an enqueue for one set of input shapes, along
+// with the static buffers whose addresses are baked into it
+struct CudaGraph {
+  std::vector<std::vector<int64_t>> input_shapes;
+  // In binding order
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> outputs;
+  cudaGraph_t graph = nullptr;
+  cudaGraphExec_t exec = nullptr;
+
+  CudaGraph() = default;
+  CudaGraph(const CudaGraph&) = delete;
+  CudaGraph& operator=(const CudaGraph&) = delete;
+  ~CudaGraph();
+  void Reset();
+};
+
+struct ExecutionContext {
+  nvinfer1::IExecutionContext* ctx;
+  // Optimization profile bound to the context, the bindings of profile k are
+  // offset by k times the number of bindings per profile
+  int64_t profile;
+  int64_t binding_offset;
+  // Recorded on the caller's stream after every enqueue so that the next
+  // holder of the context can wait for the activations to be free if it runs
+  // on a different stream
+  cudaEvent_t done;
+  // Device pointers for each binding, reused across calls
+  std::vector<void*> bindings;
+  CudaGraph cuda_graph;
+};
+
+struct BindingInfo {
+  // Index of the binding in the engine
+  int64_t binding;
+  // Position of the corresponding tensor in the inputs or outputs of the op
+  uint64_t pyt_idx;
+  at::ScalarType dtype;
+};
+
+// Maximum number of execution contexts created per engine for concurrent
+// callers, applies to engines deserialized after it is set. Engines with
+// dynamic inputs always use one context per optimization profile
+void set_max_execution_contexts(uint64_t max_contexts);
+uint64_t get_max_execution_contexts();
+
 struct TRTEngine : torch::CustomClassHolder {
   // Each engine needs it's own runtime object
   nvinfer1::IRuntime* rt;
   nvinfer1::ICudaEngine* cuda_engine;
-  nvinfer1::IExecutionContext* exec_ctx;
+  // One pool per optimization profile, a profile can only be bound to one
+  // context at a time so engines with dynamic inputs get a single context
+  // for each of their profiles
+  std::vector<std::shared_ptr<ExecutionContextPool<ExecutionContext>>> exec_ctx_pools;
+  ProfileSelector profile_selector;
   std::pair<uint64_t, uint64_t> num_io;
   EngineID id;
   std::string name;
@@ -23,17 +95,99 @@ struct TRTEngine : torch::CustomClassHolder {
 
   std::unordered_map<uint64_t, uint64_t> in_binding_map;
   std::unordered_map<uint64_t, uint64_t> out_binding_map;
+  // Inputs and outputs of the first optimization profile sorted by binding
+  // index, computed once at construction
+  std::vector<BindingInfo> in_bindings;
+  std::vector<BindingInfo> out_bindings;
+  int64_t bindings_per_profile = 0;
+  bool is_dynamic = false;
+
+  // Capture enqueues into CUDA graphs (one per execution context, recaptured
+  // when the input shapes change) and replay them instead of enqueuing
+  std::atomic<bool> cuda_graph_enabled{false};
+  std::atomic<uint64_t> cuda_graph_hits{0};
+  std::atomic<uint64_t> cuda_graph_misses{0};
+
+  // Counts the input shapes of every call while enabled, the histogram is fed
+  // to the shape advisor to pick input ranges for recompilation
+  std::atomic<bool> shape_recording_enabled{false};
+  std::shared_ptr<ShapeHistogram> shape_histogram = std::make_shared<ShapeHistogram>();
+
+  // Set while concurrent calls are batched together along dim 0, only read
+  // and written through std::atomic_load / std::atomic_store
+  std::shared_ptr<BatchingExecutor> batching_executor;
+
+  // Node each layer of the network was converted from, empty for engines that
+  // were not built by TRTorch
+  util::LayerProvenance layer_provenance;
+
+  // Reports the execution time of every layer to layer_profiler while enabled.
+  // TensorRT only profiles synchronous execution, so calls wait for the
+  // engine to finish and bypass CUDA graphs
+  std::atomic<bool> layer_profiling_enabled{false};
+  std::shared_ptr<LayerProfiler> layer_profiler = std::make_shared<LayerProfiler>();
 
   ~TRTEngine();
   TRTEngine(std::string serialized_engine);
-  TRTEngine(std::string mod_name, std::string serialized_engine);
+  TRTEngine(
+      std::string mod_name,
+      std::string serialized_engine,
+      util::LayerProvenance layer_provenance = util::LayerProvenance());
+  TRTEngine(std::vector<std::string> serialized_info);
   TRTEngine& operator=(const TRTEngine& other);
+  std::vector<std::string> serialize();
+
+  // Optimization profile the inputs are run with, only engines with dynamic
+  // inputs can have more than one
+  int64_t select_profile(const std::vector<at::Tensor>& inputs);
+  int64_t get_num_optimization_profiles();
+
+  void set_cuda_graph_enabled(bool enabled);
+  int64_t get_cuda_graph_hits();
+  int64_t get_cuda_graph_misses();
+
+  // Largest dim 0 size accepted for every input by one of the profiles
+  int64_t get_max_batch_size();
+  // Queue calls from concurrent callers and run them as one batch of at most
+  // max_batch_size (0 uses get_max_batch_size()), waiting at most
+  // max_delay_us for a batch to fill up
+  void set_dynamic_batching(bool enabled, int64_t max_batch_size, int64_t max_delay_us);
+
+  void set_shape_recording_enabled(bool enabled);
+  std::string get_shape_histogram();
+  void reset_shape_histogram();
+
+  // Provenance table in the text format of util::LayerProvenance
+  std::string get_layer_provenance();
+  // Nodes behind a layer name reported by the engine (fused layers map to
+  // several nodes), each as a dict with the keys "layer", "kind", "scope",
+  // "source" and "node"
+  c10::List<c10::Dict<std::string, std::string>> lookup_layer(std::string layer_name);
+
+  void set_layer_profiling_enabled(bool enabled);
+  // Time spent in each layer across the profiled calls, as a table with the
+  // slowest layers first or as JSON (see LayerProfiler::ToJSON)
+  std::string get_layer_profile();
+  std::string get_layer_profile_json();
+  void dump_layer_profile(std::string path);
+  void reset_layer_profile();
   // TODO: Implement a call method
   // c10::List<at::Tensor> Run(c10::List<at::Tensor> inputs);
 };
 
 std::vector<at::Tensor> execute_engine(std::vector<at::Tensor> inputs, c10::intrusive_ptr<TRTEngine> compiled_engine);
 
+// Executor running batches on the engine from its own thread and stream. The
+// engine must outlive the executor
+std::shared_ptr<BatchingExecutor> make_engine_batching_executor(TRTEngine* engine, BatchingSettings settings);
+
+// Same as execute_engine but writes the results into caller provided tensors
+// (resized if needed) instead of new tensors from the CUDA caching allocator
+std::vector<at::Tensor> execute_engine_out(
+    std::vector<at::Tensor> inputs,
+    c10::intrusive_ptr<TRTEngine> compiled_engine,
+    std::vector<at::Tensor> out);
+
 } // namespace runtime
 } // namespace core
 } // namespace trtorch
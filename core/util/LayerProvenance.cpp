@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/util/LayerProvenance.h"
+#include "core/util/macros.h"
+
+namespace trtorch {
+namespace core {
+namespace util {
+namespace {
+const char kHeader[] = "# trtorch layer provenance v1";
+const size_t kNumFields = 5;
+
+// Characters that can surround a layer name inside the name TensorRT gives a
+// fused or inserted layer
+const char kNameDelimiters[] = " ,+()[]{}";
+
+bool IsDelimiter(char c) {
+  return std::strchr(kNameDelimiters, c) != nullptr;
+}
+
+std::string Escape(const std::string& s) {
+  std::string escaped;
+  for (auto c : s) {
+    switch (c) {
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\t':
+        escaped += "\\t";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// Splits a line on unescaped tabs and unescapes the fields
+std::vector<std::string> SplitFields(const std::string& line) {
+  std::vector<std::string> fields(1);
+  for (size_t i = 0; i < line.size(); i++) {
+    if (line[i] == '\t') {
+      fields.emplace_back();
+    } else if (line[i] == '\\' && i + 1 < line.size()) {
+      auto c = line[++i];
+      fields.back() += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    } else {
+      fields.back() += line[i];
+    }
+  }
+  return fields;
+}
+} // namespace
+
+void LayerProvenance::Add(std::string layer, NodeProvenance node) {
+  auto it = index_.find(layer);
+  if (it != index_.end()) {
+    layers_[it->second].second = std::move(node);
+    return;
+  }
+  index_[layer] = layers_.size();
+  layers_.emplace_back(std::move(layer), std::move(node));
+}
+
+const NodeProvenance* LayerProvenance::Find(const std::string& layer) const {
+  auto it = index_.find(layer);
+  return it == index_.end() ? nullptr : &layers_[it->second].second;
+}
+
+std::vector<std::pair<std::string, NodeProvenance>> LayerProvenance::Lookup(const std::string& engine_layer) const {
+  if (auto node = Find(engine_layer)) {
+    return {{engine_layer, *node}};
+  }
+
+  // Only called when reporting, a scan over the table is fine
+  std::vector<std::pair<size_t, size_t>> matches;
+  for (size_t i = 0; i < layers_.size(); i++) {
+    auto& name = layers_[i].first;
+    if (name.empty()) {
+      continue;
+    }
+    for (auto pos = engine_layer.find(name); pos != std::string::npos; pos = engine_layer.find(name, pos + 1)) {
+      auto end = pos + name.size();
+      // A match has to cover a whole name, not the prefix of a longer one
+      if ((pos == 0 || IsDelimiter(engine_layer[pos - 1])) &&
+          (end == engine_layer.size() || IsDelimiter(engine_layer[end]))) {
+        matches.emplace_back(pos, i);
+        break;
+      }
+    }
+  }
+  std::sort(matches.begin(), matches.end());
+
+  std::vector<std::pair<std::string, NodeProvenance>> found;
+  for (auto& m : matches) {
+    found.push_back(layers_[m.second]);
+  }
+  return found;
+}
+
+size_t LayerProvenance::size() const {
+  return layers_.size();
+}
+
+bool LayerProvenance::empty() const {
+  return layers_.empty();
+}
+
+std::string LayerProvenance::Serialize() const {
+  std::stringstream ss;
+  ss << kHeader << '\n';
+  for (auto& l : layers_) {
+    auto& node = l.second;
+    ss << Escape(l.first) << '\t' << Escape(node.kind) << '\t' << Escape(node.scope) << '\t' << Escape(node.source)
+       << '\t' << Escape(node.node) << '\n';
+  }
+  return ss.str();
+}
+
+LayerProvenance LayerProvenance::Deserialize(const std::string& serialized) {
+  std::stringstream ss(serialized);
+  std::string line;
+  TRTORCH_CHECK(
+      std::getline(ss, line) && line == kHeader,
+      "Expected a layer provenance table starting with \"" << kHeader << "\"");
+
+  LayerProvenance provenance;
+  while (std::getline(ss, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    auto fields = SplitFields(line);
+    TRTORCH_CHECK(fields.size() == kNumFields, "Malformed entry in layer provenance table: " << line);
+    NodeProvenance node;
+    node.kind = std::move(fields[1]);
+    node.scope = std::move(fields[2]);
+    node.source = std::move(fields[3]);
+    node.node = std::move(fields[4]);
+    provenance.Add(std::move(fields[0]), std::move(node));
+  }
+  return provenance;
+}
+
+} // namespace util
+} // namespace core
+} // namespace trtorch
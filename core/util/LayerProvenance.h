@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace util {
+
+// TorchScript node a TensorRT layer was converted from
+struct NodeProvenance {
+  // e.g. aten::conv2d
+  std::string kind;
+  // Scope of the node from the root (the module path for traced modules),
+  // empty if the node has none
+  std::string scope;
+  // file:line:col of the code the node comes from, empty if unknown
+  std::string source;
+  // The node as printed in the graph
+  std::string node;
+};
+
+// Maps the names of the layers of a network to the nodes they were converted
+// from. TensorRT keeps layer names in the engine, so the names reported by the
+// engine at runtime (e.g. to an IProfiler) can be traced back to the module.
+//
+// The text format produced by Serialize is stored alongside serialized engines:
+//   # trtorch layer provenance v1
+//   <layer>\t<kind>\t<scope>\t<source>\t<node>
+// with one line per layer in the order the layers were added, and tabs,
+// newlines and backslashes in the fields escaped
+class LayerProvenance {
+ public:
+  void Add(std::string layer, NodeProvenance node);
+
+  // Provenance of the network layer with exactly this name, nullptr if unknown
+  const NodeProvenance* Find(const std::string& layer) const;
+
+  // Engine layers are named after the network layers they were built from,
+  // fused layers join those names (e.g. "a + b" or "PWN(a, b)") and layers
+  // inserted by TensorRT extend them (e.g. "a input reformatter 0"). Returns
+  // every known network layer named in the engine layer name, in the order
+  // they appear in it
+  std::vector<std::pair<std::string, NodeProvenance>> Lookup(const std::string& engine_layer) const;
+
+  size_t size() const;
+  bool empty() const;
+
+  std::string Serialize() const;
+  static LayerProvenance Deserialize(const std::string& serialized);
+
+ private:
+  std::vector<std::pair<std::string, NodeProvenance>> layers_;
+  std::unordered_map<std::string, size_t> index_;
+};
+
+} // namespace util
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "core/util/Profiler.h"
+#include "core/util/macros.h"
+
+namespace trtorch {
+namespace core {
+namespace util {
+
+std::string EscapeJSON(const std::string& s) {
+  std::stringstream escaped;
+  for (auto c : s) {
+    switch (c) {
+      case '"':
+        escaped << "\\\"";
+        break;
+      case '\\':
+        escaped << "\\\\";
+        break;
+      case '\n':
+        escaped << "\\n";
+        break;
+      case '\t':
+        escaped << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                  << std::setfill(' ');
+        } else {
+          escaped << c;
+        }
+    }
+  }
+  return escaped.str();
+}
+
+Profiler::Profiler() : origin_(Clock::now()) {}
+
+void Profiler::Record(std::string name, std::string category, Clock::time_point start, Clock::time_point end) {
+  ProfileEvent e;
+  e.name = std::move(name);
+  e.category = std::move(category);
+  e.start_us = std::chrono::duration<double, std::micro>(start - origin_).count();
+  e.duration_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto thread = thread_ids_.emplace(std::this_thread::get_id(), thread_ids_.size()).first;
+  e.thread = thread->second;
+  events_.push_back(std::move(e));
+}
+
+std::vector<ProfileEvent> Profiler::events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_;
+}
+
+std::string Profiler::ChromeTrace() const {
+  auto recorded = events();
+  std::stringstream trace;
+  trace << std::fixed << std::setprecision(3);
+  trace << "{\"traceEvents\": [";
+  for (size_t i = 0; i < recorded.size(); i++) {
+    auto& e = recorded[i];
+    trace << (i == 0 ? "\n" : ",\n");
+    trace << "  {\"name\": \"" << EscapeJSON(e.name) << "\", \"cat\": \"" << EscapeJSON(e.category)
+          << "\", \"ph\": \"X\", \"ts\": " << e.start_us << ", \"dur\": " << e.duration_us
+          << ", \"pid\": 0, \"tid\": " << e.thread << "}";
+  }
+  trace << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  return trace.str();
+}
+
+void Profiler::WriteChromeTrace(const std::string& path) const {
+  std::ofstream out(path);
+  TRTORCH_CHECK(out, "Unable to open " << path << " to write the compilation profile");
+  out << ChromeTrace();
+  TRTORCH_CHECK(out, "Failed to write the compilation profile to " << path);
+}
+
+std::string Profiler::Summary() const {
+  struct Totals {
+    uint64_t count = 0;
+    double total_us = 0;
+    double max_us = 0;
+  };
+  std::map<std::pair<std::string, std::string>, Totals> totals;
+  for (auto& e : events()) {
+    auto& t = totals[{e.category, e.name}];
+    t.count++;
+    t.total_us += e.duration_us;
+    t.max_us = std::max(t.max_us, e.duration_us);
+  }
+
+  std::vector<std::pair<std::pair<std::string, std::string>, Totals>> rows(totals.begin(), totals.end());
+  std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+    return a.second.total_us > b.second.total_us;
+  });
+
+  size_t category_width = 8;
+  size_t name_width = 4;
+  for (auto& r : rows) {
+    category_width = std::max(category_width, r.first.first.size());
+    name_width = std::max(name_width, r.first.second.size());
+  }
+
+  std::stringstream table;
+  table << std::left << std::setw(category_width + 2) << "Category" << std::setw(name_width) << "Name" << std::right
+        << std::setw(8) << "Count" << std::setw(14) << "Total (ms)" << std::setw(14) << "Mean (ms)" << std::setw(14)
+        << "Max (ms)" << std::endl;
+  table << std::fixed << std::setprecision(3);
+  for (auto& r : rows) {
+    auto& t = r.second;
+    table << std::left << std::setw(category_width + 2) << r.first.first << std::setw(name_width) << r.first.second
+          << std::right << std::setw(8) << t.count << std::setw(14) << t.total_us / 1000 << std::setw(14)
+          << t.total_us / 1000 / t.count << std::setw(14) << t.max_us / 1000 << std::endl;
+  }
+  return table.str();
+}
+
+} // namespace util
+} // namespace core
+} // namespace trtorch
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trtorch {
+namespace core {
+namespace util {
+
+struct ProfileEvent {
+  std::string name;
+  // Phase of compilation, e.g. "lowering", "converter" or "evaluator"
+  std::string category;
+  // Relative to the creation of the profiler
+  double start_us = 0;
+  double duration_us = 0;
+  // Index of the thread in order of first use
+  uint64_t thread = 0;
+};
+
+// Collects wall time events of a compilation. Events are aggregated by
+// category and name for a summary and can be exported as a Chrome trace
+// (load it in chrome://tracing or Perfetto). Recording is thread safe so
+// methods compiled concurrently can share a profiler
+class Profiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Records the time between its construction and destruction, does nothing
+  // without a profiler
+  class Scope {
+   public:
+    Scope(Profiler* profiler, std::string name, std::string category)
+        : profiler_(profiler), name_(std::move(name)), category_(std::move(category)) {
+      if (profiler_) {
+        start_ = Clock::now();
+      }
+    }
+    ~Scope() {
+      if (profiler_) {
+        profiler_->Record(std::move(name_), std::move(category_), start_, Clock::now());
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    Profiler* profiler_;
+    std::string name_;
+    std::string category_;
+    Clock::time_point start_;
+  };
+
+  Profiler();
+
+  void Record(std::string name, std::string category, Clock::time_point start, Clock::time_point end);
+
+  std::vector<ProfileEvent> events() const;
+
+  // JSON in the Chrome trace event format
+  std::string ChromeTrace() const;
+
+  void WriteChromeTrace(const std::string& path) const;
+
+  // Table of the time spent per category and name, slowest first
+  std::string Summary() const;
+
+ private:
+  mutable std::mutex mutex_;
+  Clock::time_point origin_;
+  std::vector<ProfileEvent> events_;
+  std::map<std::thread::id, uint64_t> thread_ids_;
+};
+
+// Escapes a string to be embedded in a JSON string literal
+std::string EscapeJSON(const std::string& s);
+
+} // namespace util
+} // namespace core
+} // namespace trtorch
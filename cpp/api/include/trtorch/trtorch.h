@@ -234,6 +234,18 @@ struct TRTORCH_API CompileSpec {
    */
   std::vector<InputRange> input_ranges;
 
+  /**
+   * Further ranges for each input, each one adds an optimization profile to
+   * the engine. additional_input_ranges[i] lists the extra ranges of input i
+   * and every input must list the same number, profile k + 1 is built from
+   * range k of every input (input_ranges being profile 0).
+   *
+   * At runtime the engine picks the profile whose range contains the actual
+   * input shapes and whose optimal shapes are closest to them. Useful when
+   * traffic clusters around a few shapes, e.g. batch 1 and batch 64
+   */
+  std::vector<std::vector<InputRange>> additional_input_ranges;
+
   /**
    * Default operating precision for the engine
    */
@@ -381,6 +393,72 @@ struct TRTORCH_API CompileSpec {
    */
   Device device;
 
+  /**
+   * @brief A struct to hold fallback info
+   */
+  struct TRTORCH_API TorchFallback {
+    /// enable the automatic fallback feature
+    bool enabled = false;
+
+    /// minimum consecutive operation number that needs to be satisfied to convert to TensorRT
+    uint64_t min_block_size = 1;
+
+    /// A list of names of operations that will explicitly run in PyTorch
+    std::vector<std::string> forced_fallback_ops;
+
+    /**
+     * @brief Construct a default Torch Fallback object, fallback will be off
+     */
+    TorchFallback() = default;
+
+    /**
+     * @brief Construct from a bool
+     */
+    TorchFallback(bool enabled) : enabled(enabled) {}
+
+    /**
+     * @brief Constructor for setting min_block_size
+     */
+    TorchFallback(bool enabled, uint64_t min_size) : enabled(enabled), min_block_size(min_size) {}
+  };
+
+  /**
+   * Settings for running unsupported operations in TorchScript between TensorRT engines
+   * (if disabled, the whole method must be convertible)
+   */
+  TorchFallback torch_fallback;
+
+  /**
+   * @brief A struct to hold settings for the on-disk engine cache
+   */
+  struct TRTORCH_API EngineCache {
+    /// reuse engines previously built with the same graph, settings and library versions
+    bool enabled = false;
+
+    /// directory to store cached engines in (created if it does not exist)
+    std::string cache_dir;
+
+    /// maximum total size of the cache in bytes, least recently used engines are evicted past it (0 means unbounded)
+    uint64_t max_size_bytes = 0;
+
+    /**
+     * @brief Construct a default Engine Cache object, caching will be off
+     */
+    EngineCache() = default;
+
+    /**
+     * @brief Construct an enabled engine cache backed by a directory
+     */
+    EngineCache(std::string cache_dir, uint64_t max_size_bytes = 0)
+        : enabled(true), cache_dir(std::move(cache_dir)), max_size_bytes(max_size_bytes) {}
+  };
+
+  /**
+   * Settings for caching serialized engines on disk across compilations
+   * (INT8 engines built with a calibrator are never cached)
+   */
+  EngineCache engine_cache;
+
   /**
    * Sets the restrictions for the engine (CUDA Safety)
    */
@@ -405,8 +483,46 @@ struct TRTORCH_API CompileSpec {
    */
   uint64_t max_batch_size = 0;
 
+  /**
+   * Number of methods of the module to lower and convert concurrently
+   * (0 uses one thread per hardware thread, 1 compiles methods one after another)
+   */
+  uint64_t num_compile_threads = 1;
+
+  /**
+   * Capture engine executions into CUDA graphs and replay them on later calls with the same
+   * input shapes, reducing launch overhead (mainly useful for small static shape engines)
+   */
+  bool use_cuda_graph = false;
+
+  /**
+   * Loops with a constant trip count up to this are unrolled during lowering so tensor
+   * operations in their body can be converted. For nested loops the limit applies to
+   * the trip counts of the nest multiplied out
+   */
+  uint64_t max_unrolled_loop_trip_count = 32;
+
+  /**
+   * Names of lowering passes which are off by default to run anyway (e.g. "UnpackBatchNorm")
+   */
+  std::vector<std::string> enabled_lowering_passes;
+
+  /**
+   * Names of lowering passes (or groups of passes) to skip, unknown names are an error
+   */
+  std::vector<std::string> disabled_lowering_passes;
+
+  /**
+   * Path to write a Chrome trace (chrome://tracing) of the time spent lowering, in each converter
+   * and evaluator and building the engine. A summary table is logged at info level. Empty disables
+   * profiling
+   */
+  std::string conversion_profile_path;
+
   /**
    * Calibration dataloaders for each input for post training quantizatiom
+   * (not needed for models trained with quantization aware training, their fake quantization
+   * provides the dynamic ranges)
    */
   nvinfer1::IInt8Calibrator* ptq_calibrator = nullptr;
 };
@@ -484,4 +600,15 @@ TRTORCH_API std::string ConvertGraphToTRTEngine(
  */
 TRTORCH_API void set_device(const int gpu_id);
 
+/**
+ * @brief Set the maximum number of execution contexts per engine
+ *
+ * @param max_contexts
+ *
+ * Engines create additional execution contexts on demand (up to this limit)
+ * so that threads calling the same compiled module concurrently do not wait
+ * on each other. Applies to engines loaded after it is set (default 4)
+ */
+TRTORCH_API void set_max_execution_contexts(uint64_t max_contexts);
+
 } // namespace trtorch
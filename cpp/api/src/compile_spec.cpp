@@ -76,6 +76,9 @@ std::vector<core::conversion::InputRange> to_vec_internal_input_ranges(std::vect
 
 core::CompileSpec to_internal_compile_spec(CompileSpec external) {
   core::CompileSpec internal(to_vec_internal_input_ranges(external.input_ranges));
+  for (auto& ranges : external.additional_input_ranges) {
+    internal.convert_info.additional_input_ranges.push_back(to_vec_internal_input_ranges(ranges));
+  }
 
   switch (external.op_precision) {
     case CompileSpec::DataType::kChar:
@@ -123,6 +126,20 @@ core::CompileSpec to_internal_compile_spec(CompileSpec external) {
   internal.convert_info.engine_settings.num_avg_timing_iters = external.num_avg_timing_iters;
   internal.convert_info.engine_settings.workspace_size = external.workspace_size;
 
+  internal.partition_info.enabled = external.torch_fallback.enabled;
+  internal.partition_info.min_block_size = external.torch_fallback.min_block_size;
+  internal.partition_info.forced_fallback_operators = external.torch_fallback.forced_fallback_ops;
+  internal.num_compile_threads = external.num_compile_threads;
+  internal.use_cuda_graph = external.use_cuda_graph;
+  internal.lower_info.max_unrolled_loop_trip_count = external.max_unrolled_loop_trip_count;
+  internal.lower_info.enabled_passes = external.enabled_lowering_passes;
+  internal.lower_info.disabled_passes = external.disabled_lowering_passes;
+  internal.conversion_profile_path = external.conversion_profile_path;
+  internal.cache_info.enabled = external.engine_cache.enabled;
+  internal.cache_info.cache_dir = external.engine_cache.cache_dir;
+  internal.cache_info.max_size_bytes = external.engine_cache.max_size_bytes;
+  internal.cache_info.trtorch_version = TRTORCH_VERSION;
+
   if (internal.convert_info.engine_settings.op_precision == nvinfer1::DataType::kINT8) {
     internal.convert_info.engine_settings.calibrator = external.ptq_calibrator;
   } else {
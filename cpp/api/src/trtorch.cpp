@@ -1,6 +1,7 @@
 #include "torch/csrc/jit/api/module.h"
 
 #include "core/compiler.h"
+#include "core/runtime/runtime.h"
 #include "core/util/prelude.h"
 
 #include "trtorch/trtorch.h"
@@ -45,4 +46,8 @@ void set_device(const int gpu_id) {
   core::set_device(gpu_id);
 }
 
+void set_max_execution_contexts(uint64_t max_contexts) {
+  core::runtime::set_max_execution_contexts(max_contexts);
+}
+
 } // namespace trtorch
@@ -0,0 +1,164 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "third_party/args/args.hpp"
+
+#include "core/runtime/ShapeAdvisor.h"
+#include "core/runtime/ShapeHistogram.h"
+
+namespace {
+std::string toTupleString(const std::vector<int64_t>& shape) {
+  std::stringstream ss;
+  ss << '(';
+  for (size_t i = 0; i < shape.size(); i++) {
+    ss << (i == 0 ? "" : ",") << shape[i];
+  }
+  ss << ')';
+  return ss.str();
+}
+
+// Same syntax trtorchc takes for input shapes
+std::string toRangeString(const trtorch::core::runtime::ShapeBucket& b, size_t input) {
+  if (b.min[input] == b.max[input]) {
+    return toTupleString(b.opt[input]);
+  }
+  return "[" + toTupleString(b.min[input]) + ";" + toTupleString(b.opt[input]) + ";" + toTupleString(b.max[input]) +
+      "]";
+}
+
+std::string toPythonRange(const trtorch::core::runtime::ShapeBucket& b, size_t input) {
+  if (b.min[input] == b.max[input]) {
+    return toTupleString(b.opt[input]);
+  }
+  return "{\"min\": " + toTupleString(b.min[input]) + ", \"opt\": " + toTupleString(b.opt[input]) +
+      ", \"max\": " + toTupleString(b.max[input]) + "}";
+}
+
+std::string percent(double fraction) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1) << fraction * 100 << '%';
+  return ss.str();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+  args::ArgumentParser parser(
+      "Suggests input ranges for TRTorch compilation from the input shapes recorded by deployed engines (see TRTEngine.set_shape_recording_enabled)",
+      "");
+  args::HelpFlag help(parser, "help", "Display this help menu", {'h', "help"});
+  args::ValueFlag<int> max_buckets(
+      parser,
+      "num_buckets",
+      "Maximum number of shape buckets (optimization profiles) to suggest (default 4)",
+      {'b', "max-buckets"});
+  args::ValueFlag<double> max_padding_waste(
+      parser,
+      "fraction",
+      "Keep merging buckets while the fraction of padded elements stays at or under this value (default 0)",
+      {'w', "max-padding-waste"});
+  args::Positional<std::string> histogram_path(
+      parser, "histogram_file_path", "Path to a shape histogram saved from TRTEngine.get_shape_histogram()");
+
+  try {
+    parser.ParseCLI(argc, argv);
+  } catch (args::Help) {
+    std::cout << parser;
+    return 0;
+  } catch (args::ParseError e) {
+    std::cerr << e.what() << std::endl;
+    std::cerr << parser;
+    return 1;
+  }
+
+  if (!histogram_path) {
+    std::cerr << "A shape histogram file is required" << std::endl;
+    std::cerr << parser;
+    return 1;
+  }
+
+  std::ifstream in(args::get(histogram_path));
+  if (!in) {
+    std::cerr << "Unable to open shape histogram " << args::get(histogram_path) << std::endl;
+    return 1;
+  }
+  std::stringstream contents;
+  contents << in.rdbuf();
+
+  trtorch::core::runtime::ShapeHistogram hist;
+  trtorch::core::runtime::ShapeAdvisorSettings settings;
+  if (max_buckets) {
+    settings.max_buckets = static_cast<size_t>(args::get(max_buckets));
+  }
+  if (max_padding_waste) {
+    settings.max_padding_waste = args::get(max_padding_waste);
+  }
+
+  trtorch::core::runtime::ShapeAdvice advice;
+  try {
+    hist.Deserialize(contents.str());
+    advice = trtorch::core::runtime::AdviseShapeBuckets(hist.Entries(), settings);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "Shape histogram: " << hist.num_recorded() << " calls, " << hist.Entries().size()
+            << " distinct input shape signatures";
+  if (hist.num_overflowed() != 0) {
+    std::cout << " (" << hist.num_overflowed() << " calls with untracked signatures are not covered)";
+  }
+  std::cout << std::endl << std::endl;
+
+  for (size_t i = 0; i < advice.buckets.size(); i++) {
+    auto& b = advice.buckets[i];
+    std::cout << "Bucket " << i << ": " << b.count << " calls ("
+              << percent(static_cast<double>(b.count) / std::max<uint64_t>(advice.num_calls, 1))
+              << "), padding waste " << percent(b.padding_waste) << std::endl;
+    std::cout << "    trtorchc input shapes:";
+    for (size_t input = 0; input < b.opt.size(); input++) {
+      std::cout << " \"" << toRangeString(b, input) << "\"";
+    }
+    std::cout << std::endl;
+  }
+  std::cout << std::endl
+            << "Padding waste if every call is padded up to the max shape of its bucket: "
+            << percent(advice.padding_waste) << std::endl;
+
+  if (advice.buckets.empty()) {
+    return 0;
+  }
+
+  // Buckets of different ranks cannot be profiles of the same engine
+  bool single_engine = true;
+  for (auto& b : advice.buckets) {
+    single_engine &= b.opt.size() == advice.buckets[0].opt.size();
+    for (size_t input = 0; single_engine && input < b.opt.size(); input++) {
+      single_engine &= b.opt[input].size() == advice.buckets[0].opt[input].size();
+    }
+  }
+  if (!single_engine) {
+    std::cout << "Inputs were recorded with different ranks, each group needs its own engine" << std::endl;
+    return 0;
+  }
+
+  std::cout << std::endl << "Compile spec with one optimization profile per bucket:" << std::endl;
+  std::cout << "    \"input_shapes\": [";
+  for (size_t input = 0; input < advice.buckets[0].opt.size(); input++) {
+    std::cout << (input == 0 ? "" : ", ") << toPythonRange(advice.buckets[0], input);
+  }
+  std::cout << "]," << std::endl;
+  if (advice.buckets.size() > 1) {
+    std::cout << "    \"additional_input_shapes\": [";
+    for (size_t input = 0; input < advice.buckets[0].opt.size(); input++) {
+      std::cout << (input == 0 ? "[" : ", [");
+      for (size_t i = 1; i < advice.buckets.size(); i++) {
+        std::cout << (i == 1 ? "" : ", ") << toPythonRange(advice.buckets[i], input);
+      }
+      std::cout << "]";
+    }
+    std::cout << "]," << std::endl;
+  }
+  return 0;
+}
@@ -166,6 +166,12 @@ int main(int argc, char** argv) {
   args::Flag disable_tf32(
       parser, "disable-tf32", "Prevent Float32 layers from using the TF32 data format", {"disable-tf32"});
 
+  args::Flag use_cuda_graph(
+      parser,
+      "use-cuda-graph",
+      "Replay engine executions from CUDA graphs captured for each input shape",
+      {"use-cuda-graph"});
+
   args::ValueFlag<std::string> op_precision(
       parser,
       "precision",
@@ -199,6 +205,28 @@ int main(int argc, char** argv) {
       parser, "workspace_size", "Maximum size of workspace given to TensorRT", {"workspace-size"});
   args::ValueFlag<int> max_batch_size(
       parser, "max_batch_size", "Maximum batch size (must be >= 1 to be set, 0 means not set)", {"max-batch-size"});
+  args::ValueFlag<int> num_compile_threads(
+      parser,
+      "num_threads",
+      "Number of methods to compile concurrently (0 uses one thread per hardware thread, defaults to 1)",
+      {"num-compile-threads"});
+  args::ValueFlag<int> max_unrolled_loop_trip_count(
+      parser,
+      "trip_count",
+      "Loops with a constant trip count up to this are unrolled during lowering (defaults to 32)",
+      {"max-unrolled-loop-trip-count"});
+  args::ValueFlagList<std::string> enabled_lowering_passes(
+      parser,
+      "pass",
+      "(Repeatable) Lowering pass to run even though it is off by default (e.g. UnpackBatchNorm)",
+      {"enable-lowering-pass"});
+  args::ValueFlagList<std::string> disabled_lowering_passes(
+      parser, "pass", "(Repeatable) Lowering pass to skip (e.g. FuseSiblingLinears)", {"disable-lowering-pass"});
+  args::ValueFlag<std::string> conversion_profile_path(
+      parser,
+      "path",
+      "Write a Chrome trace of the time spent lowering, converting and building the engine to this path, a summary is logged with -v",
+      {"profile-conversion"});
   args::ValueFlag<double> threshold(
       parser,
       "threshold",
@@ -270,6 +298,10 @@ int main(int argc, char** argv) {
     compile_settings.disable_tf32 = true;
   }
 
+  if (use_cuda_graph) {
+    compile_settings.use_cuda_graph = true;
+  }
+
   std::string calibration_cache_file_path = "";
   if (calibration_cache_file) {
     calibration_cache_file_path = resolve_path(args::get(calibration_cache_file));
@@ -362,6 +394,26 @@ int main(int argc, char** argv) {
     compile_settings.max_batch_size = args::get(max_batch_size);
   }
 
+  if (num_compile_threads) {
+    compile_settings.num_compile_threads = args::get(num_compile_threads);
+  }
+
+  if (max_unrolled_loop_trip_count) {
+    compile_settings.max_unrolled_loop_trip_count = args::get(max_unrolled_loop_trip_count);
+  }
+
+  for (const auto& pass : args::get(enabled_lowering_passes)) {
+    compile_settings.enabled_lowering_passes.push_back(pass);
+  }
+
+  for (const auto& pass : args::get(disabled_lowering_passes)) {
+    compile_settings.disabled_lowering_passes.push_back(pass);
+  }
+
+  if (conversion_profile_path) {
+    compile_settings.conversion_profile_path = resolve_path(args::get(conversion_profile_path));
+  }
+
   auto real_input_path = resolve_path(args::get(input_path));
   auto real_output_path = resolve_path(args::get(output_path));
 
@@ -60,6 +60,17 @@ def _parse_input_ranges(input_sizes: List) -> List:
     return parsed_input_sizes
 
 
+def _parse_additional_input_ranges(additional_input_sizes: List, num_inputs: int) -> List:
+    if not isinstance(additional_input_sizes, list) or len(additional_input_sizes) != num_inputs:
+        raise KeyError("Additional input shapes must be a List with one List of sizes or ranges per input")
+
+    parsed_additional_input_sizes = [_parse_input_ranges(i) for i in additional_input_sizes]
+    if len(set(len(i) for i in parsed_additional_input_sizes)) > 1:
+        raise KeyError("Every input must have the same number of additional input shapes")
+
+    return parsed_additional_input_sizes
+
+
 def _parse_op_precision(precision: Any) -> _types.dtype:
     if isinstance(precision, torch.dtype):
         if precision == torch.int8:
@@ -123,6 +134,45 @@ def _parse_device(device_info: Dict[str, Any]) -> trtorch._C.Device:
     return info
 
 
+def _parse_torch_fallback(fallback_info: Dict[str, Any]) -> trtorch._C.TorchFallback:
+    info = trtorch._C.TorchFallback()
+    if "enabled" not in fallback_info:
+        raise KeyError("Enabled is required parameter")
+    else:
+        assert isinstance(fallback_info["enabled"], bool)
+        info.enabled = fallback_info["enabled"]
+
+    if "min_block_size" in fallback_info:
+        assert isinstance(fallback_info["min_block_size"], int)
+        info.min_block_size = fallback_info["min_block_size"]
+
+    if "forced_fallback_ops" in fallback_info:
+        assert isinstance(fallback_info["forced_fallback_ops"], list)
+        info.forced_fallback_operators = fallback_info["forced_fallback_ops"]
+
+    return info
+
+
+def _parse_engine_cache(cache_info: Dict[str, Any]) -> trtorch._C.EngineCache:
+    info = trtorch._C.EngineCache()
+    if "cache_dir" not in cache_info:
+        raise KeyError("cache_dir is required parameter")
+    else:
+        assert isinstance(cache_info["cache_dir"], str)
+        info.cache_dir = cache_info["cache_dir"]
+
+    info.enabled = True
+    if "enabled" in cache_info:
+        assert isinstance(cache_info["enabled"], bool)
+        info.enabled = cache_info["enabled"]
+
+    if "max_size_bytes" in cache_info:
+        assert isinstance(cache_info["max_size_bytes"], int)
+        info.max_size_bytes = cache_info["max_size_bytes"]
+
+    return info
+
+
 def _parse_compile_spec(compile_spec: Dict[str, Any]) -> trtorch._C.CompileSpec:
     info = trtorch._C.CompileSpec()
     if "input_shapes" not in compile_spec:
@@ -132,6 +182,10 @@ def _parse_compile_spec(compile_spec: Dict[str, Any]) -> trtorch._C.CompileSpec:
 
     info.input_ranges = _parse_input_ranges(compile_spec["input_shapes"])
 
+    if "additional_input_shapes" in compile_spec:
+        info.additional_input_ranges = _parse_additional_input_ranges(compile_spec["additional_input_shapes"],
+                                                                      len(info.input_ranges))
+
     if "op_precision" in compile_spec:
         info.op_precision = _parse_op_precision(compile_spec["op_precision"])
 
@@ -154,6 +208,12 @@ def _parse_compile_spec(compile_spec: Dict[str, Any]) -> trtorch._C.CompileSpec:
     if "device" in compile_spec:
         info.device = _parse_device(compile_spec["device"])
 
+    if "torch_fallback" in compile_spec:
+        info.torch_fallback = _parse_torch_fallback(compile_spec["torch_fallback"])
+
+    if "engine_cache" in compile_spec:
+        info.engine_cache = _parse_engine_cache(compile_spec["engine_cache"])
+
     if "capability" in compile_spec:
         assert isinstance(compile_spec["capability"], _types.EngineCapability)
         info.capability = compile_spec["capability"]
@@ -174,6 +234,30 @@ def _parse_compile_spec(compile_spec: Dict[str, Any]) -> trtorch._C.CompileSpec:
         assert type(compile_spec["max_batch_size"]) is int
         info.max_batch_size = compile_spec["max_batch_size"]
 
+    if "num_compile_threads" in compile_spec:
+        assert type(compile_spec["num_compile_threads"]) is int
+        info.num_compile_threads = compile_spec["num_compile_threads"]
+
+    if "use_cuda_graph" in compile_spec:
+        assert type(compile_spec["use_cuda_graph"]) is bool
+        info.use_cuda_graph = compile_spec["use_cuda_graph"]
+
+    if "max_unrolled_loop_trip_count" in compile_spec:
+        assert type(compile_spec["max_unrolled_loop_trip_count"]) is int
+        info.max_unrolled_loop_trip_count = compile_spec["max_unrolled_loop_trip_count"]
+
+    if "enabled_lowering_passes" in compile_spec:
+        assert isinstance(compile_spec["enabled_lowering_passes"], list)
+        info.enabled_lowering_passes = compile_spec["enabled_lowering_passes"]
+
+    if "disabled_lowering_passes" in compile_spec:
+        assert isinstance(compile_spec["disabled_lowering_passes"], list)
+        info.disabled_lowering_passes = compile_spec["disabled_lowering_passes"]
+
+    if "conversion_profile_path" in compile_spec:
+        assert isinstance(compile_spec["conversion_profile_path"], str)
+        info.conversion_profile_path = compile_spec["conversion_profile_path"]
+
     return info
 
 
@@ -198,6 +282,10 @@ def TensorRTCompileSpec(compile_spec: Dict[str, Any]) -> torch.classes.tensorrt.
                                 "max": (1, 3, 1024, 1024)
                             } # Dynamic input shape for input #2
                         ],
+                        "additional_input_shapes": [ # Further ranges per input, each adds an optimization profile picked at runtime
+                            [(2, 3, 224, 224)], # Input #1 of the second profile
+                            [{"min": (2, 3, 224, 224), "opt": (2, 3, 224, 224), "max": (2, 3, 512, 512)}] # Input #2 of the second profile
+                        ],
                         "device": {
                             "device_type": torch.device("cuda"), # Type of device to run engine on (for DLA use trtorch.DeviceType.DLA)
                             "gpu_id": 0, # Target gpu id to run engine (Use Xavier as gpu id for DLA)
@@ -214,6 +302,11 @@ def TensorRTCompileSpec(compile_spec: Dict[str, Any]) -> torch.classes.tensorrt.
                         "num_avg_timing_iters": 1, # Number of averaging timing iterations used to select kernels
                         "workspace_size": 0, # Maximum size of workspace given to TensorRT
                         "max_batch_size": 0, # Maximum batch size (must be >= 1 to be set, 0 means not set)
+                        "use_cuda_graph": False, # Replay engine executions from CUDA graphs captured for each input shape
+                        "max_unrolled_loop_trip_count": 32, # Loops with a constant trip count up to this are unrolled during lowering
+                        "enabled_lowering_passes": ["UnpackBatchNorm"], # Lowering passes to run even though they are off by default
+                        "disabled_lowering_passes": ["FuseSiblingLinears"], # Lowering passes to skip
+                        "conversion_profile_path": "", # Write a Chrome trace of the time spent compiling here (empty to disable)
                     })
                 }
 
@@ -236,6 +329,14 @@ def TensorRTCompileSpec(compile_spec: Dict[str, Any]) -> torch.classes.tensorrt.
         ir.set_max(i.max)
         backend_spec.append_input_range(ir)
 
+    for idx, ranges in enumerate(parsed_spec.additional_input_ranges):
+        for i in ranges:
+            ir = torch.classes.tensorrt.InputRange()
+            ir.set_min(i.min)
+            ir.set_opt(i.opt)
+            ir.set_max(i.max)
+            backend_spec.append_additional_input_range(idx, ir)
+
     d = torch.classes.tensorrt.Device()
     d.set_device_type(int(parsed_spec.device.device_type))
     d.set_gpu_id(parsed_spec.device.gpu_id)
@@ -254,5 +355,10 @@ def TensorRTCompileSpec(compile_spec: Dict[str, Any]) -> torch.classes.tensorrt.
     backend_spec.set_num_avg_timing_iters(parsed_spec.num_avg_timing_iters)
     backend_spec.set_workspace_size(parsed_spec.workspace_size)
     backend_spec.set_max_batch_size(parsed_spec.max_batch_size)
+    backend_spec.set_use_cuda_graph(parsed_spec.use_cuda_graph)
+    backend_spec.set_max_unrolled_loop_trip_count(parsed_spec.max_unrolled_loop_trip_count)
+    backend_spec.set_enabled_lowering_passes(parsed_spec.enabled_lowering_passes)
+    backend_spec.set_disabled_lowering_passes(parsed_spec.disabled_lowering_passes)
+    backend_spec.set_conversion_profile_path(parsed_spec.conversion_profile_path)
 
     return backend_spec
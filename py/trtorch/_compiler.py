@@ -34,6 +34,10 @@ def compile(module: torch.jit.ScriptModule, compile_spec: Any) -> torch.jit.Scri
                             "max": (1, 3, 1024, 1024)
                         } # Dynamic input shape for input #2
                     ],
+                    "additional_input_shapes": [ # Further ranges per input, each adds an optimization profile picked at runtime
+                        [(2, 3, 224, 224)], # Input #1 of the second profile
+                        [{"min": (2, 3, 224, 224), "opt": (2, 3, 224, 224), "max": (2, 3, 512, 512)}] # Input #2 of the second profile
+                    ],
                     "device": {
                         "device_type": torch.device("cuda"), # Type of device to run engine on (for DLA use trtorch.DeviceType.DLA)
                         "gpu_id": 0, # Target gpu id to run engine (Use Xavier as gpu id for DLA)
@@ -41,6 +45,15 @@ def compile(module: torch.jit.ScriptModule, compile_spec: Any) -> torch.jit.Scri
                         "allow_gpu_fallback": false, # (DLA only) Allow layers unsupported on DLA to run on GPU
                     },
                     "op_precision": torch.half, # Operating precision set to FP16
+                    "torch_fallback": {
+                        "enabled": True, # Run unsupported operations in TorchScript between TensorRT engines
+                        "min_block_size": 3, # Minimum number of consecutive supported operations to build an engine for
+                        "forced_fallback_ops": ["aten::max_pool2d"], # Operations that will always run in TorchScript
+                    },
+                    "engine_cache": {
+                        "cache_dir": "/tmp/trtorch_cache", # Directory to reuse built engines from across compilations
+                        "max_size_bytes": 0, # Evict least recently used engines past this size (0 means unbounded)
+                    },
                     "refit": false, # enable refit
                     "debug": false, # enable debuggable engine
                     "strict_types": false, # kernels should strictly run in operating precision
@@ -49,6 +62,12 @@ def compile(module: torch.jit.ScriptModule, compile_spec: Any) -> torch.jit.Scri
                     "num_avg_timing_iters": 1, # Number of averaging timing iterations used to select kernels
                     "workspace_size": 0, # Maximum size of workspace given to TensorRT
                     "max_batch_size": 0, # Maximum batch size (must be >= 1 to be set, 0 means not set)
+                    "num_compile_threads": 1, # Number of methods to compile concurrently (0 uses one thread per hardware thread)
+                    "use_cuda_graph": False, # Replay engine executions from CUDA graphs captured for each input shape
+                    "max_unrolled_loop_trip_count": 32, # Loops with a constant trip count up to this are unrolled during lowering
+                    "enabled_lowering_passes": ["UnpackBatchNorm"], # Lowering passes to run even though they are off by default
+                    "disabled_lowering_passes": ["FuseSiblingLinears"], # Lowering passes to skip
+                    "conversion_profile_path": "", # Write a Chrome trace of the time spent compiling here (empty to disable)
                 }
 
             Input Sizes can be specified as torch sizes, tuples or lists. Op precisions can be specified using
@@ -92,6 +111,10 @@ def convert_method_to_trt_engine(module: torch.jit.ScriptModule, method_name: st
                             "max": (1, 3, 1024, 1024)
                         } # Dynamic input shape for input #2
                     ],
+                    "additional_input_shapes": [ # Further ranges per input, each adds an optimization profile picked at runtime
+                        [(2, 3, 224, 224)], # Input #1 of the second profile
+                        [{"min": (2, 3, 224, 224), "opt": (2, 3, 224, 224), "max": (2, 3, 512, 512)}] # Input #2 of the second profile
+                    ],
                     "device": {
                         "device_type": torch.device("cuda"), # Type of device to run engine on (for DLA use trtorch.DeviceType.DLA)
                         "gpu_id": 0, # Target gpu id to run engine (Use Xavier as gpu id for DLA)
@@ -141,6 +164,19 @@ def check_method_op_support(module: torch.jit.ScriptModule, method_name: str) ->
     return trtorch._C.check_method_op_support(module._c, method_name)
 
 
+def set_max_execution_contexts(max_contexts: int):
+    """Sets the maximum number of execution contexts created per TensorRT engine
+
+    Engines create additional execution contexts on demand (up to this limit) so that threads running the
+    same compiled module concurrently do not wait on each other. Only affects engines loaded after it is called.
+
+    Args:
+        max_contexts (int): Maximum number of execution contexts per engine (default 4)
+    """
+    assert type(max_contexts) is int and max_contexts > 0
+    trtorch._C.set_max_execution_contexts(max_contexts)
+
+
 def dump_build_info():
     """Prints build information about the TRTorch distribution to stdout
     """
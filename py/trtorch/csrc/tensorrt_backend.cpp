@@ -28,7 +28,8 @@ c10::IValue TensorRTBackend::preprocess(c10::IValue mod, c10::impl::GenericDict
     const auto& method_name = it->key();
     auto method = mod_.get_method(method_name);
     auto graph = method.graph();
-    core::lowering::LowerGraph(graph);
+    auto cfg = it->value().toCustomClass<trtorch::pyapi::CompileSpec>()->toInternalCompileSpec();
+    core::lowering::LowerGraph(graph, cfg.lower_info);
   }
 
   return mod_._ivalue();
@@ -50,14 +51,28 @@ c10::impl::GenericDict TensorRTBackend::compile(c10::IValue processed_mod, c10::
     LOG_DEBUG(raw_spec->stringify());
     auto cfg = raw_spec->toInternalCompileSpec();
     auto convert_cfg = std::move(cfg.convert_info);
+    // Lowering already ran in preprocess, only conversion is profiled here
+    if (!cfg.conversion_profile_path.empty()) {
+      convert_cfg.profiler = std::make_shared<core::util::Profiler>();
+    }
     auto graph_and_ivalues = torch::jit::LowerGraph(*g, mod._ivalue());
 
     g = graph_and_ivalues.first;
     auto params = graph_and_ivalues.second;
     auto named_params = core::conversion::get_named_params(g->inputs(), params);
 
-    auto serialized_engine = core::conversion::ConvertBlockToEngine(g->block(), convert_cfg, named_params);
-    auto engine_handle = c10::make_intrusive<core::runtime::TRTEngine>(it->key(), serialized_engine);
+    core::util::LayerProvenance provenance;
+    auto serialized_engine =
+        core::conversion::ConvertBlockToEngine(g->block(), convert_cfg, named_params, &provenance);
+    if (convert_cfg.profiler) {
+      convert_cfg.profiler->WriteChromeTrace(cfg.conversion_profile_path);
+      LOG_INFO(
+          "Wrote the conversion profile of " << method_name << " to " << cfg.conversion_profile_path << ":\n"
+                                             << convert_cfg.profiler->Summary());
+    }
+    auto engine_handle =
+        c10::make_intrusive<core::runtime::TRTEngine>(it->key(), serialized_engine, std::move(provenance));
+    engine_handle->set_cuda_graph_enabled(cfg.use_cuda_graph);
     handles.insert(method.name(), at::IValue(engine_handle));
   }
 
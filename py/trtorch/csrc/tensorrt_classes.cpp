@@ -1,5 +1,6 @@
 
 #include "tensorrt_classes.h"
+#include "cpp/api/include/trtorch/macros.h"
 
 namespace trtorch {
 namespace pyapi {
@@ -98,6 +99,13 @@ core::CompileSpec CompileSpec::toInternalCompileSpec() {
     internal_input_ranges.push_back(i.toInternalInputRange());
   }
   auto info = core::CompileSpec(internal_input_ranges);
+  for (auto& ranges : additional_input_ranges) {
+    std::vector<core::conversion::InputRange> internal_ranges;
+    for (auto i : ranges) {
+      internal_ranges.push_back(i.toInternalInputRange());
+    }
+    info.convert_info.additional_input_ranges.push_back(internal_ranges);
+  }
   info.convert_info.engine_settings.op_precision = toTRTDataType(op_precision);
   info.convert_info.engine_settings.disable_tf32 = disable_tf32;
   info.convert_info.engine_settings.refit = refit;
@@ -117,6 +125,24 @@ core::CompileSpec CompileSpec::toInternalCompileSpec() {
   info.convert_info.engine_settings.workspace_size = workspace_size;
   TRTORCH_CHECK(max_batch_size >= 0, "max_batch_size must be 0 or greater");
   info.convert_info.engine_settings.max_batch_size = max_batch_size;
+  TRTORCH_CHECK(num_compile_threads >= 0, "num_compile_threads must be 0 or greater");
+  info.num_compile_threads = num_compile_threads;
+  info.use_cuda_graph = use_cuda_graph;
+  TRTORCH_CHECK(max_unrolled_loop_trip_count >= 0, "max_unrolled_loop_trip_count must be 0 or greater");
+  info.lower_info.max_unrolled_loop_trip_count = max_unrolled_loop_trip_count;
+  info.lower_info.enabled_passes = enabled_lowering_passes;
+  info.lower_info.disabled_passes = disabled_lowering_passes;
+  info.conversion_profile_path = conversion_profile_path;
+  info.partition_info.enabled = torch_fallback.enabled;
+  TRTORCH_CHECK(torch_fallback.min_block_size >= 1, "min_block_size must be 1 or greater");
+  info.partition_info.min_block_size = torch_fallback.min_block_size;
+  info.partition_info.forced_fallback_operators = torch_fallback.forced_fallback_operators;
+  info.cache_info.enabled = engine_cache.enabled;
+  TRTORCH_CHECK(!engine_cache.enabled || !engine_cache.cache_dir.empty(), "cache_dir must be set to use the engine cache");
+  info.cache_info.cache_dir = engine_cache.cache_dir;
+  TRTORCH_CHECK(engine_cache.max_size_bytes >= 0, "max_size_bytes must be 0 or greater");
+  info.cache_info.max_size_bytes = engine_cache.max_size_bytes;
+  info.cache_info.trtorch_version = TRTORCH_VERSION;
   return info;
 }
 
@@ -128,6 +154,17 @@ std::string CompileSpec::stringify() {
     ss << to_str(i);
   }
   ss << "     ]" << std::endl;
+  if (!additional_input_ranges.empty()) {
+    ss << "     \"Additional Input Shapes\": [" << std::endl;
+    for (size_t i = 0; i < additional_input_ranges.size(); i++) {
+      ss << "        Input " << i << ": [" << std::endl;
+      for (auto r : additional_input_ranges[i]) {
+        ss << to_str(r);
+      }
+      ss << "        ]" << std::endl;
+    }
+    ss << "     ]" << std::endl;
+  }
   ss << "     \"Op Precision\": " << to_str(op_precision) << std::endl;
   ss << "     \"TF32 Disabled\": " << disable_tf32 << std::endl;
   ss << "     \"Refit\": " << refit << std::endl;
@@ -142,6 +179,34 @@ std::string CompileSpec::stringify() {
   ss << "     \"Num Avg Timing Iters\": " << num_avg_timing_iters << std::endl;
   ss << "     \"Workspace Size\": " << workspace_size << std::endl;
   ss << "     \"Max Batch Size\": " << max_batch_size << std::endl;
+  ss << "     \"Num Compile Threads\": " << num_compile_threads << std::endl;
+  ss << "     \"Use CUDA Graph\": " << use_cuda_graph << std::endl;
+  ss << "     \"Max Unrolled Loop Trip Count\": " << max_unrolled_loop_trip_count << std::endl;
+  ss << "     \"Enabled Lowering Passes\": [" << std::endl;
+  for (auto pass : enabled_lowering_passes) {
+    ss << "        " << pass << ',' << std::endl;
+  }
+  ss << "     ]" << std::endl;
+  ss << "     \"Disabled Lowering Passes\": [" << std::endl;
+  for (auto pass : disabled_lowering_passes) {
+    ss << "        " << pass << ',' << std::endl;
+  }
+  ss << "     ]" << std::endl;
+  ss << "     \"Conversion Profile Path\": " << conversion_profile_path << std::endl;
+  ss << "     \"Torch Fallback\": " << torch_fallback.enabled << std::endl;
+  if (torch_fallback.enabled) {
+    ss << "     \"Min Block Size\": " << torch_fallback.min_block_size << std::endl;
+    ss << "     \"Forced Fallback Operators\": [" << std::endl;
+    for (auto op : torch_fallback.forced_fallback_operators) {
+      ss << "        " << op << ',' << std::endl;
+    }
+    ss << "     ]" << std::endl;
+  }
+  ss << "     \"Engine Cache\": " << engine_cache.enabled << std::endl;
+  if (engine_cache.enabled) {
+    ss << "     \"Cache Directory\": " << engine_cache.cache_dir << std::endl;
+    ss << "     \"Max Cache Size\": " << engine_cache.max_size_bytes << std::endl;
+  }
   ss << "}";
   return ss.str();
 }
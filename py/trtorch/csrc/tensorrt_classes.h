@@ -75,6 +75,28 @@ struct Device : torch::CustomClassHolder {
   ADD_FIELD_GET_SET(allow_gpu_fallback, bool);
 };
 
+struct TorchFallback : torch::CustomClassHolder {
+  bool enabled;
+  int64_t min_block_size;
+  std::vector<std::string> forced_fallback_operators;
+  TorchFallback() : enabled(false), min_block_size(1) {}
+
+  ADD_FIELD_GET_SET(enabled, bool);
+  ADD_FIELD_GET_SET(min_block_size, int64_t);
+  ADD_FIELD_GET_SET(forced_fallback_operators, std::vector<std::string>);
+};
+
+struct EngineCache : torch::CustomClassHolder {
+  bool enabled;
+  std::string cache_dir;
+  int64_t max_size_bytes;
+  EngineCache() : enabled(false), max_size_bytes(0) {}
+
+  ADD_FIELD_GET_SET(enabled, bool);
+  ADD_FIELD_GET_SET(cache_dir, std::string);
+  ADD_FIELD_GET_SET(max_size_bytes, int64_t);
+};
+
 std::string to_str(DeviceType value);
 nvinfer1::DeviceType toTRTDeviceType(DeviceType value);
 
@@ -94,10 +116,26 @@ struct CompileSpec : torch::CustomClassHolder {
     input_ranges.push_back(*ir);
   }
 
+  void appendAdditionalInputRange(int64_t input_idx, const c10::intrusive_ptr<InputRange>& ir) {
+    TRTORCH_CHECK(input_idx >= 0, "Input index must be 0 or greater");
+    if (additional_input_ranges.size() <= static_cast<size_t>(input_idx)) {
+      additional_input_ranges.resize(input_idx + 1);
+    }
+    additional_input_ranges[input_idx].push_back(*ir);
+  }
+
   void setDeviceIntrusive(const c10::intrusive_ptr<Device>& d) {
     device = *d;
   }
 
+  void setTorchFallbackIntrusive(const c10::intrusive_ptr<TorchFallback>& fb) {
+    torch_fallback = *fb;
+  }
+
+  void setEngineCacheIntrusive(const c10::intrusive_ptr<EngineCache>& ec) {
+    engine_cache = *ec;
+  }
+
   ADD_ENUM_GET_SET(op_precision, DataType, static_cast<int64_t>(DataType::kChar));
   ADD_FIELD_GET_SET(disable_tf32, bool);
   ADD_FIELD_GET_SET(refit, bool);
@@ -108,20 +146,37 @@ struct CompileSpec : torch::CustomClassHolder {
   ADD_FIELD_GET_SET(num_avg_timing_iters, int64_t);
   ADD_FIELD_GET_SET(workspace_size, int64_t);
   ADD_FIELD_GET_SET(max_batch_size, int64_t);
+  ADD_FIELD_GET_SET(num_compile_threads, int64_t);
+  ADD_FIELD_GET_SET(use_cuda_graph, bool);
+  ADD_FIELD_GET_SET(max_unrolled_loop_trip_count, int64_t);
+  ADD_FIELD_GET_SET(enabled_lowering_passes, std::vector<std::string>);
+  ADD_FIELD_GET_SET(disabled_lowering_passes, std::vector<std::string>);
+  ADD_FIELD_GET_SET(conversion_profile_path, std::string);
   ADD_FIELD_GET_SET(device, Device);
+  ADD_FIELD_GET_SET(torch_fallback, TorchFallback);
+  ADD_FIELD_GET_SET(engine_cache, EngineCache);
 
   std::vector<InputRange> input_ranges;
+  std::vector<std::vector<InputRange>> additional_input_ranges;
   DataType op_precision = DataType::kFloat;
   bool disable_tf32 = false;
   bool refit = false;
   bool debug = false;
   bool strict_types = false;
   Device device;
+  TorchFallback torch_fallback;
+  EngineCache engine_cache;
   EngineCapability capability = EngineCapability::kDEFAULT;
   int64_t num_min_timing_iters = 2;
   int64_t num_avg_timing_iters = 1;
   int64_t workspace_size = 0;
   int64_t max_batch_size = 0;
+  int64_t num_compile_threads = 1;
+  bool use_cuda_graph = false;
+  int64_t max_unrolled_loop_trip_count = 32;
+  std::vector<std::string> enabled_lowering_passes;
+  std::vector<std::string> disabled_lowering_passes;
+  std::string conversion_profile_path;
 };
 
 } // namespace pyapi
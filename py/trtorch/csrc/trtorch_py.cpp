@@ -4,6 +4,7 @@
 #include "Python.h"
 #include "core/compiler.h"
 #include "core/conversion/conversion.h"
+#include "core/runtime/runtime.h"
 #include "tensorrt_classes.h"
 #include "torch/csrc/jit/python/pybind_utils.h"
 #include "torch/custom_class.h"
@@ -101,17 +102,26 @@ PYBIND11_MODULE(_C, m) {
   py::class_<CompileSpec>(m, "CompileSpec")
       .def(py::init<>())
       .def_readwrite("input_ranges", &CompileSpec::input_ranges)
+      .def_readwrite("additional_input_ranges", &CompileSpec::additional_input_ranges)
       .def_readwrite("op_precision", &CompileSpec::op_precision)
       .def_readwrite("refit", &CompileSpec::refit)
       .def_readwrite("disable_tf32", &CompileSpec::disable_tf32)
       .def_readwrite("debug", &CompileSpec::debug)
       .def_readwrite("strict_types", &CompileSpec::strict_types)
       .def_readwrite("device", &CompileSpec::device)
+      .def_readwrite("torch_fallback", &CompileSpec::torch_fallback)
+      .def_readwrite("engine_cache", &CompileSpec::engine_cache)
       .def_readwrite("capability", &CompileSpec::capability)
       .def_readwrite("num_min_timing_iters", &CompileSpec::num_min_timing_iters)
       .def_readwrite("num_avg_timing_iters", &CompileSpec::num_avg_timing_iters)
       .def_readwrite("workspace_size", &CompileSpec::workspace_size)
-      .def_readwrite("max_batch_size", &CompileSpec::max_batch_size);
+      .def_readwrite("max_batch_size", &CompileSpec::max_batch_size)
+      .def_readwrite("num_compile_threads", &CompileSpec::num_compile_threads)
+      .def_readwrite("use_cuda_graph", &CompileSpec::use_cuda_graph)
+      .def_readwrite("max_unrolled_loop_trip_count", &CompileSpec::max_unrolled_loop_trip_count)
+      .def_readwrite("enabled_lowering_passes", &CompileSpec::enabled_lowering_passes)
+      .def_readwrite("disabled_lowering_passes", &CompileSpec::disabled_lowering_passes)
+      .def_readwrite("conversion_profile_path", &CompileSpec::conversion_profile_path);
 
   py::class_<Device>(m, "Device")
       .def(py::init<>())
@@ -120,6 +130,18 @@ PYBIND11_MODULE(_C, m) {
       .def_readwrite("dla_core", &Device::dla_core)
       .def_readwrite("allow_gpu_fallback", &Device::allow_gpu_fallback);
 
+  py::class_<TorchFallback>(m, "TorchFallback")
+      .def(py::init<>())
+      .def_readwrite("enabled", &TorchFallback::enabled)
+      .def_readwrite("min_block_size", &TorchFallback::min_block_size)
+      .def_readwrite("forced_fallback_operators", &TorchFallback::forced_fallback_operators);
+
+  py::class_<EngineCache>(m, "EngineCache")
+      .def(py::init<>())
+      .def_readwrite("enabled", &EngineCache::enabled)
+      .def_readwrite("cache_dir", &EngineCache::cache_dir)
+      .def_readwrite("max_size_bytes", &EngineCache::max_size_bytes);
+
   m.doc() =
       "TRTorch Internal C Bindings: Ahead of Time compilation for PyTorch JIT. A tool to convert PyTorch JIT to TensorRT";
   m.def(
@@ -135,6 +157,10 @@ PYBIND11_MODULE(_C, m) {
       &trtorch::pyapi::CheckMethodOperatorSupport,
       "Takes a module and a method name and checks if the method graph contains purely convertable operators");
   m.def("get_build_info", &get_build_info, "Returns build info about the compiler as a string");
+  m.def(
+      "set_max_execution_contexts",
+      &core::runtime::set_max_execution_contexts,
+      "Set the maximum number of execution contexts each engine creates for concurrent callers");
 
   m.def("_get_logging_prefix", &logging::get_logging_prefix, "Get the current prefix for the logging output");
   m.def("_set_logging_prefix", &logging::set_logging_prefix, "Set the logging prefix for logging output");
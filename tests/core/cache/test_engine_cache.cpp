@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <sys/types.h>
+#include <time.h>
+#include <utime.h>
+#include <string>
+#include "core/cache/cache.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+#include "torch/cuda.h"
+
+namespace {
+std::shared_ptr<torch::jit::Graph> parseGraph(const std::string& source) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source, &*g);
+  return g;
+}
+
+std::string makeTempDir() {
+  char dir_template[] = "/tmp/trtorch_cache_test_XXXXXX";
+  auto dir = mkdtemp(dir_template);
+  EXPECT_TRUE(dir != nullptr);
+  return std::string(dir);
+}
+
+void setLastUse(const std::string& path, time_t t) {
+  struct utimbuf times;
+  times.actime = t;
+  times.modtime = t;
+  ASSERT_EQ(utime(path.c_str(), &times), 0);
+}
+} // namespace
+
+TEST(Cache, GraphHashIgnoresValueNames) {
+  const auto graph_a = R"IR(
+    graph(%x : Tensor):
+      %1 : int = prim::Constant[value=1]()
+      %2 : Tensor = aten::add(%x, %x, %1)
+      %3 : Tensor = aten::relu(%2)
+      return (%3))IR";
+  const auto graph_b = R"IR(
+    graph(%input : Tensor):
+      %alpha : int = prim::Constant[value=1]()
+      %sum : Tensor = aten::add(%input, %input, %alpha)
+      %out : Tensor = aten::relu(%sum)
+      return (%out))IR";
+
+  auto g_a = parseGraph(graph_a);
+  auto g_b = parseGraph(graph_b);
+  trtorch::core::conversion::GraphParams params;
+  ASSERT_EQ(
+      trtorch::core::cache::HashGraph(g_a->block(), params), trtorch::core::cache::HashGraph(g_b->block(), params));
+}
+
+TEST(Cache, GraphHashChangesWithStructure) {
+  const auto graph_a = R"IR(
+    graph(%x : Tensor):
+      %1 : int = prim::Constant[value=1]()
+      %2 : Tensor = aten::add(%x, %x, %1)
+      return (%2))IR";
+  const auto graph_b = R"IR(
+    graph(%x : Tensor):
+      %1 : int = prim::Constant[value=2]()
+      %2 : Tensor = aten::add(%x, %x, %1)
+      return (%2))IR";
+  const auto graph_c = R"IR(
+    graph(%x : Tensor):
+      %1 : int = prim::Constant[value=1]()
+      %2 : Tensor = aten::sub(%x, %x, %1)
+      return (%2))IR";
+
+  trtorch::core::conversion::GraphParams params;
+  auto h_a = trtorch::core::cache::HashGraph(parseGraph(graph_a)->block(), params);
+  auto h_b = trtorch::core::cache::HashGraph(parseGraph(graph_b)->block(), params);
+  auto h_c = trtorch::core::cache::HashGraph(parseGraph(graph_c)->block(), params);
+  ASSERT_NE(h_a, h_b);
+  ASSERT_NE(h_a, h_c);
+}
+
+TEST(Cache, GraphHashChangesWithParams) {
+  const auto graph = R"IR(
+    graph(%x : Tensor, %w : Tensor):
+      %1 : Tensor = aten::matmul(%x, %w)
+      return (%1))IR";
+
+  auto g = parseGraph(graph);
+  auto w = at::ones({4, 4});
+  trtorch::core::conversion::GraphParams params, same_params, other_params;
+  params[g->inputs()[1]] = w;
+  same_params[g->inputs()[1]] = w.clone();
+  other_params[g->inputs()[1]] = w * 2;
+
+  auto h = trtorch::core::cache::HashGraph(g->block(), params);
+  ASSERT_EQ(h, trtorch::core::cache::HashGraph(g->block(), same_params));
+  ASSERT_NE(h, trtorch::core::cache::HashGraph(g->block(), other_params));
+}
+
+TEST(Cache, GraphHashDoesNotDependOnParamLayout) {
+  const auto graph = R"IR(
+    graph(%x : Tensor, %w : Tensor):
+      %1 : Tensor = aten::matmul(%x, %w)
+      return (%1))IR";
+
+  auto g = parseGraph(graph);
+  // Large enough to be streamed through several chunks
+  auto w = at::randn({2048, 4096});
+  trtorch::core::conversion::GraphParams params, transposed_params;
+  params[g->inputs()[1]] = w;
+  transposed_params[g->inputs()[1]] = w.t().contiguous().t();
+
+  ASSERT_EQ(
+      trtorch::core::cache::HashGraph(g->block(), params),
+      trtorch::core::cache::HashGraph(g->block(), transposed_params));
+}
+
+TEST(Cache, GraphHashDoesNotDependOnParamDevice) {
+  if (!torch::cuda::is_available()) {
+    GTEST_SKIP() << "Needs a GPU";
+  }
+  const auto graph = R"IR(
+    graph(%x : Tensor, %w : Tensor):
+      %1 : Tensor = aten::matmul(%x, %w)
+      return (%1))IR";
+
+  auto g = parseGraph(graph);
+  auto w = at::randn({2048, 4096});
+  trtorch::core::conversion::GraphParams params, cuda_params;
+  params[g->inputs()[1]] = w;
+  cuda_params[g->inputs()[1]] = w.to(at::kCUDA);
+
+  ASSERT_EQ(
+      trtorch::core::cache::HashGraph(g->block(), params), trtorch::core::cache::HashGraph(g->block(), cuda_params));
+}
+
+TEST(Cache, SettingsHashChangesWithInputRanges) {
+  trtorch::core::conversion::ConversionInfo info_a({trtorch::core::conversion::InputRange({1, 3, 32, 32})});
+  trtorch::core::conversion::ConversionInfo info_b({trtorch::core::conversion::InputRange({2, 3, 32, 32})});
+  trtorch::core::conversion::ConversionInfo info_c({trtorch::core::conversion::InputRange({1, 3, 32, 32})});
+  info_c.engine_settings.op_precision = nvinfer1::DataType::kHALF;
+
+  auto h_a = trtorch::core::cache::HashSettings(info_a);
+  ASSERT_NE(h_a, trtorch::core::cache::HashSettings(info_b));
+  ASSERT_NE(h_a, trtorch::core::cache::HashSettings(info_c));
+}
+
+TEST(Cache, StoreAndLoadRoundTrip) {
+  auto dir = makeTempDir();
+  trtorch::core::cache::EngineCache cache(dir);
+
+  trtorch::core::cache::EngineCacheKey key;
+  key.graph_hash = 1;
+  key.settings_hash = 2;
+  key.version_hash = 3;
+
+  std::string engine;
+  ASSERT_FALSE(cache.Load(key, engine));
+
+  std::string serialized("serialized engine\0with embedded null", 36);
+  cache.Store(key, serialized);
+  ASSERT_TRUE(cache.Load(key, engine));
+  ASSERT_EQ(engine, serialized);
+
+  auto other_key = key;
+  other_key.version_hash = 4;
+  ASSERT_FALSE(cache.Load(other_key, engine));
+}
+
+TEST(Cache, EvictsLeastRecentlyUsed) {
+  auto dir = makeTempDir();
+  std::string serialized(1024, 'x');
+  trtorch::core::cache::EngineCache unbounded(dir);
+
+  std::vector<trtorch::core::cache::EngineCacheKey> keys(3);
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i].graph_hash = i;
+    unbounded.Store(keys[i], serialized);
+    // Key 1 is the least recently used, then key 0, then key 2
+    auto last_use = i == 0 ? 2000 : (i == 1 ? 1000 : 3000);
+    setLastUse(dir + "/" + keys[i].str() + ".engine", last_use);
+  }
+  auto entry_size = unbounded.Size() / keys.size();
+
+  trtorch::core::cache::EngineCache bounded(dir, 2 * entry_size);
+  bounded.Evict();
+
+  std::string engine;
+  ASSERT_EQ(bounded.Size(), 2 * entry_size);
+  ASSERT_FALSE(bounded.Load(keys[1], engine));
+  ASSERT_TRUE(bounded.Load(keys[0], engine));
+  ASSERT_TRUE(bounded.Load(keys[2], engine));
+}
+
+TEST(Cache, StoreNeverEvictsTheStoredEntry) {
+  auto dir = makeTempDir();
+  std::string serialized(1024, 'x');
+  std::vector<trtorch::core::cache::EngineCacheKey> keys(2);
+  keys[1].graph_hash = 1;
+
+  trtorch::core::cache::EngineCache unbounded(dir);
+  unbounded.Store(keys[0], serialized);
+  auto entry_size = unbounded.Size();
+  // Looks more recently used than anything stored now
+  setLastUse(dir + "/" + keys[0].str() + ".engine", time(nullptr) + 3600);
+
+  trtorch::core::cache::EngineCache bounded(dir, entry_size);
+  bounded.Store(keys[1], serialized);
+
+  std::string engine;
+  ASSERT_EQ(bounded.Size(), entry_size);
+  ASSERT_FALSE(bounded.Load(keys[0], engine));
+  ASSERT_TRUE(bounded.Load(keys[1], engine));
+}
@@ -0,0 +1,44 @@
+#include "core/conversion/conversionctx/BuilderArena.h"
+#include "gtest/gtest.h"
+#include "torch/torch.h"
+
+TEST(BuilderArena, ReferencesTensorsInsteadOfCopying) {
+  trtorch::core::conversion::BuilderArena arena;
+  auto w = at::randn({16, 16});
+  auto data = arena.Keep(w, /*borrowed=*/true);
+
+  ASSERT_EQ(data, w.data_ptr());
+  ASSERT_EQ(arena.stats().borrowed_bytes, w.nbytes());
+  ASSERT_EQ(arena.stats().owned_bytes, 0);
+}
+
+TEST(BuilderArena, KeepsTensorsAlive) {
+  trtorch::core::conversion::BuilderArena arena;
+  const void* data;
+  {
+    auto staged = at::arange(8, at::kHalf);
+    data = arena.Keep(staged, /*borrowed=*/false);
+  }
+  // The arena holds the last reference, the values are still readable
+  ASSERT_EQ(static_cast<const at::Half*>(data)[7], at::Half(7));
+  // Sized by the element size of the tensor, not as floats
+  ASSERT_EQ(arena.stats().owned_bytes, 8 * sizeof(at::Half));
+}
+
+TEST(BuilderArena, TracksPeakOwnedBytes) {
+  trtorch::core::conversion::BuilderArena arena;
+  arena.Allocate(100);
+  arena.Keep(at::zeros({10}, at::kInt), /*borrowed=*/false);
+  ASSERT_EQ(arena.stats().owned_bytes, 140);
+
+  arena.Clear();
+  ASSERT_EQ(arena.stats().owned_bytes, 0);
+  arena.Allocate(20);
+  ASSERT_EQ(arena.stats().owned_bytes, 20);
+  ASSERT_EQ(arena.stats().peak_owned_bytes, 140);
+}
+
+TEST(BuilderArena, RejectsNonContiguousTensors) {
+  trtorch::core::conversion::BuilderArena arena;
+  ASSERT_ANY_THROW(arena.Keep(at::randn({4, 8}).t(), /*borrowed=*/true));
+}
@@ -0,0 +1,82 @@
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "core/conversion/conversionctx/WeightsDeduplicator.h"
+#include "gtest/gtest.h"
+#include "torch/torch.h"
+
+namespace {
+// Copies weights into buffers owned by the test, counting the copies made
+struct CountingMaterializer {
+  const void* operator()(const at::Tensor& t_host) {
+    buffers.emplace_back(new uint8_t[t_host.nbytes()]);
+    memcpy(buffers.back().get(), t_host.data_ptr(), t_host.nbytes());
+    return buffers.back().get();
+  }
+  std::vector<std::unique_ptr<uint8_t[]>> buffers;
+};
+} // namespace
+
+TEST(WeightsDeduplication, SharesBuffersOfTiedWeights) {
+  trtorch::core::conversion::WeightsDeduplicator dedup;
+  CountingMaterializer materializer;
+  auto materialize = [&](const at::Tensor& t) { return materializer(t); };
+
+  auto embedding = at::randn({32, 16});
+  auto first = dedup.GetOrMaterialize(embedding, materialize);
+  // Same storage, e.g. an embedding tied to the decoder
+  auto second = dedup.GetOrMaterialize(embedding.view({32, 16}), materialize);
+
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(materializer.buffers.size(), 1);
+  ASSERT_EQ(dedup.stats().num_weights, 2);
+  ASSERT_EQ(dedup.stats().num_deduplicated, 1);
+  ASSERT_EQ(dedup.stats().bytes_saved, 32 * 16 * sizeof(float));
+}
+
+TEST(WeightsDeduplication, SharesBuffersOfEqualContents) {
+  trtorch::core::conversion::WeightsDeduplicator dedup;
+  CountingMaterializer materializer;
+  auto materialize = [&](const at::Tensor& t) { return materializer(t); };
+
+  auto w = at::randn({8, 8});
+  auto first = dedup.GetOrMaterialize(w, materialize);
+  // A separate copy of the same values, as freezing may produce
+  auto second = dedup.GetOrMaterialize(w.clone(), materialize);
+  // Same bytes seen through a different shape
+  auto third = dedup.GetOrMaterialize(w.clone().reshape({64}), materialize);
+
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(first, third);
+  ASSERT_EQ(materializer.buffers.size(), 1);
+  ASSERT_EQ(dedup.stats().num_deduplicated, 2);
+}
+
+TEST(WeightsDeduplication, KeepsDistinctWeightsApart) {
+  trtorch::core::conversion::WeightsDeduplicator dedup;
+  CountingMaterializer materializer;
+  auto materialize = [&](const at::Tensor& t) { return materializer(t); };
+
+  auto w = at::randn({4, 6});
+  auto a = dedup.GetOrMaterialize(w, materialize);
+  // Shares the storage but reads it in a different order
+  auto b = dedup.GetOrMaterialize(w.t(), materialize);
+  // Shares the storage but starts at a different element
+  auto c = dedup.GetOrMaterialize(w[1], materialize);
+  // Same bits but a different type
+  auto d = dedup.GetOrMaterialize(w.view(at::kInt), materialize);
+  auto e = dedup.GetOrMaterialize(w + 1, materialize);
+
+  std::vector<const void*> bufs = {a, b, c, d, e};
+  for (size_t i = 0; i < bufs.size(); i++) {
+    for (size_t j = i + 1; j < bufs.size(); j++) {
+      ASSERT_NE(bufs[i], bufs[j]);
+    }
+  }
+  ASSERT_EQ(materializer.buffers.size(), 5);
+  ASSERT_EQ(dedup.stats().bytes_saved, 0);
+
+  // The transposed copy holds the transposed values
+  auto t_host = w.t().contiguous();
+  ASSERT_EQ(memcmp(b, t_host.data_ptr(), t_host.nbytes()), 0);
+}
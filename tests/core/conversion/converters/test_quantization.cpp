@@ -0,0 +1,46 @@
+#include <string>
+#include "core/compiler.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+const auto kQuantizedGraph = R"IR(
+    graph(%0 : Tensor):
+      %amax : float = prim::Constant[value=2.54]()
+      %1 : Tensor = trt::quantize_range(%0, %amax)
+      %2 : Tensor = aten::relu(%1)
+      %3 : Tensor = trt::quantize_range(%2, %amax)
+      return (%3))IR";
+} // namespace
+
+TEST(Converters, TRTQuantizeRangeIsIdentityInFP32) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kQuantizedGraph, &*g);
+
+  auto in = at::randn({2, 3, 4}, {at::kCUDA});
+  auto params = trtorch::core::conversion::get_named_params(g->inputs(), {});
+  auto trt_results = trtorch::tests::util::RunGraphEngine(g, params, {in});
+
+  ASSERT_TRUE(trtorch::tests::util::almostEqual(at::relu(in), trt_results[0].reshape_as(in), 2e-6));
+}
+
+TEST(Converters, TRTQuantizeRangeBuildsINT8EngineWithoutCalibrator) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kQuantizedGraph, &*g);
+
+  auto in = at::randn({2, 3, 4}, {at::kCUDA});
+  auto params = trtorch::core::conversion::get_named_params(g->inputs(), {});
+  auto jit_results = trtorch::tests::util::RunGraph(g, params, {in});
+
+  std::vector<trtorch::core::conversion::InputRange> input_ranges;
+  input_ranges.push_back(trtorch::core::conversion::InputRange(trtorch::core::util::toVec(in.sizes())));
+  trtorch::core::conversion::ConversionInfo info(input_ranges);
+  info.engine_settings.op_precision = nvinfer1::DataType::kINT8;
+  params = trtorch::core::conversion::get_named_params(g->inputs(), {});
+  auto engine = trtorch::core::conversion::ConvertBlockToEngine(g->block(), info, params);
+  auto trt_results = trtorch::tests::util::RunEngine(engine, {in});
+
+  // Both sides quantize with a step of 0.02, TensorRT may round the other way
+  ASSERT_TRUE(trtorch::tests::util::almostEqual(jit_results[0], trt_results[0].reshape_as(jit_results[0]), 0.02));
+}
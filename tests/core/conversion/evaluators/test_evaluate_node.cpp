@@ -0,0 +1,33 @@
+#include <sstream>
+#include <string>
+#include "core/compiler.h"
+#include "core/conversion/conversion.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+TEST(Evaluators, EvaluateNodeEvaluatesLongDependencyChainsOnce) {
+  // %v63 depends on a chain of 64 adds, deeper than recursion used to allow,
+  // and %out reaches %v31 both directly and through the chain
+  std::stringstream graph;
+  graph << "graph():\n";
+  graph << "  %c : int = prim::Constant[value=1]()\n";
+  graph << "  %v0 : int = aten::add(%c, %c)\n";
+  for (int i = 1; i < 64; i++) {
+    graph << "  %v" << i << " : int = aten::add(%v" << i - 1 << ", %c)\n";
+  }
+  graph << "  %out : int = aten::add(%v63, %v31)\n";
+  graph << "  return (%out)";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph.str(), &*g);
+
+  trtorch::core::conversion::ConversionCtx ctx({});
+  auto out = trtorch::core::conversion::EvaluateNode(&ctx, g->outputs()[0]->node());
+
+  ASSERT_TRUE(out);
+  ASSERT_EQ(out->toInt(), 98);
+  ASSERT_EQ(ctx.evaluator_stats[torch::jit::aten::add].num_evaluations, 65);
+  ASSERT_EQ(ctx.evaluator_stats[torch::jit::prim::Constant].num_evaluations, 1);
+  ASSERT_EQ(ctx.evaluated_value_map.size(), 65);
+}
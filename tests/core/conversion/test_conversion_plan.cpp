@@ -0,0 +1,59 @@
+#include <string>
+#include "core/conversion/conversion_plan.h"
+#include "gtest/gtest.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+TEST(Conversion, PlanResolvesDispatchOncePerNode) {
+  const auto graph = R"IR(
+      graph(%x : Tensor):
+        %1 : int = prim::Constant[value=1]()
+        %2 : int = aten::add(%1, %1)
+        %p : float = prim::Constant[value=0.5]()
+        %train : bool = prim::Constant[value=0]()
+        %y : Tensor = aten::dropout(%x, %p, %train)
+        %z : Tensor = aten::add(%y, %x, %1)
+        %c : bool = aten::eq(%2, %1)
+        %o : Tensor = prim::If(%c)
+          block0():
+            %r : Tensor = aten::relu(%z)
+            -> (%r)
+          block1():
+            -> (%z)
+        %u : Tensor = aten::lgamma(%o)
+        return (%u))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::conversion::ConversionPlan plan(g->block());
+  using trtorch::core::conversion::NodeDispatch;
+
+  auto root = plan.entries(plan.root());
+  ASSERT_EQ(root.size(), 9);
+  ASSERT_EQ(plan.size(), 10);
+  ASSERT_EQ(root[0].dispatch, NodeDispatch::kEvaluate);
+  // aten::add on ints is evaluated, on tensors it is converted
+  ASSERT_EQ(root[1].dispatch, NodeDispatch::kEvaluate);
+  ASSERT_TRUE(root[1].evaluator);
+  ASSERT_EQ(root[4].dispatch, NodeDispatch::kIgnore);
+  ASSERT_EQ(root[5].dispatch, NodeDispatch::kConvert);
+  ASSERT_TRUE(root[5].converter);
+  ASSERT_FALSE(root[5].evaluator);
+  ASSERT_EQ(root[6].dispatch, NodeDispatch::kEvaluate);
+  ASSERT_EQ(root[8].dispatch, NodeDispatch::kUnsupported);
+
+  auto& conditional = root[7];
+  ASSERT_EQ(conditional.dispatch, NodeDispatch::kConditional);
+  ASSERT_EQ(conditional.blocks.size(), 2);
+  auto then_branch = plan.entries(conditional.blocks[0]);
+  ASSERT_EQ(then_branch.size(), 1);
+  ASSERT_EQ(then_branch[0].dispatch, NodeDispatch::kConvert);
+  ASSERT_EQ(then_branch[0].node->kind(), torch::jit::aten::relu);
+  ASSERT_EQ(plan.entries(conditional.blocks[1]).size(), 0);
+
+  ASSERT_EQ(plan.find(then_branch[0].node), &then_branch[0]);
+  ASSERT_EQ(plan.find(g->return_node()), nullptr);
+
+  auto dump = plan.Dump();
+  ASSERT_NE(dump.find("ignore: %y = aten::dropout"), std::string::npos);
+  ASSERT_NE(dump.find("    [9] convert: %r = aten::relu"), std::string::npos);
+}
@@ -0,0 +1,134 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+#include "torch/csrc/jit/ir/subgraph_matcher.h"
+
+TEST(LoweringPasses, CanonicalizeShufflesComposesPermutations) {
+  std::string source_graph = R"IR(
+      graph(%x : Tensor):
+        %1 : int = prim::Constant[value=1]()
+        %2 : int = prim::Constant[value=2]()
+        %p1 : int[] = prim::Constant[value=[0, 2, 3, 1]]()
+        %p2 : int[] = prim::Constant[value=[3, 0, 2, 1]]()
+        %a : Tensor = aten::permute(%x, %p1)
+        %b : Tensor = aten::transpose(%a, %1, %2)
+        %c : Tensor = aten::permute(%b, %p2)
+        return (%c))IR";
+  std::string target_graph = R"IR(
+      graph(%x : Tensor):
+        %p : int[] = prim::Constant[value=[1, 0, 2, 3]]()
+        %c : Tensor = aten::permute(%x, %p)
+        return (%c))IR";
+
+  auto sg = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source_graph, &*sg);
+  auto canonical = sg->copy();
+  trtorch::core::lowering::passes::CanonicalizeShuffles(canonical);
+
+  auto tg = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(target_graph, &*tg);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::permute), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::transpose), 0);
+  ASSERT_TRUE(!torch::jit::findPatternMatches(*tg, *canonical).empty());
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(sg, canonical, {at::randn({2, 3, 4, 5})}));
+}
+
+TEST(LoweringPasses, CanonicalizeShufflesRemovesIdentityPermutations) {
+  std::string source_graph = R"IR(
+      graph(%x : Tensor):
+        %1 : int = prim::Constant[value=1]()
+        %2 : int = prim::Constant[value=-1]()
+        %id : int[] = prim::Constant[value=[0, 1, 2]]()
+        %p : int[] = prim::Constant[value=[0, 2, 1]]()
+        %a : Tensor = aten::permute(%x, %id)
+        %b : Tensor = aten::transpose(%a, %1, %2)
+        %c : Tensor = aten::transpose(%b, %2, %1)
+        %d : Tensor = aten::permute(%c, %p)
+        %e : Tensor = aten::permute(%d, %p)
+        %f : Tensor = aten::relu(%e)
+        return (%f))IR";
+
+  auto sg = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source_graph, &*sg);
+  auto canonical = sg->copy();
+  trtorch::core::lowering::passes::CanonicalizeShuffles(canonical);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::permute), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::transpose), 0);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(sg, canonical, {at::randn({2, 3, 4})}));
+}
+
+TEST(LoweringPasses, CanonicalizeShufflesCollapsesReshapeChains) {
+  std::string source_graph = R"IR(
+      graph(%x : Tensor):
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %s1 : int[] = prim::Constant[value=[6, 20]]()
+        %s2 : int[] = prim::Constant[value=[4, -1]]()
+        %a : Tensor = aten::flatten(%x, %0, %1)
+        %b : Tensor = aten::unsqueeze(%a, %0)
+        %c : Tensor = aten::view(%b, %s1)
+        %d : Tensor = aten::reshape(%c, %s2)
+        %p : int[] = prim::Constant[value=[1, 0]]()
+        %e : Tensor = aten::permute(%d, %p)
+        return (%e))IR";
+
+  auto sg = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source_graph, &*sg);
+  auto canonical = sg->copy();
+  trtorch::core::lowering::passes::CanonicalizeShuffles(canonical);
+
+  // One reshape and one permute are left
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::reshape), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::view), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::flatten), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::unsqueeze), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::permute), 1);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(sg, canonical, {at::randn({2, 3, 4, 5})}));
+}
+
+TEST(LoweringPasses, CanonicalizeShufflesKeepsViewsOfCopies) {
+  // The view can only skip the unsqueeze, dropping the reshape would leave
+  // it viewing a non contiguous tensor
+  std::string source_graph = R"IR(
+      graph(%x : Tensor):
+        %0 : int = prim::Constant[value=0]()
+        %p : int[] = prim::Constant[value=[1, 0]]()
+        %s1 : int[] = prim::Constant[value=[12]]()
+        %s2 : int[] = prim::Constant[value=[3, 4]]()
+        %a : Tensor = aten::permute(%x, %p)
+        %b : Tensor = aten::reshape(%a, %s1)
+        %c : Tensor = aten::unsqueeze(%b, %0)
+        %d : Tensor = aten::view(%c, %s2)
+        return (%d))IR";
+
+  auto sg = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source_graph, &*sg);
+  auto canonical = sg->copy();
+  trtorch::core::lowering::passes::CanonicalizeShuffles(canonical);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::reshape), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::unsqueeze), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(canonical, torch::jit::aten::view), 1);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(sg, canonical, {at::randn({4, 3})}));
+}
+
+TEST(LoweringPasses, CanonicalizeShufflesKeepsSharedIntermediates) {
+  std::string source_graph = R"IR(
+      graph(%x : Tensor):
+        %p : int[] = prim::Constant[value=[1, 0]]()
+        %a : Tensor = aten::permute(%x, %p)
+        %b : Tensor = aten::permute(%a, %p)
+        %c : Tensor = aten::relu(%a)
+        return (%b, %c))IR";
+
+  auto sg = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source_graph, &*sg);
+  trtorch::core::lowering::passes::CanonicalizeShuffles(sg);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(sg, torch::jit::aten::permute), 2);
+}
@@ -0,0 +1,203 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+
+namespace {
+// Folds the batch norms of the graph and checks the results against the
+// unfolded graph
+void CheckFolding(
+    const std::string& source,
+    std::vector<at::Tensor> params,
+    at::Tensor in,
+    size_t expected_batch_norms = 0) {
+  auto g = trtorch::tests::util::BuildFrozenGraph(source, params);
+  auto folded = g->copy();
+  trtorch::core::lowering::passes::FoldConvBatchNorm(folded);
+  EXPECT_EQ(trtorch::tests::util::CountNodes(folded, torch::jit::aten::batch_norm), expected_batch_norms);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, folded, {in}, 1e-5));
+}
+
+std::vector<at::Tensor> BatchNormParams(int64_t channels) {
+  return {at::rand({channels}) + 0.5, at::randn({channels}), at::randn({channels}), at::rand({channels}) + 0.1};
+}
+
+std::vector<at::Tensor> Concat(std::vector<at::Tensor> a, const std::vector<at::Tensor>& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+} // namespace
+
+TEST(LoweringPasses, FoldConvBatchNorm2dCorrectly) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %1 : int = prim::Constant[value=1]()
+        %2 : int = prim::Constant[value=2]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%2, %2)
+        %padding : int[] = prim::ListConstruct(%1, %1)
+        %dilation : int[] = prim::ListConstruct(%1, %1)
+        %out_padding : int[] = prim::ListConstruct(%1, %1)
+        %conv : Tensor = aten::_convolution(%x, %w, %b, %stride, %padding, %dilation, %false, %out_padding, %1, %false, %false, %true, %true)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        return (%y))IR";
+
+  CheckFolding(graph, Concat({at::randn({8, 3, 3, 3}), at::randn({8})}, BatchNormParams(8)), at::randn({2, 3, 10, 10}));
+}
+
+TEST(LoweringPasses, FoldConvBatchNorm1dWithoutBiasCorrectly) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %none : NoneType = prim::Constant()
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=0.001]()
+        %stride : int[] = prim::ListConstruct(%1)
+        %padding : int[] = prim::ListConstruct(%0)
+        %dilation : int[] = prim::ListConstruct(%1)
+        %conv : Tensor = aten::conv1d(%x, %w, %none, %stride, %padding, %dilation, %1)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        return (%y))IR";
+
+  CheckFolding(graph, Concat({at::randn({6, 4, 3})}, BatchNormParams(6)), at::randn({2, 4, 16}));
+}
+
+TEST(LoweringPasses, FoldConvBatchNorm3dCorrectly) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%1, %1, %1)
+        %padding : int[] = prim::ListConstruct(%0, %0, %0)
+        %dilation : int[] = prim::ListConstruct(%1, %1, %1)
+        %out_padding : int[] = prim::ListConstruct(%0, %0, %0)
+        %conv : Tensor = aten::_convolution(%x, %w, %b, %stride, %padding, %dilation, %false, %out_padding, %1, %false, %false, %true, %true)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        return (%y))IR";
+
+  CheckFolding(
+      graph, Concat({at::randn({4, 2, 3, 3, 3}), at::randn({4})}, BatchNormParams(4)), at::randn({1, 2, 6, 6, 6}));
+}
+
+TEST(LoweringPasses, FoldGroupedTransposedConvBatchNormCorrectly) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %2 : int = prim::Constant[value=2]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%2, %2)
+        %padding : int[] = prim::ListConstruct(%0, %0)
+        %dilation : int[] = prim::ListConstruct(%1, %1)
+        %out_padding : int[] = prim::ListConstruct(%1, %1)
+        %conv : Tensor = aten::_convolution(%x, %w, %b, %stride, %padding, %dilation, %true, %out_padding, %2, %false, %false, %true, %true)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        return (%y))IR";
+
+  // 4 input channels in 2 groups, 3 output channels per group
+  CheckFolding(graph, Concat({at::randn({4, 3, 3, 3}), at::randn({6})}, BatchNormParams(6)), at::randn({2, 4, 5, 5}));
+}
+
+TEST(LoweringPasses, FoldConvBatchNormKeepsSharedWeightsIntact) {
+  // Both convolutions read the same weight constant but only the first is
+  // followed by a batch norm
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%1, %1)
+        %padding : int[] = prim::ListConstruct(%1, %1)
+        %dilation : int[] = prim::ListConstruct(%1, %1)
+        %out_padding : int[] = prim::ListConstruct(%0, %0)
+        %conv1 : Tensor = aten::_convolution(%x, %w, %b, %stride, %padding, %dilation, %false, %out_padding, %1, %false, %false, %true, %true)
+        %y1 : Tensor = aten::batch_norm(%conv1, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        %conv2 : Tensor = aten::_convolution(%y1, %w, %b, %stride, %padding, %dilation, %false, %out_padding, %1, %false, %false, %true, %true)
+        return (%conv2))IR";
+
+  CheckFolding(graph, Concat({at::randn({3, 3, 3, 3}), at::randn({3})}, BatchNormParams(3)), at::randn({1, 3, 8, 8}));
+}
+
+TEST(LoweringPasses, FoldConvBatchNormSkipsConvsWithOtherConsumers) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%1, %1)
+        %padding : int[] = prim::ListConstruct(%0, %0)
+        %dilation : int[] = prim::ListConstruct(%1, %1)
+        %conv : Tensor = aten::conv2d(%x, %w, %b, %stride, %padding, %dilation, %1)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        %z : Tensor = aten::add(%conv, %y, %1)
+        return (%z))IR";
+
+  CheckFolding(
+      graph, Concat({at::randn({3, 3, 1, 1}), at::randn({3})}, BatchNormParams(3)), at::randn({1, 3, 4, 4}), 1);
+}
+
+TEST(LoweringPasses, FoldConvBatchNormSkipsTrainingBatchNorms) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%1, %1)
+        %padding : int[] = prim::ListConstruct(%0, %0)
+        %dilation : int[] = prim::ListConstruct(%1, %1)
+        %conv : Tensor = aten::conv2d(%x, %w, %b, %stride, %padding, %dilation, %1)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %true, %momentum, %eps, %true)
+        return (%y))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      graph, Concat({at::randn({3, 3, 1, 1}), at::randn({3})}, BatchNormParams(3)));
+  trtorch::core::lowering::passes::FoldConvBatchNorm(g);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::batch_norm), 1);
+}
+
+TEST(LoweringPasses, FoldConvBatchNormSkipsFakeQuantizedWeights) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %gamma : Tensor, %beta : Tensor, %mean : Tensor, %var : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %qmin : int = prim::Constant[value=-128]()
+        %qmax : int = prim::Constant[value=127]()
+        %scale : float = prim::Constant[value=0.01]()
+        %momentum : float = prim::Constant[value=0.1]()
+        %eps : float = prim::Constant[value=1.0000000000000001e-05]()
+        %stride : int[] = prim::ListConstruct(%1, %1)
+        %padding : int[] = prim::ListConstruct(%0, %0)
+        %dilation : int[] = prim::ListConstruct(%1, %1)
+        %wq : Tensor = aten::fake_quantize_per_tensor_affine(%w, %scale, %0, %qmin, %qmax)
+        %conv : Tensor = aten::conv2d(%x, %wq, %b, %stride, %padding, %dilation, %1)
+        %y : Tensor = aten::batch_norm(%conv, %gamma, %beta, %mean, %var, %false, %momentum, %eps, %true)
+        return (%y))IR";
+
+  CheckFolding(
+      graph, Concat({at::randn({3, 3, 1, 1}), at::randn({3})}, BatchNormParams(3)), at::randn({1, 3, 4, 4}), 1);
+}
@@ -0,0 +1,68 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+
+namespace {
+const auto kScaledLinearGraph = R"IR(
+    graph(%x : Tensor, %w : Tensor, %scale : Tensor, %b : Tensor):
+      %wt : Tensor = aten::t(%w)
+      %ws : Tensor = aten::mul(%wt, %scale)
+      %y : Tensor = aten::matmul(%x, %ws)
+      %1 : int = prim::Constant[value=1]()
+      %z : Tensor = aten::add(%y, %b, %1)
+      return (%z))IR";
+} // namespace
+
+TEST(LoweringPasses, FoldParameterSubgraphsFoldsWeightChains) {
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      kScaledLinearGraph, {at::randn({16, 8}), at::randn({16}), at::randn({16})});
+  auto folded = g->copy();
+  trtorch::core::lowering::passes::FoldParameterSubgraphs(folded);
+
+  // Only the ops reading the runtime input are left
+  ASSERT_EQ(trtorch::tests::util::CountNodes(folded, torch::jit::aten::t), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(folded, torch::jit::aten::mul), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(folded, torch::jit::aten::matmul), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(folded, torch::jit::aten::add), 1);
+
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, folded, {at::randn({4, 8})}));
+}
+
+TEST(LoweringPasses, FoldParameterSubgraphsMakesFoldedViewsContiguous) {
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      kScaledLinearGraph, {at::randn({16, 8}), at::ones({16}), at::randn({16})});
+  trtorch::core::lowering::passes::FoldParameterSubgraphs(g);
+
+  for (auto n : g->nodes()) {
+    if (n->kind() == torch::jit::prim::Constant && n->output()->type()->isSubtypeOf(c10::TensorType::get())) {
+      ASSERT_TRUE(n->t(torch::jit::attr::value).is_contiguous());
+    }
+  }
+}
+
+TEST(LoweringPasses, FoldParameterSubgraphsRespectsSizeThreshold) {
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      kScaledLinearGraph, {at::randn({16, 8}), at::randn({16}), at::randn({16})});
+  // Every intermediate is 16 * 8 floats
+  trtorch::core::lowering::passes::FoldParameterSubgraphs(g, 16 * 8 * sizeof(float) - 1);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::t), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::mul), 1);
+}
+
+TEST(LoweringPasses, FoldParameterSubgraphsLeavesRuntimeInputsAlone) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor):
+        %1 : int = prim::Constant[value=1]()
+        %y : Tensor = aten::add(%x, %w, %1)
+        %z : Tensor = aten::relu(%y)
+        return (%z))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(graph, {at::randn({4})});
+  trtorch::core::lowering::passes::FoldParameterSubgraphs(g);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::add), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 1);
+}
@@ -0,0 +1,65 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+
+TEST(LoweringPasses, FuseSiblingConvolutionsFusesInceptionBranches) {
+  // Three 1x1 branches (one without a bias) that can share a convolution, a
+  // 3x3 branch and a strided 1x1 branch that cannot
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w1 : Tensor, %b1 : Tensor, %w2 : Tensor, %w3 : Tensor, %b3 : Tensor, %w4 : Tensor, %w5 : Tensor):
+        %none : NoneType = prim::Constant()
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %0 : int = prim::Constant[value=0]()
+        %1 : int = prim::Constant[value=1]()
+        %2 : int = prim::Constant[value=2]()
+        %s1 : int[] = prim::Constant[value=[1, 1]]()
+        %s2 : int[] = prim::Constant[value=[2, 2]]()
+        %p0 : int[] = prim::Constant[value=[0, 0]]()
+        %p1 : int[] = prim::Constant[value=[1, 1]]()
+        %c1 : Tensor = aten::_convolution(%x, %w1, %b1, %s1, %p0, %s1, %false, %p0, %1, %false, %false, %true, %true)
+        %c2 : Tensor = aten::_convolution(%x, %w2, %none, %s1, %p0, %s1, %false, %p0, %1, %false, %false, %true, %true)
+        %c3 : Tensor = aten::_convolution(%x, %w3, %b3, %s1, %p0, %s1, %false, %p0, %1, %false, %false, %true, %true)
+        %c4 : Tensor = aten::_convolution(%x, %w4, %none, %s1, %p1, %s1, %false, %p0, %1, %false, %false, %true, %true)
+        %c5 : Tensor = aten::_convolution(%x, %w5, %none, %s2, %p0, %s1, %false, %p0, %1, %false, %false, %true, %true)
+        %r1 : Tensor = aten::relu(%c1)
+        %r2 : Tensor = aten::relu(%c2)
+        return (%r1, %r2, %c3, %c4, %c5))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      graph,
+      {at::randn({8, 16, 1, 1}),
+       at::randn({8}),
+       at::randn({4, 16, 1, 1}),
+       at::randn({12, 16, 1, 1}),
+       at::randn({12}),
+       at::randn({8, 16, 3, 3}),
+       at::randn({8, 16, 1, 1})});
+  auto fused = g->copy();
+  trtorch::core::lowering::passes::FuseSiblingConvolutions(fused);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(fused, torch::jit::aten::_convolution), 3);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(fused, torch::jit::aten::split_with_sizes), 1);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, fused, {at::randn({2, 16, 9, 9})}, 1e-5));
+}
+
+TEST(LoweringPasses, FuseSiblingConvolutionsSkipsGroupedConvolutions) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w1 : Tensor, %w2 : Tensor):
+        %none : NoneType = prim::Constant()
+        %false : bool = prim::Constant[value=0]()
+        %true : bool = prim::Constant[value=1]()
+        %2 : int = prim::Constant[value=2]()
+        %s1 : int[] = prim::Constant[value=[1, 1]]()
+        %p0 : int[] = prim::Constant[value=[0, 0]]()
+        %c1 : Tensor = aten::_convolution(%x, %w1, %none, %s1, %p0, %s1, %false, %p0, %2, %false, %false, %true, %true)
+        %c2 : Tensor = aten::_convolution(%x, %w2, %none, %s1, %p0, %s1, %false, %p0, %2, %false, %false, %true, %true)
+        return (%c1, %c2))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(graph, {at::randn({4, 4, 1, 1}), at::randn({4, 4, 1, 1})});
+  trtorch::core::lowering::passes::FuseSiblingConvolutions(g);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::_convolution), 2);
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+
+namespace {
+// Q, K and V projections of an attention block, V has no bias
+const auto kQKVGraph = R"IR(
+    graph(%x : Tensor, %wq : Tensor, %bq : Tensor, %wk : Tensor, %bk : Tensor, %wv : Tensor):
+      %none : NoneType = prim::Constant()
+      %q : Tensor = aten::linear(%x, %wq, %bq)
+      %k : Tensor = aten::linear(%x, %wk, %bk)
+      %v : Tensor = aten::linear(%x, %wv, %none)
+      return (%q, %k, %v))IR";
+
+std::vector<at::Tensor> QKVParams(int64_t hidden) {
+  return {at::randn({hidden, hidden}),
+          at::randn({hidden}),
+          at::randn({hidden, hidden}),
+          at::randn({hidden}),
+          at::randn({hidden, hidden})};
+}
+} // namespace
+
+TEST(LoweringPasses, FuseSiblingLinearsFusesQKVProjections) {
+  auto g = trtorch::tests::util::BuildFrozenGraph(kQKVGraph, QKVParams(64));
+  auto fused = g->copy();
+  trtorch::core::lowering::passes::FuseSiblingLinears(fused, 128);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(fused, torch::jit::aten::linear), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(fused, torch::jit::aten::split_with_sizes), 1);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, fused, {at::randn({2, 16, 64})}, 1e-5));
+}
+
+TEST(LoweringPasses, FuseSiblingLinearsRespectsMinimumWidth) {
+  auto g = trtorch::tests::util::BuildFrozenGraph(kQKVGraph, QKVParams(32));
+  // 3 * 32 output features is below the minimum
+  trtorch::core::lowering::passes::FuseSiblingLinears(g, 128);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::linear), 3);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::split_with_sizes), 0);
+}
+
+TEST(LoweringPasses, FuseSiblingLinearsFusesMatmulsOfDifferentWidths) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w1 : Tensor, %w2 : Tensor):
+        %a : Tensor = aten::matmul(%x, %w1)
+        %b : Tensor = aten::matmul(%x, %w2)
+        %c : Tensor = aten::relu(%b)
+        return (%a, %c))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(graph, {at::randn({32, 48}), at::randn({32, 16})});
+  auto fused = g->copy();
+  trtorch::core::lowering::passes::FuseSiblingLinears(fused, 64);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(fused, torch::jit::aten::matmul), 1);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, fused, {at::randn({4, 32})}, 1e-5));
+}
+
+TEST(LoweringPasses, FuseSiblingLinearsOnlyFusesMatchingInputs) {
+  // The second linear expects a different number of input features from
+  // the first and reads the first's output, neither can be fused
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w1 : Tensor, %w2 : Tensor, %w3 : Tensor):
+        %none : NoneType = prim::Constant()
+        %a : Tensor = aten::linear(%x, %w1, %none)
+        %b : Tensor = aten::linear(%a, %w2, %none)
+        %c : Tensor = aten::matmul(%x, %w3)
+        return (%b, %c))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      graph, {at::randn({128, 16}), at::randn({128, 128}), at::randn({16, 128})});
+  trtorch::core::lowering::passes::FuseSiblingLinears(g, 1);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::linear), 2);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::matmul), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::split_with_sizes), 0);
+}
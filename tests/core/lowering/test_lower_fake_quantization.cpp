@@ -0,0 +1,88 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/constants.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+const auto kQuantizeRange = c10::Symbol::fromQualString("trt::quantize_range");
+
+std::vector<double> DynamicRanges(const std::shared_ptr<torch::jit::Graph>& g) {
+  std::vector<double> ranges;
+  for (auto n : g->nodes()) {
+    if (n->kind() == kQuantizeRange) {
+      ranges.push_back(torch::jit::toIValue(n->input(1))->toDouble());
+    }
+  }
+  return ranges;
+}
+} // namespace
+
+TEST(LoweringPasses, LowerFakeQuantizationExtractsDynamicRanges) {
+  // QAT linear layer, the input and output are fake quantized per tensor and
+  // the weights per output channel
+  const auto graph = R"IR(
+      graph(%x : Tensor, %w : Tensor, %b : Tensor, %scales : Tensor, %zero_points : Tensor):
+        %0 : int = prim::Constant[value=0]()
+        %qmin : int = prim::Constant[value=-128]()
+        %qmax : int = prim::Constant[value=127]()
+        %in_scale : float = prim::Constant[value=0.02]()
+        %out_scale : float = prim::Constant[value=0.05]()
+        %xq : Tensor = aten::fake_quantize_per_tensor_affine(%x, %in_scale, %0, %qmin, %qmax)
+        %wq : Tensor = aten::fake_quantize_per_channel_affine(%w, %scales, %zero_points, %0, %qmin, %qmax)
+        %y : Tensor = aten::linear(%xq, %wq, %b)
+        %yq : Tensor = aten::fake_quantize_per_tensor_affine(%y, %out_scale, %0, %qmin, %qmax)
+        return (%yq))IR";
+
+  auto g = trtorch::tests::util::BuildFrozenGraph(
+      graph, {at::randn({8, 16}), at::randn({8}), at::rand({8}) / 50 + 0.001, at::zeros({8}, at::kLong)});
+  auto lowered = g->copy();
+  trtorch::core::lowering::passes::LowerFakeQuantization(lowered);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(lowered, torch::jit::aten::fake_quantize_per_tensor_affine), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(lowered, torch::jit::aten::fake_quantize_per_channel_affine), 0);
+  auto ranges = DynamicRanges(lowered);
+  ASSERT_EQ(ranges.size(), 2);
+  ASSERT_NEAR(ranges[0], 0.02 * 127, 1e-9);
+  ASSERT_NEAR(ranges[1], 0.05 * 127, 1e-9);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, lowered, {at::randn({4, 16})}, 2e-6));
+}
+
+TEST(LoweringPasses, LowerFakeQuantizationApproximatesAsymmetricRanges) {
+  const auto graph = R"IR(
+      graph(%x : Tensor):
+        %zp : int = prim::Constant[value=128]()
+        %qmin : int = prim::Constant[value=0]()
+        %qmax : int = prim::Constant[value=255]()
+        %scale : float = prim::Constant[value=0.1]()
+        %xq : Tensor = aten::fake_quantize_per_tensor_affine(%x, %scale, %zp, %qmin, %qmax)
+        return (%xq))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::lowering::passes::LowerFakeQuantization(g);
+
+  auto ranges = DynamicRanges(g);
+  ASSERT_EQ(ranges.size(), 1);
+  ASSERT_NEAR(ranges[0], 0.1 * 128, 1e-9);
+}
+
+TEST(LoweringPasses, LowerFakeQuantizationUsesWidestChannelOfActivations) {
+  const auto graph = R"IR(
+      graph(%x : Tensor, %scales : Tensor, %zero_points : Tensor):
+        %1 : int = prim::Constant[value=1]()
+        %qmin : int = prim::Constant[value=-128]()
+        %qmax : int = prim::Constant[value=127]()
+        %xq : Tensor = aten::fake_quantize_per_channel_affine(%x, %scales, %zero_points, %1, %qmin, %qmax)
+        return (%xq))IR";
+
+  auto scales = at::tensor({0.01f, 0.04f, 0.02f});
+  auto g = trtorch::tests::util::BuildFrozenGraph(graph, {scales, at::zeros({3}, at::kLong)});
+  trtorch::core::lowering::passes::LowerFakeQuantization(g);
+
+  auto ranges = DynamicRanges(g);
+  ASSERT_EQ(ranges.size(), 1);
+  ASSERT_NEAR(ranges[0], 0.04 * 127, 1e-5);
+}
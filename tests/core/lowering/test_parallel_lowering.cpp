@@ -0,0 +1,68 @@
+#include <string>
+#include <thread>
+#include "core/compiler.h"
+#include "core/lowering/lowering.h"
+#include "core/util/prelude.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/script.h"
+
+namespace {
+torch::jit::Module buildMultiMethodModule() {
+  torch::jit::Module mod("MultiMethod");
+  mod.register_parameter("w", torch::randn({4, 4}), false);
+  mod.define(R"(
+    def forward(self, x):
+        return torch.relu(torch.matmul(x, self.w))
+
+    def encode(self, x):
+        return torch.sigmoid(x + self.w)
+
+    def score(self, x):
+        return torch.tanh(torch.matmul(x, self.w) * 2.0)
+  )");
+  return mod;
+}
+
+std::vector<at::Tensor> runLowered(
+    std::pair<std::shared_ptr<torch::jit::Graph>, std::vector<torch::jit::IValue>>& graph_and_params,
+    at::Tensor in) {
+  auto named_params =
+      trtorch::core::conversion::get_named_params(graph_and_params.first->inputs(), graph_and_params.second);
+  return trtorch::tests::util::RunGraph(graph_and_params.first, named_params, {in});
+}
+} // namespace
+
+TEST(LoweringPasses, ConcurrentLoweringMatchesSerialLowering) {
+  auto mod = buildMultiMethodModule();
+  std::vector<std::string> method_names = {"forward", "encode", "score"};
+  auto in = at::randn({4, 4});
+
+  std::vector<std::pair<std::shared_ptr<torch::jit::Graph>, std::vector<torch::jit::IValue>>> serial;
+  for (auto& name : method_names) {
+    serial.push_back(trtorch::core::lowering::Lower(mod, name));
+  }
+
+  // Lower every method several times at once to shake out races on the
+  // shared compilation unit
+  const size_t repeats = 4;
+  std::vector<std::pair<std::shared_ptr<torch::jit::Graph>, std::vector<torch::jit::IValue>>> parallel(
+      method_names.size() * repeats);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < parallel.size(); i++) {
+    workers.emplace_back(
+        [&, i]() { parallel[i] = trtorch::core::lowering::Lower(mod, method_names[i % method_names.size()]); });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  for (size_t i = 0; i < parallel.size(); i++) {
+    auto expected = runLowered(serial[i % method_names.size()], in);
+    auto result = runLowered(parallel[i], in);
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t o = 0; o < expected.size(); o++) {
+      ASSERT_TRUE(trtorch::tests::util::almostEqual(expected[o], result[o], 2e-6));
+    }
+  }
+}
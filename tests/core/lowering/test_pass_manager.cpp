@@ -0,0 +1,147 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/lowering.h"
+#include "core/lowering/pass_manager.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+std::shared_ptr<torch::jit::Graph> BuildReluChain() {
+  const auto graph = R"IR(
+      graph(%x : Tensor):
+        %a : Tensor = aten::relu(%x)
+        %b : Tensor = aten::relu(%a)
+        %c : Tensor = aten::relu(%b)
+        return (%c))IR";
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  return g;
+}
+
+// Removes the first relu of the graph, so each run makes a bit of progress
+void RemoveOneRelu(std::shared_ptr<torch::jit::Graph>& g) {
+  for (auto n : g->nodes()) {
+    if (n->kind() == torch::jit::aten::relu) {
+      n->output()->replaceAllUsesWith(n->input(0));
+      n->destroy();
+      return;
+    }
+  }
+}
+} // namespace
+
+TEST(LoweringPasses, PassManagerRunsPassesInOrder) {
+  std::vector<std::string> order;
+  trtorch::core::lowering::PassManager pm;
+  pm.AddPass("First", [&](std::shared_ptr<torch::jit::Graph>&) { order.push_back("First"); })
+      .AddPass("Second", RemoveOneRelu)
+      .AddPass("Third", [&](std::shared_ptr<torch::jit::Graph>&) { order.push_back("Third"); });
+
+  auto g = BuildReluChain();
+  pm.Run(g);
+
+  ASSERT_EQ(order, std::vector<std::string>({"First", "Third"}));
+  ASSERT_EQ(pm.stats().size(), 3);
+  ASSERT_EQ(pm.stats()[1].name, "Second");
+  ASSERT_EQ(pm.stats()[1].num_runs, 1);
+  ASSERT_EQ(pm.stats()[1].node_delta, -1);
+  ASSERT_EQ(pm.stats()[0].node_delta, 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 2);
+}
+
+TEST(LoweringPasses, PassManagerRespectsEnabledAndDisabledPasses) {
+  trtorch::core::lowering::PassManager pm;
+  pm.AddPass("RemoveOneRelu", RemoveOneRelu)
+      .AddPass("RemoveAnotherRelu", RemoveOneRelu)
+      .AddPass("OptInRemoveRelu", RemoveOneRelu, /*enabled_by_default=*/false);
+
+  auto g = BuildReluChain();
+  pm.Run(g);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 1);
+  ASSERT_EQ(pm.stats().size(), 2);
+
+  g = BuildReluChain();
+  pm.Run(g, {"OptInRemoveRelu"}, {"RemoveAnotherRelu"});
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 1);
+  ASSERT_EQ(pm.stats()[1].name, "OptInRemoveRelu");
+
+  g = BuildReluChain();
+  ASSERT_ANY_THROW(pm.Run(g, {}, {"NotAPass"}));
+}
+
+TEST(LoweringPasses, PassManagerRunsGroupsToFixpoint) {
+  trtorch::core::lowering::PassManager pm;
+  pm.AddFixpointGroup("Group", {{"RemoveOneRelu", RemoveOneRelu}}, 10);
+
+  auto g = BuildReluChain();
+  pm.Run(g);
+  // Three rounds remove the relus and a fourth finds nothing left to do
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 0);
+  ASSERT_EQ(pm.stats()[0].num_runs, 4);
+  ASSERT_EQ(pm.stats()[0].node_delta, -3);
+
+  trtorch::core::lowering::PassManager bounded;
+  bounded.AddFixpointGroup("Group", {{"RemoveOneRelu", RemoveOneRelu}}, 2);
+  g = BuildReluChain();
+  bounded.Run(g);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 1);
+  ASSERT_EQ(bounded.stats()[0].num_runs, 2);
+
+  g = BuildReluChain();
+  pm.Run(g, {}, {"Group"});
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::relu), 3);
+  ASSERT_TRUE(pm.stats().empty());
+}
+
+TEST(LoweringPasses, LowerGraphSkipsDisabledPasses) {
+  const auto graph = R"IR(
+      graph(%x : Tensor):
+        %p : float = prim::Constant[value=0.5]()
+        %train : bool = prim::Constant[value=0]()
+        %a : Tensor = aten::dropout(%x, %p, %train)
+        %b : Tensor = aten::relu(%a)
+        return (%b))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  auto lowered = g->copy();
+  trtorch::core::lowering::LowerGraph(lowered);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(lowered, torch::jit::aten::dropout), 0);
+
+  trtorch::core::lowering::LowerInfo lower_info;
+  lower_info.disabled_passes = {"RemoveDropout"};
+  lowered = g->copy();
+  trtorch::core::lowering::LowerGraph(lowered, lower_info);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(lowered, torch::jit::aten::dropout), 1);
+
+  lower_info.disabled_passes = {"RemoveDropouts"};
+  lowered = g->copy();
+  ASSERT_ANY_THROW(trtorch::core::lowering::LowerGraph(lowered, lower_info));
+}
+
+TEST(LoweringPasses, PassManagerRecordsPassesInProfiler) {
+  trtorch::core::util::Profiler profiler;
+  trtorch::core::lowering::PassManager pm;
+  pm.AddPass("RemoveOneRelu", RemoveOneRelu).AddFixpointGroup("Group", {{"RemoveAnotherRelu", RemoveOneRelu}}, 10);
+  pm.set_profiler(&profiler);
+
+  auto g = BuildReluChain();
+  pm.Run(g);
+
+  // One run of the first pass, then three rounds of the group
+  auto events = profiler.events();
+  ASSERT_EQ(events.size(), 4);
+  ASSERT_EQ(events[0].name, "RemoveOneRelu");
+  ASSERT_EQ(events[0].category, "lowering");
+  ASSERT_EQ(events[3].name, "RemoveAnotherRelu");
+  ASSERT_LE(events[0].start_us + events[0].duration_us, events[1].start_us);
+
+  auto trace = profiler.ChromeTrace();
+  ASSERT_EQ(trace.rfind("{\"traceEvents\": [", 0), 0);
+  ASSERT_NE(trace.find("{\"name\": \"RemoveAnotherRelu\", \"cat\": \"lowering\", \"ph\": \"X\""), std::string::npos);
+
+  auto summary = profiler.Summary();
+  ASSERT_NE(summary.find("RemoveAnotherRelu"), std::string::npos);
+  ASSERT_NE(summary.find("Total (ms)"), std::string::npos);
+}
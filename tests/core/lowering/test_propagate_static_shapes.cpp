@@ -0,0 +1,73 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+// Picks a branch on the rank of the input, then scales by its batch size
+const auto kRankDependentGraph = R"IR(
+    graph(%x : Tensor):
+      %0 : int = prim::Constant[value=0]()
+      %4 : int = prim::Constant[value=4]()
+      %d : int = aten::dim(%x)
+      %c : bool = aten::eq(%d, %4)
+      %y : Tensor = prim::If(%c)
+        block0():
+          %a : Tensor = aten::relu(%x)
+          -> (%a)
+        block1():
+          %b : Tensor = aten::sigmoid(%x)
+          -> (%b)
+      %n : int = aten::size(%y, %0)
+      %z : Tensor = aten::mul(%y, %n)
+      return (%z))IR";
+} // namespace
+
+TEST(LoweringPasses, PropagateStaticShapesFoldsShapeQueries) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kRankDependentGraph, &*g);
+  auto propagated = g->copy();
+  trtorch::core::lowering::passes::PropagateStaticShapes(propagated, {{2, 3, 4, 5}}, at::kFloat, at::kCPU);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(propagated, torch::jit::prim::If), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(propagated, torch::jit::aten::dim), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(propagated, torch::jit::aten::size), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(propagated, torch::jit::aten::sigmoid), 0);
+
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, propagated, {at::randn({2, 3, 4, 5})}));
+}
+
+TEST(LoweringPasses, PropagateStaticShapesKeepsDynamicDims) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kRankDependentGraph, &*g);
+  // The batch size varies at runtime but the rank is still known
+  trtorch::core::lowering::passes::PropagateStaticShapes(g, {{-1, 3, 4, 5}}, at::kFloat, at::kCPU);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::prim::If), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::dim), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::size), 1);
+}
+
+TEST(LoweringPasses, PropagateStaticShapesIgnoresMismatchedInputs) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kRankDependentGraph, &*g);
+  trtorch::core::lowering::passes::PropagateStaticShapes(g, {{2, 3}, {4, 5}}, at::kFloat, at::kCPU);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::prim::If), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::dim), 1);
+}
+
+TEST(LoweringPasses, PropagateStaticShapesKeepsExistingTypes) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kRankDependentGraph, &*g);
+  auto out_type = torch::jit::TensorType::createContiguous(at::kHalf, at::kCUDA, {2, 3, 4, 5});
+  g->outputs()[0]->setType(out_type);
+  trtorch::core::lowering::passes::PropagateStaticShapes(g, {{2, 3, 4, 5}}, at::kFloat, at::kCPU);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::prim::If), 0);
+  // Only the seeded and propagated types are dropped again
+  ASSERT_TRUE(*g->inputs()[0]->type() == *torch::jit::TensorType::get());
+  ASSERT_TRUE(*g->outputs()[0]->type() == *out_type);
+}
@@ -0,0 +1,110 @@
+#include <string>
+#include "core/compiler.h"
+#include "core/lowering/passes/passes.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+// Four steps of an LSTM over the first dim of %x
+const auto kLSTMGraph = R"IR(
+    graph(%x : Tensor, %h0 : Tensor, %c0 : Tensor, %w_ih : Tensor, %w_hh : Tensor, %b_ih : Tensor, %b_hh : Tensor):
+      %0 : int = prim::Constant[value=0]()
+      %4 : int = prim::Constant[value=4]()
+      %true : bool = prim::Constant[value=1]()
+      %h : Tensor, %c : Tensor = prim::Loop(%4, %true, %h0, %c0)
+        block0(%i : int, %h_i : Tensor, %c_i : Tensor):
+          %x_i : Tensor = aten::select(%x, %0, %i)
+          %hx : Tensor[] = prim::ListConstruct(%h_i, %c_i)
+          %h_n : Tensor, %c_n : Tensor = aten::lstm_cell(%x_i, %hx, %w_ih, %w_hh, %b_ih, %b_hh)
+          -> (%true, %h_n, %c_n)
+      return (%h, %c))IR";
+
+std::vector<at::Tensor> LSTMInputs() {
+  return {at::randn({4, 2, 8}),
+          at::randn({2, 16}),
+          at::randn({2, 16}),
+          at::randn({64, 8}),
+          at::randn({64, 16}),
+          at::randn({64}),
+          at::randn({64})};
+}
+
+// Two trips over three trips, with the body using both loop counters
+const auto kNestedLoopGraph = R"IR(
+    graph(%x : Tensor):
+      %2 : int = prim::Constant[value=2]()
+      %3 : int = prim::Constant[value=3]()
+      %true : bool = prim::Constant[value=1]()
+      %y : Tensor = prim::Loop(%2, %true, %x)
+        block0(%i : int, %y_i : Tensor):
+          %z : Tensor = prim::Loop(%3, %true, %y_i)
+            block0(%j : int, %z_j : Tensor):
+              %a : Tensor = aten::mul(%z_j, %j)
+              %b : Tensor = aten::add(%a, %i, %2)
+              -> (%true, %b)
+          -> (%true, %z)
+      return (%y))IR";
+} // namespace
+
+TEST(LoweringPasses, UnrollConstantLoopsUnrollsRNNSteps) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kLSTMGraph, &*g);
+  auto unrolled = g->copy();
+  trtorch::core::lowering::passes::UnrollConstantLoops(unrolled);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(unrolled, torch::jit::prim::Loop), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(unrolled, torch::jit::aten::lstm_cell), 4);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, unrolled, LSTMInputs()));
+}
+
+TEST(LoweringPasses, UnrollConstantLoopsRespectsTripCountLimit) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kLSTMGraph, &*g);
+  trtorch::core::lowering::passes::UnrollConstantLoops(g, 3);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::prim::Loop), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::aten::lstm_cell), 1);
+}
+
+TEST(LoweringPasses, UnrollConstantLoopsUnrollsNestedLoops) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kNestedLoopGraph, &*g);
+  auto unrolled = g->copy();
+  trtorch::core::lowering::passes::UnrollConstantLoops(unrolled);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(unrolled, torch::jit::prim::Loop), 0);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(unrolled, torch::jit::aten::mul), 6);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, unrolled, {at::randn({2, 3})}));
+}
+
+TEST(LoweringPasses, UnrollConstantLoopsLimitsTripsOfLoopNests) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(kNestedLoopGraph, &*g);
+  auto unrolled = g->copy();
+  // Each loop is within the limit on its own, but not 2 x 3 trips together
+  trtorch::core::lowering::passes::UnrollConstantLoops(unrolled, 5);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(unrolled, torch::jit::prim::Loop), 1);
+  ASSERT_EQ(trtorch::tests::util::CountNodes(unrolled, torch::jit::aten::mul), 3);
+  ASSERT_TRUE(trtorch::tests::util::CheckResults(g, unrolled, {at::randn({2, 3})}));
+}
+
+TEST(LoweringPasses, UnrollConstantLoopsKeepsWhileLoops) {
+  const auto graph = R"IR(
+      graph(%x : Tensor):
+        %4 : int = prim::Constant[value=4]()
+        %true : bool = prim::Constant[value=1]()
+        %y : Tensor = prim::Loop(%4, %true, %x)
+          block0(%i : int, %y_i : Tensor):
+            %a : Tensor = aten::relu(%y_i)
+            %cond : bool = aten::lt(%i, %4)
+            -> (%cond, %a)
+        return (%y))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::lowering::passes::UnrollConstantLoops(g);
+
+  ASSERT_EQ(trtorch::tests::util::CountNodes(g, torch::jit::prim::Loop), 1);
+}
@@ -0,0 +1,178 @@
+#include <string>
+#include "core/partitioning/partitioning.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+bool checkSegmentTargets(
+    const trtorch::core::partitioning::PartitionedGraph& segmented_blocks,
+    std::vector<trtorch::core::partitioning::SegmentedBlock::SegmentedBlockTarget> targets) {
+  if (segmented_blocks.size() != targets.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < targets.size(); i++) {
+    if (segmented_blocks[i].target() != targets[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool segmentContains(const trtorch::core::partitioning::SegmentedBlock& seg, std::string kind) {
+  for (auto n : seg.raw_nodes()) {
+    if (n->kind().toQualString() == kind) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+TEST(Partitioning, SegmentSequentialGraphCorrectly) {
+  const auto graph = R"IR(
+      graph(%x.1 : Tensor):
+        %1 : Tensor = aten::relu(%x.1)
+        %2 : Tensor = aten::sigmoid(%1)
+        %3 : Tensor = aten::lgamma(%2)
+        %4 : Tensor = aten::relu(%3)
+        return (%4))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+
+  trtorch::core::conversion::GraphParams params;
+  trtorch::core::partitioning::PartitionInfo partition_info;
+  partition_info.enabled = true;
+  auto segmented_blocks = trtorch::core::partitioning::SegmentGraph(g->block(), params, partition_info);
+
+  using trtorch::core::partitioning::SegmentedBlock;
+  ASSERT_TRUE(checkSegmentTargets(
+      segmented_blocks, {SegmentedBlock::kTensorRT, SegmentedBlock::kTorch, SegmentedBlock::kTensorRT}));
+  ASSERT_EQ(segmented_blocks[0].raw_nodes().size(), 2);
+  ASSERT_EQ(segmented_blocks[0].outputs().size(), 1);
+  ASSERT_EQ(segmented_blocks[2].inputs().size(), 1);
+}
+
+TEST(Partitioning, SegmentRespectsMinBlockSize) {
+  const auto graph = R"IR(
+      graph(%x.1 : Tensor):
+        %1 : Tensor = aten::relu(%x.1)
+        %2 : Tensor = aten::sigmoid(%1)
+        %3 : Tensor = aten::lgamma(%2)
+        %4 : Tensor = aten::relu(%3)
+        return (%4))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+
+  trtorch::core::conversion::GraphParams params;
+  trtorch::core::partitioning::PartitionInfo partition_info;
+  partition_info.enabled = true;
+  partition_info.min_block_size = 2;
+  auto segmented_blocks = trtorch::core::partitioning::SegmentGraph(g->block(), params, partition_info);
+
+  using trtorch::core::partitioning::SegmentedBlock;
+  ASSERT_TRUE(checkSegmentTargets(segmented_blocks, {SegmentedBlock::kTensorRT, SegmentedBlock::kTorch}));
+  ASSERT_EQ(segmented_blocks[1].raw_nodes().size(), 2);
+}
+
+TEST(Partitioning, SegmentRespectsForcedFallbackOperators) {
+  const auto graph = R"IR(
+      graph(%x.1 : Tensor):
+        %1 : Tensor = aten::relu(%x.1)
+        %2 : Tensor = aten::sigmoid(%1)
+        %3 : Tensor = aten::relu(%2)
+        return (%3))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+
+  trtorch::core::conversion::GraphParams params;
+  trtorch::core::partitioning::PartitionInfo partition_info;
+  partition_info.enabled = true;
+  partition_info.forced_fallback_operators = {"aten::sigmoid"};
+  auto segmented_blocks = trtorch::core::partitioning::SegmentGraph(g->block(), params, partition_info);
+
+  using trtorch::core::partitioning::SegmentedBlock;
+  ASSERT_TRUE(checkSegmentTargets(
+      segmented_blocks, {SegmentedBlock::kTensorRT, SegmentedBlock::kTorch, SegmentedBlock::kTensorRT}));
+}
+
+TEST(Partitioning, SegmentRecomputesNonTensorInputs) {
+  const auto graph = R"IR(
+      graph(%x.1 : Tensor):
+        %c0 : int = prim::Constant[value=0]()
+        %1 : Tensor = aten::relu(%x.1)
+        %2 : Tensor = aten::sigmoid(%1)
+        %3 : int = aten::size(%2, %c0)
+        %4 : Tensor = aten::lgamma(%2)
+        %5 : Tensor = aten::add(%4, %2, %3)
+        return (%5))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+
+  trtorch::core::conversion::GraphParams params;
+  trtorch::core::partitioning::PartitionInfo partition_info;
+  partition_info.enabled = true;
+  auto segmented_blocks = trtorch::core::partitioning::SegmentGraph(g->block(), params, partition_info);
+
+  using trtorch::core::partitioning::SegmentedBlock;
+  ASSERT_TRUE(checkSegmentTargets(
+      segmented_blocks, {SegmentedBlock::kTensorRT, SegmentedBlock::kTorch, SegmentedBlock::kTensorRT}));
+  // The size is recomputed in the last engine instead of crossing the boundary
+  ASSERT_TRUE(segmentContains(segmented_blocks[2], "aten::size"));
+  ASSERT_EQ(segmented_blocks[0].outputs().size(), 1);
+  for (auto in : segmented_blocks[2].inputs()) {
+    ASSERT_TRUE(in->type()->isSubtypeOf(c10::TensorType::get()));
+  }
+}
+
+TEST(Partitioning, SegmentFallsBackNonTensorOutputs) {
+  const auto graph = R"IR(
+      graph(%x.1 : Tensor):
+        %1 : Tensor = aten::relu(%x.1)
+        %2 : int[] = aten::size(%1)
+        return (%2))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+
+  trtorch::core::conversion::GraphParams params;
+  trtorch::core::partitioning::PartitionInfo partition_info;
+  partition_info.enabled = true;
+  auto segmented_blocks = trtorch::core::partitioning::SegmentGraph(g->block(), params, partition_info);
+
+  using trtorch::core::partitioning::SegmentedBlock;
+  ASSERT_TRUE(checkSegmentTargets(segmented_blocks, {SegmentedBlock::kTensorRT, SegmentedBlock::kTorch}));
+  ASSERT_TRUE(segmentContains(segmented_blocks[1], "aten::size"));
+}
+
+TEST(Partitioning, ShapeAnalysisUsesIntegerInputsForIndices) {
+  const auto graph = R"IR(
+      graph(%ids.1 : Tensor, %w.1 : Tensor):
+        %false : bool = prim::Constant[value=0]()
+        %pad : int = prim::Constant[value=-1]()
+        %1 : Tensor = aten::embedding(%w.1, %ids.1, %pad, %false, %false)
+        %2 : Tensor = aten::relu(%1)
+        return (%2))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+
+  trtorch::core::conversion::GraphParams params;
+  params[g->inputs()[1]] = at::randn({10, 8}, {at::kCUDA});
+  trtorch::core::partitioning::PartitionInfo partition_info;
+  partition_info.enabled = true;
+  partition_info.forced_fallback_operators = {"aten::embedding"};
+  // Token ids are not typed in the graph, a float tensor would make the
+  // embedding fail while running the segments
+  std::vector<trtorch::core::conversion::InputRange> input_ranges = {trtorch::core::conversion::InputRange({2, 4})};
+  auto segmented_blocks = trtorch::core::partitioning::Partition(g->block(), params, input_ranges, partition_info);
+
+  using trtorch::core::partitioning::SegmentedBlock;
+  ASSERT_TRUE(checkSegmentTargets(segmented_blocks, {SegmentedBlock::kTorch, SegmentedBlock::kTensorRT}));
+  ASSERT_EQ(segmented_blocks[1].in_shapes().size(), 1);
+  ASSERT_EQ(trtorch::core::util::toVec(segmented_blocks[1].in_shapes()[0].opt), std::vector<int64_t>({2, 4, 8}));
+}
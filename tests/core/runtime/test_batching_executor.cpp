@@ -0,0 +1,184 @@
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "core/runtime/BatchingExecutor.h"
+#include "gtest/gtest.h"
+
+namespace {
+using trtorch::core::runtime::BatchingExecutor;
+using trtorch::core::runtime::BatchingSettings;
+
+// Stands in for an engine: doubles every input and remembers the batch sizes
+// it was run with
+struct FakeEngine {
+  std::mutex mutex;
+  std::vector<int64_t> batch_sizes;
+
+  BatchingExecutor::RunFn fn() {
+    return [this](std::vector<at::Tensor> batch) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch_sizes.push_back(batch[0].size(0));
+      }
+      std::vector<at::Tensor> outputs;
+      for (auto& in : batch) {
+        outputs.push_back(in * 2);
+      }
+      return outputs;
+    };
+  }
+};
+
+BatchingSettings makeSettings(int64_t max_batch_size, int64_t max_delay_ms) {
+  BatchingSettings settings;
+  settings.max_batch_size = max_batch_size;
+  settings.max_delay = std::chrono::milliseconds(max_delay_ms);
+  return settings;
+}
+
+// Generous enough to never be hit by a healthy executor, tests waiting this
+// long have hung
+const auto kTimeout = std::chrono::seconds(30);
+} // namespace
+
+TEST(Runtime, ConcatAndScatterBatchRoundTrip) {
+  std::vector<std::vector<at::Tensor>> requests = {{at::randn({1, 3}), at::randn({1, 5})},
+                                                   {at::randn({2, 3}), at::randn({2, 5})},
+                                                   {at::randn({1, 3}), at::randn({1, 5})}};
+  auto batch = trtorch::core::runtime::ConcatBatch(requests);
+  ASSERT_EQ(batch.size(), 2);
+  ASSERT_EQ(batch[0].sizes(), at::IntArrayRef({4, 3}));
+  ASSERT_EQ(batch[1].sizes(), at::IntArrayRef({4, 5}));
+
+  auto scattered = trtorch::core::runtime::ScatterBatch(batch, {1, 2, 1});
+  ASSERT_EQ(scattered.size(), 3);
+  for (size_t r = 0; r < requests.size(); r++) {
+    ASSERT_EQ(scattered[r].size(), 2);
+    ASSERT_TRUE(at::equal(scattered[r][0], requests[r][0]));
+    ASSERT_TRUE(at::equal(scattered[r][1], requests[r][1]));
+  }
+
+  ASSERT_ANY_THROW(trtorch::core::runtime::ScatterBatch({at::randn({3, 3})}, {1, 2, 1}));
+}
+
+TEST(Runtime, BatchingExecutorRunsFullBatchesImmediately) {
+  FakeEngine engine;
+  // The deadline is never reached, the batch runs because it is full
+  BatchingExecutor executor(engine.fn(), makeSettings(4, 60 * 1000));
+
+  std::vector<at::Tensor> inputs;
+  std::vector<std::future<std::vector<at::Tensor>>> futures;
+  for (int i = 0; i < 4; i++) {
+    inputs.push_back(at::randn({1, 8}));
+    futures.push_back(executor.Submit({inputs.back()}));
+  }
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(futures[i].wait_for(kTimeout), std::future_status::ready);
+    auto out = futures[i].get();
+    ASSERT_EQ(out.size(), 1);
+    ASSERT_TRUE(at::allclose(out[0], inputs[i] * 2));
+  }
+  ASSERT_EQ(engine.batch_sizes, std::vector<int64_t>({4}));
+  ASSERT_EQ(executor.num_batches(), 1);
+  ASSERT_EQ(executor.num_requests(), 4);
+}
+
+TEST(Runtime, BatchingExecutorRunsPartialBatchesAtTheDeadline) {
+  FakeEngine engine;
+  BatchingExecutor executor(engine.fn(), makeSettings(64, 50));
+
+  auto start = std::chrono::steady_clock::now();
+  auto a = executor.Submit({at::ones({1, 8})});
+  auto b = executor.Submit({at::ones({2, 8})});
+  ASSERT_EQ(a.wait_for(kTimeout), std::future_status::ready);
+  ASSERT_EQ(b.wait_for(kTimeout), std::future_status::ready);
+  ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+  ASSERT_EQ(a.get()[0].sizes(), at::IntArrayRef({1, 8}));
+  ASSERT_EQ(b.get()[0].sizes(), at::IntArrayRef({2, 8}));
+  ASSERT_EQ(engine.batch_sizes, std::vector<int64_t>({3}));
+}
+
+TEST(Runtime, BatchingExecutorOnlyBatchesMatchingShapes) {
+  FakeEngine engine;
+  BatchingExecutor executor(engine.fn(), makeSettings(4, 60 * 1000));
+
+  auto a = executor.Submit({at::ones({1, 8})});
+  auto b = executor.Submit({at::ones({1, 16})});
+  auto c = executor.Submit({at::ones({3, 8})});
+  auto d = executor.Submit({at::ones({3, 16})});
+  for (auto f : {&a, &b, &c, &d}) {
+    ASSERT_EQ(f->wait_for(kTimeout), std::future_status::ready);
+  }
+  ASSERT_EQ(c.get()[0].sizes(), at::IntArrayRef({3, 8}));
+  ASSERT_EQ(d.get()[0].sizes(), at::IntArrayRef({3, 16}));
+  ASSERT_EQ(engine.batch_sizes, std::vector<int64_t>({4, 4}));
+}
+
+TEST(Runtime, BatchingExecutorRunsOversizedRequestsAlone) {
+  FakeEngine engine;
+  BatchingExecutor executor(engine.fn(), makeSettings(4, 60 * 1000));
+
+  auto big = executor.Submit({at::ones({6, 8})});
+  ASSERT_EQ(big.wait_for(kTimeout), std::future_status::ready);
+  ASSERT_EQ(big.get()[0].sizes(), at::IntArrayRef({6, 8}));
+  ASSERT_EQ(engine.batch_sizes, std::vector<int64_t>({6}));
+
+  // Inputs disagreeing on dim 0 cannot be split back up after a batched run
+  auto mismatched = executor.Submit({at::ones({1, 8}), at::ones({2, 8})});
+  ASSERT_EQ(mismatched.wait_for(kTimeout), std::future_status::ready);
+  ASSERT_EQ(mismatched.get().size(), 2);
+}
+
+TEST(Runtime, BatchingExecutorPropagatesErrorsToEveryCaller) {
+  BatchingExecutor executor(
+      [](std::vector<at::Tensor>) -> std::vector<at::Tensor> { throw std::runtime_error("engine failed"); },
+      makeSettings(2, 60 * 1000));
+  auto a = executor.Submit({at::ones({1, 8})});
+  auto b = executor.Submit({at::ones({1, 8})});
+  ASSERT_THROW(a.get(), std::runtime_error);
+  ASSERT_THROW(b.get(), std::runtime_error);
+}
+
+TEST(Runtime, BatchingExecutorBatchesConcurrentCallers) {
+  FakeEngine engine;
+  std::vector<std::thread> callers;
+  std::atomic<int> failures(0);
+  {
+    BatchingExecutor executor(engine.fn(), makeSettings(8, 5));
+    for (int t = 0; t < 8; t++) {
+      callers.emplace_back([&executor, &failures, t]() {
+        for (int i = 0; i < 50; i++) {
+          auto in = at::full({1, 4}, static_cast<double>(t * 100 + i));
+          auto out = executor.Submit({in}).get();
+          if (!at::equal(out[0], in * 2)) {
+            failures++;
+          }
+        }
+      });
+    }
+    for (auto& c : callers) {
+      c.join();
+    }
+    ASSERT_EQ(executor.num_requests(), 400);
+  }
+  ASSERT_EQ(failures, 0);
+  int64_t total = 0;
+  for (auto b : engine.batch_sizes) {
+    ASSERT_LE(b, 8);
+    total += b;
+  }
+  ASSERT_EQ(total, 400);
+}
+
+TEST(Runtime, BatchingExecutorDrainsQueueOnShutdown) {
+  FakeEngine engine;
+  std::future<std::vector<at::Tensor>> pending;
+  {
+    BatchingExecutor executor(engine.fn(), makeSettings(4, 60 * 1000));
+    pending = executor.Submit({at::ones({1, 8})});
+  }
+  ASSERT_EQ(pending.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  ASSERT_EQ(pending.get()[0].sizes(), at::IntArrayRef({1, 8}));
+}
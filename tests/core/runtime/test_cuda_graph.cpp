@@ -0,0 +1,50 @@
+#include <string>
+#include "core/conversion/conversion.h"
+#include "core/runtime/runtime.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+c10::intrusive_ptr<trtorch::core::runtime::TRTEngine> buildReluEngine(std::vector<int64_t> shape) {
+  const auto graph = R"IR(
+    graph(%0 : Tensor):
+      %1 : Tensor = aten::relu(%0)
+      return (%1))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::conversion::GraphParams params;
+  auto info = trtorch::core::conversion::ConversionInfo({trtorch::core::conversion::InputRange(shape)});
+  info.engine_settings.workspace_size = 1 << 20;
+  auto eng = trtorch::core::conversion::ConvertBlockToEngine(g->block(), info, params);
+  return c10::make_intrusive<trtorch::core::runtime::TRTEngine>("test_engine", eng);
+}
+} // namespace
+
+TEST(Runtime, CudaGraphReplaysMatchEnqueue) {
+  auto engine = buildReluEngine({4, 16});
+  engine->set_cuda_graph_enabled(true);
+
+  for (int i = 0; i < 5; i++) {
+    auto in = at::randn({4, 16}, {at::kCUDA});
+    auto out = trtorch::core::runtime::execute_engine({in}, engine);
+    ASSERT_TRUE(trtorch::tests::util::almostEqual(out[0], at::relu(in), 2e-6));
+  }
+
+  ASSERT_EQ(engine->get_cuda_graph_misses(), 1);
+  ASSERT_EQ(engine->get_cuda_graph_hits(), 4);
+}
+
+TEST(Runtime, CudaGraphSettingSurvivesSerialization) {
+  auto engine = buildReluEngine({2, 2});
+  engine->set_cuda_graph_enabled(true);
+
+  auto serialized_info = engine->serialize();
+  auto reloaded = c10::make_intrusive<trtorch::core::runtime::TRTEngine>(serialized_info);
+  ASSERT_TRUE(reloaded->cuda_graph_enabled);
+  ASSERT_EQ(reloaded->name, engine->name);
+
+  serialized_info[trtorch::core::runtime::ABI_TARGET_IDX] = "0";
+  ASSERT_ANY_THROW(c10::make_intrusive<trtorch::core::runtime::TRTEngine>(serialized_info));
+}
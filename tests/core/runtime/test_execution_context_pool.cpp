@@ -0,0 +1,179 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "core/runtime/ExecutionContextPool.h"
+#include "gtest/gtest.h"
+
+namespace {
+struct FakeContext {
+  size_t id;
+  std::atomic<int> users{0};
+};
+
+using FakePool = trtorch::core::runtime::ExecutionContextPool<FakeContext>;
+
+struct PoolFixture {
+  PoolFixture(size_t capacity)
+      : pool(
+            capacity,
+            [this](size_t slot) {
+              created++;
+              auto ctx = new FakeContext();
+              ctx->id = slot;
+              return ctx;
+            },
+            [this](FakeContext* ctx) {
+              destroyed++;
+              delete ctx;
+            }) {}
+
+  std::atomic<int> created{0};
+  std::atomic<int> destroyed{0};
+  FakePool pool;
+};
+} // namespace
+
+TEST(Runtime, ExecutionContextPoolGrowsLazily) {
+  PoolFixture f(4);
+  ASSERT_EQ(f.pool.size(), 0);
+  {
+    auto a = f.pool.Checkout(0);
+    ASSERT_EQ(f.created, 1);
+    ASSERT_EQ(a.last_stream(), FakePool::kNoStream);
+  }
+  // The only context is free again so no new one is needed
+  {
+    auto a = f.pool.Checkout(0);
+    auto b = f.pool.Checkout(0);
+    ASSERT_NE(a->id, b->id);
+  }
+  ASSERT_EQ(f.created, 2);
+  ASSERT_EQ(f.pool.size(), 2);
+}
+
+TEST(Runtime, ExecutionContextPoolPrefersStreamAffinity) {
+  PoolFixture f(4);
+  size_t stream_1_ctx;
+  size_t stream_2_ctx;
+  {
+    auto a = f.pool.Checkout(1);
+    auto b = f.pool.Checkout(2);
+    stream_1_ctx = a->id;
+    stream_2_ctx = b->id;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    auto b = f.pool.Checkout(2);
+    ASSERT_EQ(b->id, stream_2_ctx);
+    ASSERT_EQ(b.last_stream(), 2);
+    auto a = f.pool.Checkout(1);
+    ASSERT_EQ(a->id, stream_1_ctx);
+    ASSERT_EQ(a.last_stream(), 1);
+  }
+
+  // A new stream takes over a free context and reports where it last ran
+  auto c = f.pool.Checkout(3);
+  ASSERT_TRUE(c.last_stream() == 1 || c.last_stream() == 2);
+  ASSERT_EQ(f.created, 2);
+}
+
+TEST(Runtime, ExecutionContextPoolRespectsCapacityUnderContention) {
+  const size_t capacity = 3;
+  const int num_threads = 8;
+  const int iters = 2000;
+  PoolFixture f(capacity);
+  std::atomic<int> in_use{0};
+  std::atomic<int> max_in_use{0};
+  std::atomic<bool> shared_context{false};
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < num_threads; t++) {
+    workers.emplace_back([&, t]() {
+      for (int i = 0; i < iters; i++) {
+        auto lease = f.pool.Checkout(t);
+        if (lease->users.fetch_add(1) != 0) {
+          shared_context = true;
+        }
+        auto now = ++in_use;
+        auto prev = max_in_use.load();
+        while (now > prev && !max_in_use.compare_exchange_weak(prev, now)) {
+        }
+        std::this_thread::yield();
+        --in_use;
+        lease->users.fetch_sub(1);
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  ASSERT_FALSE(shared_context);
+  ASSERT_LE(max_in_use.load(), static_cast<int>(capacity));
+  ASSERT_LE(f.pool.size(), capacity);
+  ASSERT_LE(f.created.load(), static_cast<int>(capacity));
+}
+
+TEST(Runtime, ExecutionContextPoolWakesWaiterOnReturn) {
+  PoolFixture f(1);
+  std::atomic<bool> acquired{false};
+  auto held = std::unique_ptr<FakePool::Lease>(new FakePool::Lease(f.pool.Checkout(0)));
+
+  std::thread waiter([&]() {
+    auto lease = f.pool.Checkout(1);
+    acquired = true;
+  });
+  // Long enough for the waiter to give up spinning and go to sleep
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(acquired);
+
+  held.reset();
+  waiter.join();
+  ASSERT_TRUE(acquired);
+  ASSERT_EQ(f.created, 1);
+}
+
+TEST(Runtime, ExecutionContextPoolDestroysContexts) {
+  int destroyed = 0;
+  {
+    FakePool pool(2, [](size_t slot) { return new FakeContext(); }, [&destroyed](FakeContext* ctx) {
+      destroyed++;
+      delete ctx;
+    });
+    {
+      auto a = pool.Checkout(0);
+      auto b = pool.Checkout(0);
+    }
+    ASSERT_EQ(destroyed, 0);
+  }
+  ASSERT_EQ(destroyed, 2);
+}
+
+TEST(Runtime, ExecutionContextPoolRecoversFromFailedCreation) {
+  int attempts = 0;
+  FakePool pool(
+      1,
+      [&attempts](size_t slot) -> FakeContext* {
+        if (attempts++ == 0) {
+          throw std::runtime_error("out of memory");
+        }
+        auto ctx = new FakeContext();
+        ctx->id = slot;
+        return ctx;
+      },
+      [](FakeContext* ctx) { delete ctx; });
+
+  ASSERT_ANY_THROW(pool.Checkout(0));
+  // The failed slot is free again, the next caller creates its context
+  // instead of waiting for a context that will never be returned
+  {
+    auto a = pool.Checkout(0);
+    ASSERT_EQ(a->id, 0);
+    ASSERT_EQ(a.last_stream(), FakePool::kNoStream);
+  }
+  ASSERT_EQ(attempts, 2);
+  ASSERT_EQ(pool.size(), 1);
+}
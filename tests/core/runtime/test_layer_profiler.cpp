@@ -0,0 +1,88 @@
+#include <string>
+#include "core/conversion/conversion.h"
+#include "core/runtime/runtime.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+c10::intrusive_ptr<trtorch::core::runtime::TRTEngine> buildReluEngine() {
+  const auto graph = R"IR(
+    graph(%0 : Tensor):
+      %1 : Tensor = aten::relu(%0)
+      return (%1))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::conversion::GraphParams params;
+  auto info = trtorch::core::conversion::ConversionInfo({trtorch::core::conversion::InputRange({4, 16})});
+  info.engine_settings.workspace_size = 1 << 20;
+  trtorch::core::util::LayerProvenance provenance;
+  auto eng = trtorch::core::conversion::ConvertBlockToEngine(g->block(), info, params, &provenance);
+  return c10::make_intrusive<trtorch::core::runtime::TRTEngine>("test_engine", eng, std::move(provenance));
+}
+} // namespace
+
+TEST(Runtime, LayerProfilerAccumulatesReportedTimes) {
+  trtorch::core::runtime::LayerProfiler profiler;
+  profiler.reportLayerTime("conv", 2.0f);
+  profiler.reportLayerTime("relu", 0.5f);
+  profiler.RecordRun();
+  profiler.reportLayerTime("conv", 4.0f);
+  profiler.reportLayerTime("relu", 0.5f);
+  profiler.RecordRun();
+
+  auto timings = profiler.Timings();
+  ASSERT_EQ(profiler.num_runs(), 2);
+  ASSERT_EQ(timings.size(), 2);
+  ASSERT_EQ(timings[0].layer, "conv");
+  ASSERT_EQ(timings[0].num_calls, 2);
+  ASSERT_DOUBLE_EQ(timings[0].total_ms, 6.0);
+  ASSERT_DOUBLE_EQ(timings[0].min_ms, 2.0);
+  ASSERT_DOUBLE_EQ(timings[0].max_ms, 4.0);
+
+  trtorch::core::util::LayerProvenance provenance;
+  trtorch::core::util::NodeProvenance node;
+  node.kind = "aten::conv2d";
+  node.scope = "__module.conv";
+  provenance.Add("conv", node);
+  auto json = profiler.ToJSON(&provenance);
+  ASSERT_EQ(json.rfind("{\"runs\": 2, ", 0), 0);
+  ASSERT_NE(json.find("\"nodes\": [{\"layer\": \"conv\", \"kind\": \"aten::conv2d\", \"scope\": \"__module.conv\""),
+            std::string::npos);
+  auto table = profiler.Table(&provenance);
+  ASSERT_NE(table.find("aten::conv2d in __module.conv"), std::string::npos);
+  // Slowest layer first
+  ASSERT_LT(table.find("conv "), table.find("relu "));
+
+  profiler.Clear();
+  ASSERT_TRUE(profiler.Timings().empty());
+  ASSERT_EQ(profiler.num_runs(), 0);
+}
+
+TEST(Runtime, EngineProfilesLayersWhenEnabled) {
+  auto engine = buildReluEngine();
+  auto in = at::randn({4, 16}, {at::kCUDA});
+  trtorch::core::runtime::execute_engine({in}, engine);
+  ASSERT_EQ(engine->layer_profiler->num_runs(), 0);
+
+  engine->set_layer_profiling_enabled(true);
+  for (int i = 0; i < 3; i++) {
+    auto out = trtorch::core::runtime::execute_engine({in}, engine);
+    ASSERT_TRUE(trtorch::tests::util::almostEqual(out[0], at::relu(in), 2e-6));
+  }
+  engine->set_layer_profiling_enabled(false);
+  trtorch::core::runtime::execute_engine({in}, engine);
+
+  ASSERT_EQ(engine->layer_profiler->num_runs(), 3);
+  auto timings = engine->layer_profiler->Timings();
+  ASSERT_FALSE(timings.empty());
+  for (auto& t : timings) {
+    ASSERT_EQ(t.num_calls, 3);
+  }
+  ASSERT_NE(engine->get_layer_profile().find("aten::relu"), std::string::npos);
+  ASSERT_EQ(engine->get_layer_profile_json().rfind("{\"runs\": 3, ", 0), 0);
+
+  engine->reset_layer_profile();
+  ASSERT_EQ(engine->layer_profiler->num_runs(), 0);
+}
@@ -0,0 +1,83 @@
+#include <string>
+#include "core/conversion/conversion.h"
+#include "core/runtime/runtime.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+c10::intrusive_ptr<trtorch::core::runtime::TRTEngine> buildReluAddEngine() {
+  const auto graph = R"IR(
+    graph(%0 : Tensor):
+      %1 : int = prim::Constant[value=1]()
+      %2 : Tensor = aten::relu(%0)
+      %3 : Tensor = aten::relu(%2)
+      %4 : Tensor = aten::add(%2, %3, %1)
+      return (%4))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::conversion::GraphParams params;
+  auto info = trtorch::core::conversion::ConversionInfo({trtorch::core::conversion::InputRange({4, 16})});
+  info.engine_settings.workspace_size = 1 << 20;
+  trtorch::core::util::LayerProvenance provenance;
+  auto eng = trtorch::core::conversion::ConvertBlockToEngine(g->block(), info, params, &provenance);
+  return c10::make_intrusive<trtorch::core::runtime::TRTEngine>("test_engine", eng, std::move(provenance));
+}
+} // namespace
+
+TEST(Runtime, LayersAreNamedAfterTheirNodes) {
+  auto engine = buildReluAddEngine();
+  auto& provenance = engine->layer_provenance;
+  // Parsed graphs have no scopes or source locations, the nodes sharing a
+  // kind are numbered in conversion order
+  auto relu = provenance.Find("aten::relu");
+  ASSERT_TRUE(relu != nullptr);
+  ASSERT_EQ(relu->kind, "aten::relu");
+  ASSERT_EQ(relu->node.find("%2 : Tensor = aten::relu(%0)"), 0);
+  auto second_relu = provenance.Find("aten::relu#1");
+  ASSERT_TRUE(second_relu != nullptr);
+  ASSERT_EQ(second_relu->node.find("%3 : Tensor = aten::relu(%2)"), 0);
+  ASSERT_TRUE(provenance.Find("aten::add") != nullptr);
+  ASSERT_TRUE(provenance.Find("prim::Constant") == nullptr);
+}
+
+TEST(Runtime, LayerProvenanceSurvivesSerialization) {
+  auto engine = buildReluAddEngine();
+  auto deserialized = c10::make_intrusive<trtorch::core::runtime::TRTEngine>(engine->serialize());
+  ASSERT_EQ(deserialized->get_layer_provenance(), engine->get_layer_provenance());
+
+  // TensorRT names fused layers after the layers they were built from
+  auto nodes = deserialized->lookup_layer("aten::relu + aten::relu#1");
+  ASSERT_EQ(nodes.size(), 2);
+  ASSERT_EQ(nodes.get(0).at("layer"), "aten::relu");
+  ASSERT_EQ(nodes.get(1).at("layer"), "aten::relu#1");
+  ASSERT_EQ(nodes.get(1).at("kind"), "aten::relu");
+  ASSERT_EQ(deserialized->lookup_layer("aten::relu#1 input reformatter 0").size(), 1);
+  ASSERT_EQ(deserialized->lookup_layer("unknown layer").size(), 0);
+
+  auto in = at::randn({4, 16}, {at::kCUDA});
+  auto out = trtorch::core::runtime::execute_engine({in}, deserialized);
+  ASSERT_TRUE(trtorch::tests::util::almostEqual(out[0], at::relu(in) * 2, 2e-6));
+}
+
+TEST(Runtime, LayerProvenanceLookupMatchesWholeNames) {
+  trtorch::core::util::LayerProvenance provenance;
+  trtorch::core::util::NodeProvenance node;
+  node.kind = "aten::conv2d";
+  node.scope = "__module.features/__module.features.0";
+  node.source = "model.py:12:8";
+  node.node = "%x : Tensor = aten::conv2d(%in)\t# with a tab";
+  provenance.Add("__module.features/__module.features.0/aten::conv2d@model.py:12:8", node);
+  provenance.Add("__module.features/__module.features.0/aten::conv2d@model.py:12:8#1", node);
+
+  auto found = provenance.Lookup("PWN(__module.features/__module.features.0/aten::conv2d@model.py:12:8#1)");
+  ASSERT_EQ(found.size(), 1);
+  ASSERT_EQ(found[0].first, "__module.features/__module.features.0/aten::conv2d@model.py:12:8#1");
+  ASSERT_EQ(provenance.Lookup("__module.features/__module.features.0/aten::conv2d@model.py:12:8#10").size(), 0);
+
+  auto round_trip = trtorch::core::util::LayerProvenance::Deserialize(provenance.Serialize());
+  ASSERT_EQ(round_trip.size(), 2);
+  ASSERT_EQ(round_trip.Find("__module.features/__module.features.0/aten::conv2d@model.py:12:8")->node, node.node);
+  ASSERT_ANY_THROW(trtorch::core::util::LayerProvenance::Deserialize("not a provenance table"));
+}
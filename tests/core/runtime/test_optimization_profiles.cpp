@@ -0,0 +1,122 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include "core/conversion/conversion.h"
+#include "core/runtime/runtime.h"
+#include "gtest/gtest.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
+
+namespace {
+c10::intrusive_ptr<trtorch::core::runtime::TRTEngine> buildBimodalReluEngine() {
+  const auto graph = R"IR(
+    graph(%0 : Tensor):
+      %1 : Tensor = aten::relu(%0)
+      return (%1))IR";
+
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(graph, &*g);
+  trtorch::core::conversion::GraphParams params;
+  // Interactive traffic around batch 1 and offline traffic around batch 64
+  auto info =
+      trtorch::core::conversion::ConversionInfo({trtorch::core::conversion::InputRange({1, 16}, {1, 16}, {8, 16})});
+  info.additional_input_ranges = {{trtorch::core::conversion::InputRange({1, 16}, {64, 16}, {64, 16})}};
+  info.engine_settings.workspace_size = 1 << 20;
+  auto eng = trtorch::core::conversion::ConvertBlockToEngine(g->block(), info, params);
+  return c10::make_intrusive<trtorch::core::runtime::TRTEngine>("test_engine", eng);
+}
+} // namespace
+
+TEST(Runtime, EngineSelectsProfileFromInputShapes) {
+  auto engine = buildBimodalReluEngine();
+  ASSERT_EQ(engine->get_num_optimization_profiles(), 2);
+  ASSERT_EQ(engine->num_io.first, 1);
+  ASSERT_EQ(engine->num_io.second, 1);
+
+  ASSERT_EQ(engine->select_profile({at::randn({1, 16}, {at::kCUDA})}), 0);
+  ASSERT_EQ(engine->select_profile({at::randn({16, 16}, {at::kCUDA})}), 1);
+  ASSERT_EQ(engine->select_profile({at::randn({64, 16}, {at::kCUDA})}), 1);
+  ASSERT_ANY_THROW(engine->select_profile({at::randn({65, 16}, {at::kCUDA})}));
+}
+
+TEST(Runtime, EngineRunsEveryProfile) {
+  auto engine = buildBimodalReluEngine();
+  for (auto batch : {1, 64, 4, 32}) {
+    auto in = at::randn({batch, 16}, {at::kCUDA});
+    auto out = trtorch::core::runtime::execute_engine({in}, engine);
+    ASSERT_TRUE(trtorch::tests::util::almostEqual(out[0], at::relu(in), 2e-6));
+  }
+}
+
+TEST(Runtime, AdditionalInputRangesMustCoverEveryInput) {
+  auto info = trtorch::core::conversion::ConversionInfo(
+      {trtorch::core::conversion::InputRange({1, 16}), trtorch::core::conversion::InputRange({1, 16})});
+  info.additional_input_ranges = {{trtorch::core::conversion::InputRange({2, 16})}};
+  ASSERT_ANY_THROW(trtorch::core::conversion::GetOptimizationProfiles(info));
+
+  info.additional_input_ranges = {
+      {trtorch::core::conversion::InputRange({2, 16})},
+      {trtorch::core::conversion::InputRange({2, 16}), trtorch::core::conversion::InputRange({4, 16})}};
+  ASSERT_ANY_THROW(trtorch::core::conversion::GetOptimizationProfiles(info));
+
+  info.additional_input_ranges = {
+      {trtorch::core::conversion::InputRange({2, 16})}, {trtorch::core::conversion::InputRange({4, 16})}};
+  auto profiles = trtorch::core::conversion::GetOptimizationProfiles(info);
+  ASSERT_EQ(profiles.size(), 2);
+  ASSERT_EQ(profiles[1][1].opt.d[0], 4);
+}
+
+TEST(Runtime, EngineRecordsInputShapesWhenEnabled) {
+  auto engine = buildBimodalReluEngine();
+  trtorch::core::runtime::execute_engine({at::randn({1, 16}, {at::kCUDA})}, engine);
+  ASSERT_EQ(engine->shape_histogram->num_recorded(), 0);
+
+  engine->set_shape_recording_enabled(true);
+  for (auto batch : {1, 1, 64}) {
+    trtorch::core::runtime::execute_engine({at::randn({batch, 16}, {at::kCUDA})}, engine);
+  }
+
+  trtorch::core::runtime::ShapeHistogram hist;
+  hist.Deserialize(engine->get_shape_histogram());
+  auto entries = hist.Entries();
+  ASSERT_EQ(entries.size(), 2);
+  ASSERT_EQ(entries[0].first, trtorch::core::runtime::ShapeSignature({{1, 16}}));
+  ASSERT_EQ(entries[0].second, 2);
+  ASSERT_EQ(entries[1].second, 1);
+
+  engine->reset_shape_histogram();
+  ASSERT_EQ(engine->shape_histogram->num_recorded(), 0);
+}
+
+TEST(Runtime, EngineBatchesConcurrentCalls) {
+  auto engine = buildBimodalReluEngine();
+  ASSERT_EQ(engine->get_max_batch_size(), 64);
+  ASSERT_ANY_THROW(engine->set_dynamic_batching(true, 128, 1000));
+  engine->set_dynamic_batching(true, 0, 1000);
+  auto batcher = std::atomic_load(&engine->batching_executor);
+  ASSERT_TRUE(batcher);
+  ASSERT_EQ(batcher->settings().max_batch_size, 64);
+
+  std::atomic<int> failures(0);
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 8; t++) {
+    callers.emplace_back([&engine, &failures]() {
+      for (int i = 0; i < 20; i++) {
+        auto in = at::randn({1, 16}, {at::kCUDA});
+        auto out = trtorch::core::runtime::execute_engine({in}, engine);
+        if (!trtorch::tests::util::almostEqual(out[0], at::relu(in), 2e-6)) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& c : callers) {
+    c.join();
+  }
+  ASSERT_EQ(failures, 0);
+  ASSERT_EQ(batcher->num_requests(), 160);
+  ASSERT_LE(batcher->num_batches(), 160);
+
+  engine->set_dynamic_batching(false, 0, 0);
+  ASSERT_FALSE(std::atomic_load(&engine->batching_executor));
+}
@@ -0,0 +1,70 @@
+#include "core/runtime/ProfileSelector.h"
+#include "gtest/gtest.h"
+
+namespace {
+using trtorch::core::runtime::ProfileSelector;
+using trtorch::core::runtime::ProfileShapes;
+
+ProfileShapes makeProfile(std::vector<int64_t> min, std::vector<int64_t> opt, std::vector<int64_t> max) {
+  ProfileShapes p;
+  p.min.push_back(min);
+  p.opt.push_back(opt);
+  p.max.push_back(max);
+  return p;
+}
+
+// Interactive traffic around batch 1 and offline traffic around batch 64
+ProfileSelector makeBimodalSelector() {
+  return ProfileSelector({makeProfile({1, 3, 224, 224}, {1, 3, 224, 224}, {8, 3, 224, 224}),
+                          makeProfile({1, 3, 224, 224}, {64, 3, 224, 224}, {64, 3, 224, 224})});
+}
+} // namespace
+
+TEST(Runtime, ProfileSelectorPicksClosestOptShape) {
+  auto selector = makeBimodalSelector();
+  ASSERT_EQ(selector.Select({{1, 3, 224, 224}}), 0);
+  ASSERT_EQ(selector.Select({{2, 3, 224, 224}}), 0);
+  ASSERT_EQ(selector.Select({{64, 3, 224, 224}}), 1);
+  ASSERT_EQ(selector.Select({{48, 3, 224, 224}}), 1);
+}
+
+TEST(Runtime, ProfileSelectorOnlyPicksProfilesContainingTheShapes) {
+  auto selector = makeBimodalSelector();
+  // Closer to the opt shape of the first profile but above its max
+  ASSERT_EQ(selector.Select({{9, 3, 224, 224}}), 1);
+  ASSERT_EQ(selector.Select({{65, 3, 224, 224}}), ProfileSelector::kNoProfile);
+  ASSERT_EQ(selector.Select({{1, 3, 112, 112}}), ProfileSelector::kNoProfile);
+  ASSERT_EQ(selector.Select({{1, 3, 224}}), ProfileSelector::kNoProfile);
+  ASSERT_EQ(selector.Select({}), ProfileSelector::kNoProfile);
+}
+
+TEST(Runtime, ProfileSelectorBreaksTiesByMaxVolumeThenIndex) {
+  ProfileSelector selector({makeProfile({1, 16}, {4, 16}, {32, 16}),
+                            makeProfile({1, 16}, {4, 16}, {8, 16}),
+                            makeProfile({1, 16}, {4, 16}, {8, 16})});
+  ASSERT_EQ(selector.Select({{4, 16}}), 1);
+  ASSERT_EQ(selector.Select({{16, 16}}), 0);
+}
+
+TEST(Runtime, ProfileSelectorConsidersEveryInput) {
+  auto a = makeProfile({1, 8}, {1, 8}, {64, 8});
+  a.min.push_back({1, 128});
+  a.opt.push_back({1, 128});
+  a.max.push_back({64, 128});
+  auto b = makeProfile({1, 8}, {1, 8}, {64, 8});
+  b.min.push_back({1, 128});
+  b.opt.push_back({64, 128});
+  b.max.push_back({64, 128});
+  ProfileSelector selector({a, b});
+
+  ASSERT_EQ(selector.num_profiles(), 2);
+  ASSERT_EQ(selector.Select({{1, 8}, {1, 128}}), 0);
+  ASSERT_EQ(selector.Select({{1, 8}, {64, 128}}), 1);
+}
+
+TEST(Runtime, ProfileSelectorRejectsMismatchedProfiles) {
+  auto a = makeProfile({1}, {1}, {1});
+  auto b = makeProfile({1}, {1}, {1});
+  b.opt.push_back({1});
+  ASSERT_ANY_THROW(ProfileSelector({a, b}));
+}
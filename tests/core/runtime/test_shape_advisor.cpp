@@ -0,0 +1,154 @@
+#include <thread>
+#include "core/runtime/ShapeAdvisor.h"
+#include "core/runtime/ShapeHistogram.h"
+#include "gtest/gtest.h"
+
+namespace {
+using trtorch::core::runtime::AdviseShapeBuckets;
+using trtorch::core::runtime::ShapeAdvisorSettings;
+using trtorch::core::runtime::ShapeHistogram;
+using trtorch::core::runtime::ShapeSignature;
+
+// Synthetic trace of bimodal traffic, mostly batch 1 interactive requests
+// with a tail of small batches and some large offline batches
+void recordBimodalTrace(ShapeHistogram& hist) {
+  hist.Record({{1, 128}}, 900);
+  hist.Record({{2, 128}}, 50);
+  hist.Record({{4, 128}}, 30);
+  hist.Record({{48, 128}}, 10);
+  hist.Record({{64, 128}}, 100);
+}
+} // namespace
+
+TEST(Runtime, ShapeHistogramCountsSignatures) {
+  ShapeHistogram hist;
+  recordBimodalTrace(hist);
+  hist.Record({{1, 128}});
+
+  auto entries = hist.Entries();
+  ASSERT_EQ(entries.size(), 5);
+  ASSERT_EQ(entries[0].first, ShapeSignature({{1, 128}}));
+  ASSERT_EQ(entries[0].second, 901);
+  ASSERT_EQ(entries[1].first, ShapeSignature({{64, 128}}));
+  ASSERT_EQ(hist.num_recorded(), 1091);
+  ASSERT_EQ(hist.num_overflowed(), 0);
+
+  hist.Clear();
+  ASSERT_EQ(hist.Entries().size(), 0);
+  ASSERT_EQ(hist.num_recorded(), 0);
+}
+
+TEST(Runtime, ShapeHistogramIsBounded) {
+  ShapeHistogram hist;
+  for (int64_t i = 0; i < static_cast<int64_t>(ShapeHistogram::kMaxSignatures) + 10; i++) {
+    hist.Record({{i + 1, 3}});
+  }
+  // Signatures already tracked keep being counted
+  hist.Record({{1, 3}});
+  ASSERT_EQ(hist.Entries().size(), ShapeHistogram::kMaxSignatures);
+  ASSERT_EQ(hist.num_overflowed(), 10);
+  ASSERT_EQ(hist.num_recorded(), ShapeHistogram::kMaxSignatures + 11);
+}
+
+TEST(Runtime, ShapeHistogramRecordsConcurrently) {
+  ShapeHistogram hist;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&hist, t]() {
+      for (int i = 0; i < 1000; i++) {
+        hist.Record({{t % 2 + 1, 16}});
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto entries = hist.Entries();
+  ASSERT_EQ(entries.size(), 2);
+  ASSERT_EQ(entries[0].second, 2000);
+  ASSERT_EQ(entries[1].second, 2000);
+}
+
+TEST(Runtime, ShapeHistogramSerializationRoundTrips) {
+  ShapeHistogram hist;
+  recordBimodalTrace(hist);
+  // Multiple inputs, including a scalar one
+  hist.Record({{8, 3, 224, 224}, {}, {8}}, 7);
+
+  ShapeHistogram reloaded;
+  reloaded.Deserialize(hist.Serialize());
+  ASSERT_EQ(reloaded.Entries(), hist.Entries());
+  ASSERT_EQ(reloaded.num_recorded(), hist.num_recorded());
+
+  ASSERT_ANY_THROW(reloaded.Deserialize("not a histogram\n1 1x128\n"));
+}
+
+TEST(Runtime, ShapeAdvisorSplitsBimodalTraffic) {
+  ShapeHistogram hist;
+  recordBimodalTrace(hist);
+  ShapeAdvisorSettings settings;
+  settings.max_buckets = 2;
+  auto advice = AdviseShapeBuckets(hist.Entries(), settings);
+
+  ASSERT_EQ(advice.num_calls, 1090);
+  ASSERT_EQ(advice.buckets.size(), 2);
+
+  auto& interactive = advice.buckets[0];
+  ASSERT_EQ(interactive.count, 980);
+  ASSERT_EQ(interactive.min, ShapeSignature({{1, 128}}));
+  ASSERT_EQ(interactive.opt, ShapeSignature({{1, 128}}));
+  ASSERT_EQ(interactive.max, ShapeSignature({{4, 128}}));
+  // Every call padded to batch 4
+  ASSERT_NEAR(interactive.padding_waste, 1.0 - (900.0 + 2 * 50 + 4 * 30) / (980 * 4), 1e-9);
+
+  auto& offline = advice.buckets[1];
+  ASSERT_EQ(offline.count, 110);
+  ASSERT_EQ(offline.min, ShapeSignature({{48, 128}}));
+  ASSERT_EQ(offline.opt, ShapeSignature({{64, 128}}));
+  ASSERT_EQ(offline.max, ShapeSignature({{64, 128}}));
+  ASSERT_NEAR(offline.padding_waste, 1.0 - (48.0 * 10 + 64 * 100) / (110 * 64), 1e-9);
+
+  double padded = 980.0 * 4 + 110 * 64;
+  double elements = 900.0 + 2 * 50 + 4 * 30 + 48 * 10 + 64 * 100;
+  ASSERT_NEAR(advice.padding_waste, 1.0 - elements / padded, 1e-9);
+}
+
+TEST(Runtime, ShapeAdvisorMergesWithinWasteBudget) {
+  ShapeHistogram hist;
+  recordBimodalTrace(hist);
+  ShapeAdvisorSettings settings;
+  settings.max_buckets = 5;
+
+  auto exact = AdviseShapeBuckets(hist.Entries(), settings);
+  ASSERT_EQ(exact.buckets.size(), 5);
+  ASSERT_EQ(exact.padding_waste, 0);
+
+  // Padding batch 2 to batch 4 and batch 48 to batch 64 adds 260 padding rows
+  // to the 8000 rows of real data, merging batch 1 in as well would not fit
+  settings.max_padding_waste = 0.05;
+  auto merged = AdviseShapeBuckets(hist.Entries(), settings);
+  ASSERT_EQ(merged.buckets.size(), 3);
+  ASSERT_NEAR(merged.padding_waste, 260.0 / 8260, 1e-9);
+}
+
+TEST(Runtime, ShapeAdvisorKeepsRanksApart) {
+  ShapeAdvisorSettings settings;
+  settings.max_buckets = 1;
+  auto advice = AdviseShapeBuckets({{{{4, 8}}, 10}, {{{4, 8, 2}}, 5}, {{{2, 8}}, 5}}, settings);
+  ASSERT_EQ(advice.buckets.size(), 2);
+  ASSERT_EQ(advice.buckets[0].min, ShapeSignature({{2, 8}}));
+  ASSERT_EQ(advice.buckets[0].max, ShapeSignature({{4, 8}}));
+  ASSERT_EQ(advice.buckets[1].count, 5);
+}
+
+TEST(Runtime, ShapeAdvisorBoundsEveryInput) {
+  ShapeAdvisorSettings settings;
+  settings.max_buckets = 1;
+  auto advice = AdviseShapeBuckets(
+      {{{{1, 3, 224, 224}, {1, 10}}, 10}, {{{8, 3, 160, 224}, {8, 20}}, 2}, {{{4, 3, 320, 224}, {4, 5}}, 1}}, settings);
+  ASSERT_EQ(advice.buckets.size(), 1);
+  ASSERT_EQ(advice.buckets[0].min, ShapeSignature({{1, 3, 160, 224}, {1, 5}}));
+  ASSERT_EQ(advice.buckets[0].opt, ShapeSignature({{1, 3, 224, 224}, {1, 10}}));
+  ASSERT_EQ(advice.buckets[0].max, ShapeSignature({{8, 3, 320, 224}, {8, 20}}));
+  ASSERT_EQ(advice.buckets[0].count, 13);
+}
@@ -1,4 +1,6 @@
 #include "core/util/prelude.h"
+#include "tests/util/util.h"
+#include "torch/csrc/jit/ir/irparser.h"
 #include "torch/script.h"
 
 namespace trtorch {
@@ -26,6 +28,64 @@ bool exactlyEqual(const at::Tensor& a, const at::Tensor& b) {
   return (a - b).abs().max().item<float>() == 0.f;
 }
 
+std::shared_ptr<torch::jit::Graph> BuildFrozenGraph(const std::string& source, std::vector<at::Tensor> params) {
+  auto g = std::make_shared<torch::jit::Graph>();
+  torch::jit::parseIR(source, &*g);
+  TRTORCH_CHECK(
+      g->inputs().size() == params.size() + 1,
+      "Expected a parameter for every graph input but the first, found " << g->inputs().size() << " inputs and "
+                                                                         << params.size() << " parameters");
+  torch::jit::WithInsertPoint guard(*g->nodes().begin());
+  for (size_t i = 0; i < params.size(); i++) {
+    auto in = g->inputs()[1];
+    in->replaceAllUsesWith(g->insertConstant(params[i]));
+    g->eraseInput(1);
+  }
+  return g;
+}
+
+size_t CountNodes(const torch::jit::Block* b, c10::Symbol kind) {
+  size_t count = 0;
+  for (auto n : b->nodes()) {
+    count += n->kind() == kind;
+    for (auto sub_block : n->blocks()) {
+      count += CountNodes(sub_block, kind);
+    }
+  }
+  return count;
+}
+
+size_t CountNodes(const std::shared_ptr<torch::jit::Graph>& g, c10::Symbol kind) {
+  return CountNodes(g->block(), kind);
+}
+
+bool CheckResults(
+    std::shared_ptr<torch::jit::Graph> g,
+    std::shared_ptr<torch::jit::Graph> transformed,
+    std::vector<at::Tensor> inputs,
+    float threshold) {
+  auto params = core::conversion::GraphParams();
+  auto expected = RunGraph(g, params, inputs);
+  auto results = RunGraph(transformed, params, inputs);
+  if (expected.size() != results.size()) {
+    std::cout << "Expected " << expected.size() << " outputs, found " << results.size() << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < expected.size(); i++) {
+    if (expected[i].sizes() != results[i].sizes()) {
+      std::cout << "Expected output " << i << " to have shape " << expected[i].sizes() << ", found "
+                << results[i].sizes() << std::endl;
+      return false;
+    }
+    auto equal = threshold == 0 ? exactlyEqual(expected[i], results[i])
+                                : almostEqual(expected[i], results[i], threshold);
+    if (!equal) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace util
 } // namespace tests
 } // namespace trtorch
@@ -50,6 +50,23 @@ std::vector<torch::jit::IValue> EvaluateGraph(const torch::jit::Block* b, std::v
 std::vector<torch::jit::IValue> EvaluateGraphJIT(
     std::shared_ptr<torch::jit::Graph>& g,
     std::vector<torch::jit::IValue> inputs);
+
+// Parses the graph and replaces every input but the first with a constant
+// holding the matching tensor, which is what freezing does to module weights
+std::shared_ptr<torch::jit::Graph> BuildFrozenGraph(const std::string& source, std::vector<at::Tensor> params);
+
+// Number of nodes of the kind in the block, including those in nested blocks
+size_t CountNodes(const torch::jit::Block* b, c10::Symbol kind);
+size_t CountNodes(const std::shared_ptr<torch::jit::Graph>& g, c10::Symbol kind);
+
+// Runs a graph and the graph a pass produced from it (both without
+// parameters) on the inputs and checks that the outputs have the same sizes
+// and are almost equal within threshold, or exactly equal if it is 0
+bool CheckResults(
+    std::shared_ptr<torch::jit::Graph> g,
+    std::shared_ptr<torch::jit::Graph> transformed,
+    std::vector<at::Tensor> inputs,
+    float threshold = 0);
 } // namespace util
 } // namespace tests
 } // namespace trtorch